@@ -0,0 +1,67 @@
+// Cook-Torrance BRDF and point light falloff shared by the forward
+// (pbr.frag) and deferred (deferred_*.frag) lighting paths.
+
+// =============================================================
+// Fresnel Schlick
+// =============================================================
+vec3 FresnelSchlick(float cosTheta, vec3 F0)
+{
+    return F0 + (1.0 - F0) * pow(1.0 - cosTheta, 5.0);
+}
+
+// =============================================================
+// GGX NDF
+// =============================================================
+float DistributionGGX(vec3 N, vec3 H, float roughness)
+{
+    float a  = roughness * roughness;
+    float a2 = a * a;
+    float NdotH = max(dot(N, H), 0.0);
+    float NdotH2 = NdotH * NdotH;
+
+    float denom = (NdotH2 * (a2 - 1.0) + 1.0);
+    return a2 / (3.141592 * denom * denom);
+}
+
+// =============================================================
+// Geometry (Smith)
+// =============================================================
+float GeometrySchlickGGX(float NdotV, float roughness)
+{
+    float r = roughness + 1.0;
+    float k = (r * r) / 8.0;
+
+    return NdotV / (NdotV * (1.0 - k) + k);
+}
+
+float GeometrySmith(vec3 N, vec3 V, vec3 L, float roughness)
+{
+    return GeometrySchlickGGX(max(dot(N, V), 0.0), roughness) *
+           GeometrySchlickGGX(max(dot(N, L), 0.0), roughness);
+}
+
+// Outgoing radiance towards V for unit radiance arriving from L
+vec3 EvaluateBRDF(vec3 N, vec3 V, vec3 L, vec3 albedo, float roughness, float metalness)
+{
+    vec3 H = normalize(V + L);
+    vec3 F0 = mix(vec3(0.04), albedo, metalness);
+
+    float NdotL = max(dot(N, L), 0.0);
+
+    float NDF = DistributionGGX(N, H, roughness);
+    float G   = GeometrySmith(N, V, L, roughness);
+    vec3  F   = FresnelSchlick(max(dot(H, V), 0.0), F0);
+
+    vec3 spec = NDF * G * F / (4.0 * max(dot(N, V), 0.0) * NdotL + 0.001);
+    vec3 kD = (1.0 - F) * (1.0 - metalness);
+
+    return (kD * albedo / 3.141592 + spec) * NdotL;
+}
+
+// Smooth window so the contribution reaches zero at the light radius
+float PointLightAttenuation(float dist, float radius)
+{
+    float ratio = dist / radius;
+    float window = clamp(1.0 - ratio * ratio * ratio * ratio, 0.0, 1.0);
+    return window * window / (1.0 + 0.09 * dist + 0.032 * dist * dist);
+}
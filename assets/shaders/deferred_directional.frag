@@ -0,0 +1,51 @@
+#version 330 core
+
+// Deferred lighting, full-screen: ambient + directional light.
+// Point lights are added on top by light volumes (deferred_point.frag).
+out vec4 FragColor;
+
+layout(std140) uniform FrameData
+{
+    mat4 u_View;
+    mat4 u_Projection;
+    vec4 u_ViewPos;
+    vec4 u_ClusterParams;
+    ivec4 u_ClusterGrid;
+};
+
+#include "gbuffer_read.glsl"
+#include "brdf.glsl"
+
+struct DirectionalLight {
+    vec3 color;
+    float intensity;
+};
+
+layout(std140) uniform LightData
+{
+    DirectionalLight u_DirectionalLight;
+    int u_HasDirectionalLight;
+};
+
+void main()
+{
+    Surface s = ReadSurface();
+
+    // Background keeps the clear color
+    if (s.Depth >= 1.0)
+        discard;
+
+    // Output depth for the light volume pass (drawn with GL_ALWAYS)
+    gl_FragDepth = s.Depth;
+
+    vec3 V = normalize(u_ViewPos.xyz - s.Position);
+    vec3 color = 0.26 * s.Albedo;
+
+    if (u_HasDirectionalLight == 1)
+    {
+        vec3 L = normalize(vec3(1.0, 1.0, 0.5));
+        color += EvaluateBRDF(s.Normal, V, L, s.Albedo, s.Roughness, s.Metalness) * u_DirectionalLight.color * u_DirectionalLight.intensity;
+    }
+
+    FragColor = vec4(color, 1.0);
+}
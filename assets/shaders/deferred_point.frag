@@ -0,0 +1,38 @@
+#version 330 core
+
+// Deferred lighting, one point light per volume fragment (additive blend)
+flat in int v_LightIndex;
+
+out vec4 FragColor;
+
+layout(std140) uniform FrameData
+{
+    mat4 u_View;
+    mat4 u_Projection;
+    vec4 u_ViewPos;
+    vec4 u_ClusterParams;
+    ivec4 u_ClusterGrid;
+};
+
+#include "gbuffer_read.glsl"
+#include "brdf.glsl"
+
+uniform samplerBuffer u_LightData;   // 2 texels per light: (position, radius), (radiance, 0)
+
+void main()
+{
+    Surface s = ReadSurface();
+
+    vec4 positionRadius = texelFetch(u_LightData, v_LightIndex * 2);
+    vec3 lightRadiance  = texelFetch(u_LightData, v_LightIndex * 2 + 1).rgb;
+
+    vec3 toLight = positionRadius.xyz - s.Position;
+    float dist = length(toLight);
+    if (dist >= positionRadius.w)
+        discard;
+
+    vec3 V = normalize(u_ViewPos.xyz - s.Position);
+    vec3 radiance = lightRadiance * PointLightAttenuation(dist, positionRadius.w);
+
+    FragColor = vec4(EvaluateBRDF(s.Normal, V, toLight / dist, s.Albedo, s.Roughness, s.Metalness) * radiance, 1.0);
+}
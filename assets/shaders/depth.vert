@@ -0,0 +1,25 @@
+#version 330 core
+
+// Depth pre-pass: position only. Must produce bit-identical depth to
+// pbr.vert so the shading pass can test with GL_EQUAL.
+layout(location = 0) in vec3 a_Position;
+
+// Per-instance stream (InstanceBuffer, divisor 1)
+layout(location = 4) in mat4 a_Model;           // locations 4..7
+
+layout(std140) uniform FrameData
+{
+    mat4 u_View;
+    mat4 u_Projection;
+    vec4 u_ViewPos;
+    vec4 u_ClusterParams;
+    ivec4 u_ClusterGrid;
+};
+
+invariant gl_Position;
+
+void main()
+{
+    vec4 worldPos = a_Model * vec4(a_Position, 1.0);
+    gl_Position = u_Projection * u_View * worldPos;
+}
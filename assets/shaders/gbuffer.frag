@@ -0,0 +1,47 @@
+#version 330 core
+
+// Deferred geometry pass (paired with pbr.vert): writes the material
+// inputs of the lighting pass, no lighting here.
+
+#include "material.glsl"
+
+// G-buffer layout ("GBuffer" pass in Renderer::BuildFrameGraph)
+layout(location = 0) out vec4 o_AlbedoMetalness;   // RGBA8:   albedo, metalness
+layout(location = 1) out vec4 o_NormalRoughness;   // RGB10A2: octahedral normal, roughness
+
+layout(std140) uniform FrameData
+{
+    mat4 u_View;
+    mat4 u_Projection;
+    vec4 u_ViewPos;
+    vec4 u_ClusterParams;
+    ivec4 u_ClusterGrid;
+};
+
+// =============================================================
+// Octahedral normal encoding (unit vector -> [0,1]^2)
+// =============================================================
+vec2 OctWrap(vec2 v)
+{
+    return (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+vec2 EncodeOctahedral(vec3 n)
+{
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    n.xy = n.z >= 0.0 ? n.xy : OctWrap(n.xy);
+    return n.xy * 0.5 + 0.5;
+}
+
+void main()
+{
+    vec3 V = normalize(u_ViewPos.xyz - v_WorldPos);
+    vec2 uv = ParallaxMapping(v_UV, normalize(v_TBN * V));
+
+    vec3 albedo = GetAlbedo(uv);
+    float roughness = GetRoughness(uv);
+    float metalness = GetMetalness(uv);
+
+    o_AlbedoMetalness = vec4(albedo, metalness);
+    o_NormalRoughness = vec4(EncodeOctahedral(GetNormal(uv)), roughness, 0.0);
+}
@@ -0,0 +1,53 @@
+// G-buffer decoding for the deferred lighting passes
+// (deferred_directional.frag, deferred_point.frag).
+
+// =============================================================
+// G-buffer ("GBuffer" pass transients), read 1:1 with texelFetch
+// =============================================================
+uniform sampler2D u_GBufferAlbedo;   // albedo, metalness
+uniform sampler2D u_GBufferNormal;   // octahedral normal, roughness
+uniform sampler2D u_GBufferDepth;
+
+// Window coordinates (gl_FragCoord.xy, depth) -> world; folds in the
+// viewport, so the G-buffer may be larger than the rendered region
+uniform mat4 u_ScreenToWorld;
+
+struct Surface
+{
+    vec3  Position;
+    vec3  Normal;
+    vec3  Albedo;
+    float Roughness;
+    float Metalness;
+    float Depth;
+};
+
+// Inverse of EncodeOctahedral in gbuffer.frag
+vec3 DecodeOctahedral(vec2 f)
+{
+    f = f * 2.0 - 1.0;
+    vec3 n = vec3(f.x, f.y, 1.0 - abs(f.x) - abs(f.y));
+    float t = clamp(-n.z, 0.0, 1.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+Surface ReadSurface()
+{
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    vec4 albedoMetalness = texelFetch(u_GBufferAlbedo, pixel, 0);
+    vec4 normalRoughness = texelFetch(u_GBufferNormal, pixel, 0);
+
+    Surface s;
+    s.Depth = texelFetch(u_GBufferDepth, pixel, 0).r;
+
+    vec4 world = u_ScreenToWorld * vec4(gl_FragCoord.xy, s.Depth, 1.0);
+    s.Position = world.xyz / world.w;
+
+    s.Normal = DecodeOctahedral(normalRoughness.xy);
+    s.Albedo = albedoMetalness.rgb;
+    s.Metalness = albedoMetalness.a;
+    s.Roughness = normalRoughness.z;
+    return s;
+}
@@ -0,0 +1,28 @@
+#version 330 core
+
+// Deferred point light volume: one instance per light, the unit sphere is
+// placed and scaled from the light record (gl_InstanceID = light index)
+layout(location = 0) in vec3 a_Position;
+
+layout(std140) uniform FrameData
+{
+    mat4 u_View;
+    mat4 u_Projection;
+    vec4 u_ViewPos;
+    vec4 u_ClusterParams;
+    ivec4 u_ClusterGrid;
+};
+
+uniform samplerBuffer u_LightData;   // 2 texels per light: (position, radius), (radiance, 0)
+uniform float u_VolumeScale;         // grows the tessellated sphere to enclose the true one
+
+flat out int v_LightIndex;
+
+void main()
+{
+    vec4 positionRadius = texelFetch(u_LightData, gl_InstanceID * 2);
+    vec3 worldPos = positionRadius.xyz + a_Position * positionRadius.w * u_VolumeScale;
+
+    v_LightIndex = gl_InstanceID;
+    gl_Position = u_Projection * u_View * vec4(worldPos, 1.0);
+}
@@ -0,0 +1,123 @@
+// Material inputs and map sampling shared by the fragment shaders paired
+// with pbr.vert (pbr.frag forward, gbuffer.frag deferred).
+
+in vec3 v_WorldPos;
+in vec2 v_UV;
+in mat3 v_TBN;
+
+// Material fallbacks (per instance, see pbr.vert)
+flat in vec3  v_DefaultAlbedo;
+flat in float v_DefaultRoughness;
+flat in float v_DefaultMetalness;
+
+#ifdef TEXTURE_ARRAYS
+// Layers of the material's maps in the shared arrays (-1 = none)
+flat in vec4  v_MapLayers;           // albedo, normal, roughness, metalness
+flat in float v_DisplacementLayer;
+#endif
+
+// =============================================================
+// Material textures -- compiled in per variant (HAS_*_MAP defines
+// are injected by ShaderVariantCache from the material feature mask)
+// =============================================================
+#if defined(TEXTURE_ARRAYS)
+// One program for every material: maps are layers of shared arrays
+uniform sampler2DArray u_AlbedoMap;
+uniform sampler2DArray u_NormalMap;
+uniform sampler2DArray u_RoughnessMap;
+uniform sampler2DArray u_MetalnessMap;
+uniform sampler2DArray u_DisplacementMap;
+#else
+#ifdef HAS_ALBEDO_MAP
+uniform sampler2D u_AlbedoMap;
+#endif
+#ifdef HAS_NORMAL_MAP
+uniform sampler2D u_NormalMap;
+#endif
+#ifdef HAS_ROUGHNESS_MAP
+uniform sampler2D u_RoughnessMap;
+#endif
+#ifdef HAS_METALNESS_MAP
+uniform sampler2D u_MetalnessMap;
+#endif
+#ifdef HAS_DISPLACEMENT_MAP
+uniform sampler2D u_DisplacementMap;
+#endif
+#endif
+
+// =============================================================
+// Get Normal
+// =============================================================
+vec3 GetNormal(vec2 uv)
+{
+#if defined(TEXTURE_ARRAYS)
+    if (v_MapLayers.y < 0.0)
+        return normalize(v_TBN[2]);
+    vec3 n = texture(u_NormalMap, vec3(uv, v_MapLayers.y)).xyz * 2.0 - 1.0;
+    return normalize(v_TBN * n);
+#elif defined(HAS_NORMAL_MAP)
+    vec3 n = texture(u_NormalMap, uv).xyz * 2.0 - 1.0;
+    return normalize(v_TBN * n);
+#else
+    return normalize(v_TBN[2]);
+#endif
+}
+
+// =============================================================
+// Parallax Mapping
+// =============================================================
+vec2 ParallaxMapping(vec2 uv, vec3 viewDir)
+{
+#if defined(TEXTURE_ARRAYS) || defined(HAS_DISPLACEMENT_MAP)
+#if defined(TEXTURE_ARRAYS)
+    if (v_DisplacementLayer < 0.0)
+        return uv;
+    float height = texture(u_DisplacementMap, vec3(uv, v_DisplacementLayer)).r;
+#else
+    float height = texture(u_DisplacementMap, uv).r;
+#endif
+    float scale = 0.04;
+    float bias  = -0.02;
+
+    float offset = height * scale + bias;
+    return uv + viewDir.xy * offset;
+#else
+    return uv;
+#endif
+}
+
+// =============================================================
+// Albedo / roughness / metalness (map or per-instance fallback)
+// =============================================================
+vec3 GetAlbedo(vec2 uv)
+{
+#if defined(TEXTURE_ARRAYS)
+    return v_MapLayers.x >= 0.0 ? texture(u_AlbedoMap, vec3(uv, v_MapLayers.x)).rgb : v_DefaultAlbedo;
+#elif defined(HAS_ALBEDO_MAP)
+    return texture(u_AlbedoMap, uv).rgb;
+#else
+    return v_DefaultAlbedo;
+#endif
+}
+
+float GetRoughness(vec2 uv)
+{
+#if defined(TEXTURE_ARRAYS)
+    return v_MapLayers.z >= 0.0 ? texture(u_RoughnessMap, vec3(uv, v_MapLayers.z)).r : v_DefaultRoughness;
+#elif defined(HAS_ROUGHNESS_MAP)
+    return texture(u_RoughnessMap, uv).r;
+#else
+    return v_DefaultRoughness;
+#endif
+}
+
+float GetMetalness(vec2 uv)
+{
+#if defined(TEXTURE_ARRAYS)
+    return v_MapLayers.w >= 0.0 ? texture(u_MetalnessMap, vec3(uv, v_MapLayers.w)).r : v_DefaultMetalness;
+#elif defined(HAS_METALNESS_MAP)
+    return texture(u_MetalnessMap, uv).r;
+#else
+    return v_DefaultMetalness;
+#endif
+}
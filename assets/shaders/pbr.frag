@@ -1,135 +1,77 @@
 #version 330 core
 
-in vec3 v_WorldPos;
-in vec2 v_UV;
-in mat3 v_TBN;
+#include "material.glsl"
+#include "brdf.glsl"
 
-out vec4 FragColor;
+#ifdef PER_OBJECT_LIGHTS
+// Lights picked for this entity by the Renderer (strongest first)
+#define MAX_OBJECT_LIGHTS 8
+flat in uvec4 v_LightIndices;   // 2 x 16-bit indices per component, 0xFFFF = end
+#endif
 
-// =============================================================
-// Material textures
-// =============================================================
-uniform sampler2D u_AlbedoMap;
-uniform sampler2D u_NormalMap;
-uniform sampler2D u_RoughnessMap;
-uniform sampler2D u_MetalnessMap;
-uniform sampler2D u_DisplacementMap;
-
-// Enable flags
-uniform int u_AlbedoMapEnabled;
-uniform int u_NormalMapEnabled;
-uniform int u_RoughnessMapEnabled;
-uniform int u_MetalnessMapEnabled;
-uniform int u_DisplacementMapEnabled;
+out vec4 FragColor;
 
 // =============================================================
-// Material fallback values (Task 7)
+// Per-frame data (std140 blocks shared by every program)
 // =============================================================
-uniform vec3  u_Material_DefaultAlbedo;   // NEW
-uniform float u_DefaultRoughness;          // NEW
-uniform float u_DefaultMetalness;          // NEW
-
-// Legacy Phong metadata (kept for consistency)
-uniform vec3  u_Material_diffuseColor;
-uniform vec3  u_Material_specularColor;
-uniform float u_Material_shininess;
+layout(std140) uniform FrameData
+{
+    mat4 u_View;
+    mat4 u_Projection;
+    vec4 u_ViewPos;         // xyz = camera position
+    vec4 u_ClusterParams;   // xy = grid / viewport size, z = slice scale, w = slice bias
+    ivec4 u_ClusterGrid;    // xyz = cluster grid size
+};
 
-// =============================================================
-// Lighting definitions (unchanged)
-// =============================================================
 struct DirectionalLight {
     vec3 color;
     float intensity;
 };
-uniform int u_HasDirectionalLight;
-uniform DirectionalLight u_DirectionalLight;
 
-struct PointLight {
-    vec3 position;
-    vec3 color;
-    float intensity;
+layout(std140) uniform LightData
+{
+    DirectionalLight u_DirectionalLight;
+    int u_HasDirectionalLight;
 };
-#define MAX_POINT_LIGHTS 8
-uniform int u_PointLightCount;
-uniform PointLight u_PointLights[MAX_POINT_LIGHTS];
-
-uniform vec3 u_ViewPos;
 
 // =============================================================
-// Get Normal
+// Point lights (LightClusters texture buffers)
 // =============================================================
-vec3 GetNormal()
-{
-    if (u_NormalMapEnabled == 1)
-    {
-        vec3 n = texture(u_NormalMap, v_UV).xyz * 2.0 - 1.0;
-        return normalize(v_TBN * n);
-    }
+uniform samplerBuffer  u_LightData;     // 2 texels per light: (position, radius), (radiance, 0)
+#ifndef PER_OBJECT_LIGHTS
+uniform usamplerBuffer u_ClusterGrid;   // per cluster: (first index, count)
+uniform usamplerBuffer u_LightIndices;  // light indices grouped by cluster
+#endif
 
-    return normalize(v_TBN[2]); 
-}
-
-// =============================================================
-// Parallax Mapping
-// =============================================================
-vec2 ParallaxMapping(vec2 uv, vec3 viewDir)
+#ifndef PER_OBJECT_LIGHTS
+int GetClusterIndex()
 {
-    if (u_DisplacementMapEnabled == 0)
-        return uv;
+    float viewDepth = -(u_View * vec4(v_WorldPos, 1.0)).z;
+    int slice = int(log(max(viewDepth, 1e-4)) * u_ClusterParams.z + u_ClusterParams.w);
+    slice = clamp(slice, 0, u_ClusterGrid.z - 1);
 
-    float height = texture(u_DisplacementMap, uv).r;
-    float scale = 0.04;
-    float bias  = -0.02;
-
-    float offset = height * scale + bias;
-    return uv + viewDir.xy * offset;
+    ivec2 tile = clamp(ivec2(gl_FragCoord.xy * u_ClusterParams.xy), ivec2(0), u_ClusterGrid.xy - 1);
+    return tile.x + u_ClusterGrid.x * (tile.y + u_ClusterGrid.y * slice);
 }
+#endif
 
 // =============================================================
-// Fresnel Schlick
+// Point light contribution (index into u_LightData)
 // =============================================================
-vec3 FresnelSchlick(float cosTheta, vec3 F0)
+vec3 ShadePointLight(int lightIndex, vec3 N, vec3 V, vec3 albedo,
+                     float roughness, float metalness)
 {
-    return F0 + (1.0 - F0) * pow(1.0 - cosTheta, 5.0);
-}
+    vec4 positionRadius = texelFetch(u_LightData, lightIndex * 2);
+    vec3 lightRadiance  = texelFetch(u_LightData, lightIndex * 2 + 1).rgb;
 
-// =============================================================
-// GGX NDF
-// =============================================================
-float DistributionGGX(vec3 N, vec3 H, float roughness)
-{
-    float a  = roughness * roughness;
-    float a2 = a * a;
-    float NdotH = max(dot(N, H), 0.0);
-    float NdotH2 = NdotH * NdotH;
+    vec3 toLight = positionRadius.xyz - v_WorldPos;
+    float dist = length(toLight);
+    if (dist >= positionRadius.w)
+        return vec3(0.0);
 
-    float num = a2;
-    float denom = (NdotH2 * (a2 - 1.0) + 1.0);
-    denom = 3.141592 * denom * denom;
+    vec3 radiance = lightRadiance * PointLightAttenuation(dist, positionRadius.w);
 
-    return num / denom;
-}
-
-// =============================================================
-// Geometry (Smith)
-// =============================================================
-float GeometrySchlickGGX(float NdotV, float roughness)
-{
-    float r = roughness + 1.0;
-    float k = (r * r) / 8.0;
-
-    return NdotV / (NdotV * (1.0 - k) + k);
-}
-
-float GeometrySmith(vec3 N, vec3 V, vec3 L, float roughness)
-{
-    float NdotV = max(dot(N, V), 0.0);
-    float NdotL = max(dot(N, L), 0.0);
-
-    float ggx1 = GeometrySchlickGGX(NdotV, roughness);
-    float ggx2 = GeometrySchlickGGX(NdotL, roughness);
-
-    return ggx1 * ggx2;
+    return EvaluateBRDF(N, V, toLight / dist, albedo, roughness, metalness) * radiance;
 }
 
 // =============================================================
@@ -138,45 +80,17 @@ float GeometrySmith(vec3 N, vec3 V, vec3 L, float roughness)
 void main()
 {
     // View direction
-    vec3 V = normalize(u_ViewPos - v_WorldPos);
+    vec3 V = normalize(u_ViewPos.xyz - v_WorldPos);
 
     // Parallax-adjusted UV
     vec2 uv = ParallaxMapping(v_UV, normalize(v_TBN * V));
 
     // Normal
-    vec3 N = GetNormal();
-
-    // =============================================================
-    // ALBEDO
-    // =============================================================
-    vec3 albedo;
-    if (u_AlbedoMapEnabled == 1)
-        albedo = texture(u_AlbedoMap, uv).rgb;
-    else
-        albedo = u_Material_DefaultAlbedo;
+    vec3 N = GetNormal(uv);
 
-    // =============================================================
-    // ROUGHNESS
-    // =============================================================
-    float roughness;
-    if (u_RoughnessMapEnabled == 1)
-        roughness = texture(u_RoughnessMap, uv).r;
-    else
-        roughness = u_DefaultRoughness;
-
-    // =============================================================
-    // METALNESS
-    // =============================================================
-    float metalness;
-    if (u_MetalnessMapEnabled == 1)
-        metalness = texture(u_MetalnessMap, uv).r;
-    else
-        metalness = u_DefaultMetalness;
-
-    // =============================================================
-    // F0 (base reflectivity)
-    // =============================================================
-    vec3 F0 = mix(vec3(0.04), albedo, metalness);
+    vec3 albedo = GetAlbedo(uv);
+    float roughness = GetRoughness(uv);
+    float metalness = GetMetalness(uv);
 
     vec3 Lo = vec3(0.0);
 
@@ -186,60 +100,33 @@ void main()
     if (u_HasDirectionalLight == 1)
     {
         vec3 L = normalize(vec3(1.0, 1.0, 0.5));
-        vec3 H = normalize(V + L);
-
-        float NdotL = max(dot(N, L), 0.0);
-
-        float NDF = DistributionGGX(N, H, roughness);
-        float G   = GeometrySmith(N, V, L, roughness);
-        vec3  F   = FresnelSchlick(max(dot(H, V), 0.0), F0);
-
-        vec3 nom = NDF * G * F;
-        float denom = 4.0 * max(dot(N,V), 0.0) * NdotL + 0.001;
-
-        vec3 spec = nom / denom;
-
-        vec3 kS = F;
-        vec3 kD = (1.0 - kS) * (1.0 - metalness);
-
-        Lo += (kD * albedo / 3.141592 + spec)
+        Lo += EvaluateBRDF(N, V, L, albedo, roughness, metalness)
             * u_DirectionalLight.intensity
-            * u_DirectionalLight.color
-            * NdotL;
+            * u_DirectionalLight.color;
     }
 
     // =============================================================
-    // Point Lights
+    // Point Lights (this entity's list, or this fragment's cluster)
     // =============================================================
-    for (int i = 0; i < u_PointLightCount; i++)
+#ifdef PER_OBJECT_LIGHTS
+    for (int i = 0; i < MAX_OBJECT_LIGHTS; i++)
     {
-        vec3 L = normalize(u_PointLights[i].position - v_WorldPos);
-        vec3 H = normalize(V + L);
-
-        float NdotL = max(dot(N, L), 0.0);
+        uint packed = v_LightIndices[i >> 1];
+        uint lightIndex = (i & 1) == 0 ? (packed & 0xFFFFu) : (packed >> 16);
+        if (lightIndex == 0xFFFFu)
+            break;
 
-        float NDF = DistributionGGX(N, H, roughness);
-        float G   = GeometrySmith(N, V, L, roughness);
-        vec3  F   = FresnelSchlick(max(dot(H, V), 0.0), F0);
-
-        vec3 nom = NDF * G * F;
-        float denom = 4.0 * max(dot(N,V),0.0) * NdotL + 0.001;
-
-        vec3 spec = nom / denom;
-
-        vec3 kS = F;
-        vec3 kD = (1.0 - kS) * (1.0 - metalness);
-
-        float dist = length(u_PointLights[i].position - v_WorldPos);
-        float atten =
-            1.0 / (1.0 + 0.09 * dist + 0.032 * dist * dist);
-
-        vec3 radiance =
-            u_PointLights[i].color * u_PointLights[i].intensity * atten;
+        Lo += ShadePointLight(int(lightIndex), N, V, albedo, roughness, metalness);
+    }
+#else
+    uvec2 cluster = texelFetch(u_ClusterGrid, GetClusterIndex()).xy;
 
-        Lo += (kD * albedo / 3.141592 + spec)
-            * radiance * NdotL;
+    for (uint i = 0u; i < cluster.y; i++)
+    {
+        int lightIndex = int(texelFetch(u_LightIndices, int(cluster.x + i)).r);
+        Lo += ShadePointLight(lightIndex, N, V, albedo, roughness, metalness);
     }
+#endif
 
     vec3 ambient = 0.26 * albedo;
     vec3 color = ambient + Lo;
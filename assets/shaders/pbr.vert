@@ -1,30 +1,114 @@
 #version 330 core
 
+#ifdef PACKED_VERTICES
+// GeometryArena packed layouts: snorm16 read as integers, half UVs.
+// Quantized positions are dequantized by a_Model.
+layout(location = 0) in vec3 a_Position;
+layout(location = 1) in vec2 a_Normal;    // octahedral
+layout(location = 2) in vec2 a_UV;
+layout(location = 3) in vec2 a_Tangent;   // octahedral, y sign = handedness
+#else
 layout(location = 0) in vec3 a_Position;
 layout(location = 1) in vec3 a_Normal;
 layout(location = 2) in vec2 a_UV;
-layout(location = 3) in vec3 a_Tangent;
+layout(location = 3) in vec4 a_Tangent;   // w = handedness
+#endif
+
+// Per-instance stream (InstanceBuffer, divisor 1)
+layout(location = 4) in mat4 a_Model;           // locations 4..7
+layout(location = 8) in vec4 a_Albedo;          // rgb = fallback albedo
+layout(location = 9) in vec4 a_MaterialParams;  // x = roughness, y = metalness, z = material index
+#ifdef PER_OBJECT_LIGHTS
+layout(location = 10) in uvec4 a_LightIndices;  // 8 x 16-bit light indices, 0xFFFF = end
+#endif
+
+// Per-frame camera data (filled once per frame by the Renderer)
+layout(std140) uniform FrameData
+{
+    mat4 u_View;
+    mat4 u_Projection;
+    vec4 u_ViewPos;     // xyz = camera position
+    vec4 u_ClusterParams;
+    ivec4 u_ClusterGrid;
+};
 
-uniform mat4 u_Model;
-uniform mat4 u_View;
-uniform mat4 u_Projection;
+// Same expression as depth.vert, so the pre-pass depth matches exactly
+invariant gl_Position;
 
 out vec3 v_WorldPos;
 out vec2 v_UV;
 out mat3 v_TBN;
 
+// Material fallbacks, constant across each instance
+flat out vec3  v_DefaultAlbedo;
+flat out float v_DefaultRoughness;
+flat out float v_DefaultMetalness;
+
+#ifdef PER_OBJECT_LIGHTS
+flat out uvec4 v_LightIndices;
+#endif
+
+#ifdef TEXTURE_ARRAYS
+// 3 texels per material: (albedo, roughness), (metalness, albedo layer,
+// normal layer, roughness layer), (metalness layer, displacement layer, 0, 0)
+uniform samplerBuffer u_MaterialData;
+
+flat out vec4  v_MapLayers;           // albedo, normal, roughness, metalness (-1 = none)
+flat out float v_DisplacementLayer;
+#endif
+
+#ifdef PACKED_VERTICES
+vec3 OctDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0)
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(n);
+}
+#endif
+
 void main()
 {
-    vec4 worldPos = u_Model * vec4(a_Position, 1.0);
+    vec4 worldPos = a_Model * vec4(a_Position, 1.0);
     v_WorldPos = worldPos.xyz;
 
     // TBN basis vectors
-    vec3 N = normalize(mat3(u_Model) * a_Normal);
-    vec3 T = normalize(mat3(u_Model) * a_Tangent);
-    vec3 B = cross(N, T);
+#ifdef PACKED_VERTICES
+    vec2 tangent = a_Tangent / 32767.0;
+    float handedness = tangent.y < 0.0 ? -1.0 : 1.0;
+
+    vec3 N = normalize(mat3(a_Model) * OctDecode(a_Normal / 32767.0));
+    vec3 T = normalize(mat3(a_Model) * OctDecode(vec2(tangent.x, abs(tangent.y) * 2.0 - 1.0)));
+    vec3 B = cross(N, T) * handedness;
+#else
+    vec3 N = normalize(mat3(a_Model) * a_Normal);
+    vec3 T = normalize(mat3(a_Model) * a_Tangent.xyz);
+    vec3 B = cross(N, T) * a_Tangent.w;
+#endif
 
     v_TBN = mat3(T, B, N);
     v_UV = a_UV;
 
+#ifdef TEXTURE_ARRAYS
+    int record = int(a_MaterialParams.z) * 3;
+    vec4 material0 = texelFetch(u_MaterialData, record);
+    vec4 material1 = texelFetch(u_MaterialData, record + 1);
+    vec4 material2 = texelFetch(u_MaterialData, record + 2);
+
+    v_DefaultAlbedo = material0.rgb;
+    v_DefaultRoughness = material0.a;
+    v_DefaultMetalness = material1.x;
+    v_MapLayers = vec4(material1.yzw, material2.x);
+    v_DisplacementLayer = material2.y;
+#else
+    v_DefaultAlbedo = a_Albedo.rgb;
+    v_DefaultRoughness = a_MaterialParams.x;
+    v_DefaultMetalness = a_MaterialParams.y;
+#endif
+
+#ifdef PER_OBJECT_LIGHTS
+    v_LightIndices = a_LightIndices;
+#endif
+
     gl_Position = u_Projection * u_View * worldPos;
 }
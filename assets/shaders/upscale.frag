@@ -0,0 +1,15 @@
+#version 330 core
+
+// Dynamic resolution: stretch the rendered region of the scene color
+// target over the whole output (bilinear)
+out vec4 FragColor;
+
+uniform sampler2D u_Source;
+uniform vec2 u_UVScale;   // output pixel -> source uv
+uniform vec2 u_UVMax;     // last texel center inside the rendered region
+
+void main()
+{
+    vec2 uv = min(gl_FragCoord.xy * u_UVScale, u_UVMax);
+    FragColor = vec4(texture(u_Source, uv).rgb, 1.0);
+}
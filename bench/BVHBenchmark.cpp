@@ -0,0 +1,131 @@
+// -----------------------------------------------------------------------------
+// BVH micro-benchmark: build, refit and query throughput over random boxes.
+// Built only with -DGRAPHICHW_BUILD_BENCHMARKS=ON.
+// -----------------------------------------------------------------------------
+#include "Scene/BVH.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+	using Clock = std::chrono::high_resolution_clock;
+
+	double ElapsedMs(Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	// Unit-ish boxes scattered in a cube whose volume grows with the count,
+	// so density (and query selectivity) stays comparable across sizes
+	std::vector<AABB> MakeBoxes(size_t count, std::mt19937& rng)
+	{
+		float side = 4.0f * std::cbrt((float)count);
+		std::uniform_real_distribution<float> pos(-side, side);
+		std::uniform_real_distribution<float> size(0.25f, 1.5f);
+
+		std::vector<AABB> boxes(count);
+		for (auto& box : boxes)
+			box = AABB::FromCenterExtents({ pos(rng), pos(rng), pos(rng) },
+				{ size(rng), size(rng), size(rng) });
+		return boxes;
+	}
+
+	void Run(size_t count)
+	{
+		std::mt19937 rng(1234);
+		std::vector<AABB> boxes = MakeBoxes(count, rng);
+		float side = 4.0f * std::cbrt((float)count);
+
+		BVH bvh;
+
+		auto start = Clock::now();
+		bvh.Build(boxes);
+		double buildMs = ElapsedMs(start);
+
+		// Small random motion, as from animated entities
+		std::uniform_real_distribution<float> jitter(-0.5f, 0.5f);
+		for (auto& box : boxes)
+		{
+			glm::vec3 offset(jitter(rng), jitter(rng), jitter(rng));
+			box.Min += offset;
+			box.Max += offset;
+		}
+
+		start = Clock::now();
+		bvh.Refit(boxes);
+		double refitMs = ElapsedMs(start);
+
+		// Frustum queries from cameras at random positions looking at the origin
+		const int frustumQueries = 256;
+		std::uniform_real_distribution<float> eye(-side, side);
+		glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, side * 0.5f);
+
+		std::vector<uint32_t> results;
+		size_t frustumHits = 0;
+		start = Clock::now();
+		for (int i = 0; i < frustumQueries; i++)
+		{
+			glm::vec3 from(eye(rng), eye(rng), eye(rng));
+			Frustum frustum = Frustum::FromMatrix(projection * glm::lookAt(from, glm::vec3(0.0f), { 0, 1, 0 }));
+			results.clear();
+			bvh.QueryFrustum(frustum, results);
+			frustumHits += results.size();
+		}
+		double frustumMs = ElapsedMs(start);
+
+		// Sphere queries sized like point light volumes
+		const int sphereQueries = 10000;
+		size_t sphereHits = 0;
+		start = Clock::now();
+		for (int i = 0; i < sphereQueries; i++)
+		{
+			BoundingSphere sphere{ { eye(rng), eye(rng), eye(rng) }, 8.0f };
+			results.clear();
+			bvh.QuerySphere(sphere, results);
+			sphereHits += results.size();
+		}
+		double sphereMs = ElapsedMs(start);
+
+		// Picking-style rays
+		const int rayQueries = 100000;
+		size_t rayHits = 0;
+		start = Clock::now();
+		for (int i = 0; i < rayQueries; i++)
+		{
+			Ray ray{ { eye(rng), eye(rng), eye(rng) }, glm::normalize(glm::vec3(jitter(rng), jitter(rng), jitter(rng)) + 1e-3f) };
+			BVH::RayHit hit;
+			rayHits += bvh.Raycast(ray, 4.0f * side, hit) ? 1 : 0;
+		}
+		double rayMs = ElapsedMs(start);
+
+		// Cross-check one frustum query against brute force
+		Frustum check = Frustum::FromMatrix(projection * glm::lookAt(glm::vec3(side, side, side), glm::vec3(0.0f), { 0, 1, 0 }));
+		results.clear();
+		bvh.QueryFrustum(check, results);
+		size_t bruteHits = 0;
+		for (const auto& box : boxes)
+			bruteHits += check.Intersects(box) ? 1 : 0;
+
+		std::printf("%8zu entities | nodes %8zu | SAH %.1f -> %.1f\n",
+			count, bvh.GetNodes().size(), bvh.GetBuildCost(), bvh.GetCost());
+		std::printf("    build   %9.2f ms  (%6.1f M prims/s)\n", buildMs, count / buildMs / 1000.0);
+		std::printf("    refit   %9.2f ms  (%6.1f M prims/s)\n", refitMs, count / refitMs / 1000.0);
+		std::printf("    frustum %9.4f ms/query  avg %zu hits\n", frustumMs / frustumQueries, frustumHits / frustumQueries);
+		std::printf("    sphere  %9.4f ms/query  avg %.1f hits\n", sphereMs / sphereQueries, (double)sphereHits / sphereQueries);
+		std::printf("    ray     %9.4f us/query  %.1f%% hit\n", rayMs * 1000.0 / rayQueries, 100.0 * rayHits / rayQueries);
+		std::printf("    check   %s (bvh %zu, brute force %zu)\n",
+			results.size() == bruteHits ? "ok" : "MISMATCH", results.size(), bruteHits);
+	}
+}
+
+int main()
+{
+	for (size_t count : { (size_t)1000, (size_t)100000, (size_t)1000000 })
+		Run(count);
+	return 0;
+}
@@ -0,0 +1,179 @@
+// -----------------------------------------------------------------------------
+// Tangent generation micro-benchmark: the old single-threaded accumulate loop
+// against TangentGenerator on wavy grids, plus a handedness check on a grid
+// whose right half has mirrored UVs.
+// Built only with -DGRAPHICHW_BUILD_BENCHMARKS=ON.
+// -----------------------------------------------------------------------------
+#include "Graphics/TangentGenerator.h"
+#include "Core/ThreadPool.h"
+
+#include <glm/glm.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+	using Clock = std::chrono::high_resolution_clock;
+
+	double ElapsedMs(Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	// Same layout as Mesh::Vertex
+	struct Vertex
+	{
+		glm::vec3 Position;
+		glm::vec3 Normal;
+		glm::vec2 UV;
+		glm::vec4 Tangent;
+	};
+
+	// side x side quads over a height field; 'mirror' flips U on the right half
+	void MakeGrid(uint32_t side, bool mirror, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+	{
+		vertices.clear();
+		indices.clear();
+
+		for (uint32_t y = 0; y <= side; y++)
+		{
+			for (uint32_t x = 0; x <= side; x++)
+			{
+				float u = (float)x / side, v = (float)y / side;
+				float h = 0.05f * std::sin(u * 40.0f) * std::cos(v * 30.0f);
+				glm::vec3 dx(1.0f, 0.05f * 40.0f * std::cos(u * 40.0f) * std::cos(v * 30.0f), 0.0f);
+				glm::vec3 dz(0.0f, -0.05f * 30.0f * std::sin(u * 40.0f) * std::sin(v * 30.0f), 1.0f);
+
+				// V runs against +z so the unmirrored frame is right-handed
+				float texU = mirror && u > 0.5f ? 1.0f - u : u;
+				vertices.push_back({ { u, h, v }, glm::normalize(glm::cross(dz, dx)), { texU, 1.0f - v }, glm::vec4(0.0f) });
+			}
+		}
+
+		for (uint32_t y = 0; y < side; y++)
+		{
+			for (uint32_t x = 0; x < side; x++)
+			{
+				uint32_t a = y * (side + 1) + x, b = a + 1, c = a + side + 1, d = c + 1;
+				uint32_t quad[6] = { a, c, b, b, c, d };
+				indices.insert(indices.end(), quad, quad + 6);
+			}
+		}
+	}
+
+	// The previous Mesh::RecalculateTangents: scattered += and normalize, no w
+	void ReferenceTangents(std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+	{
+		for (auto& v : vertices)
+			v.Tangent = glm::vec4(0.0f);
+
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			Vertex& v0 = vertices[indices[i]];
+			Vertex& v1 = vertices[indices[i + 1]];
+			Vertex& v2 = vertices[indices[i + 2]];
+
+			glm::vec3 e1 = v1.Position - v0.Position, e2 = v2.Position - v0.Position;
+			glm::vec2 d1 = v1.UV - v0.UV, d2 = v2.UV - v0.UV;
+
+			float det = d1.x * d2.y - d1.y * d2.x;
+			float r = det != 0.0f ? 1.0f / det : 1.0f;
+			glm::vec4 t(glm::vec3((e1 * d2.y - e2 * d1.y) * r), 0.0f);
+
+			v0.Tangent += t;
+			v1.Tangent += t;
+			v2.Tangent += t;
+		}
+
+		for (auto& v : vertices)
+			v.Tangent = glm::vec4(glm::normalize(glm::vec3(v.Tangent)), 1.0f);
+	}
+
+	// Like Mesh::RecalculateTangents: seam copies are appended
+	void Generate(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+	{
+		TangentGenerator::Streams streams;
+		streams.Positions = &vertices[0].Position.x;
+		streams.Normals = &vertices[0].Normal.x;
+		streams.UVs = &vertices[0].UV.x;
+		streams.Tangents = &vertices[0].Tangent.x;
+		streams.Stride = sizeof(Vertex);
+		std::vector<TangentGenerator::Split> splits = TangentGenerator::Generate(indices, (uint32_t)vertices.size(), streams);
+
+		for (const TangentGenerator::Split& split : splits)
+		{
+			Vertex v = vertices[split.Source];
+			v.Tangent = glm::vec4(split.Tangent[0], split.Tangent[1], split.Tangent[2], split.Tangent[3]);
+			vertices.push_back(v);
+		}
+	}
+
+	void Run(uint32_t side)
+	{
+		std::vector<Vertex> vertices;
+		std::vector<uint32_t> indices;
+		MakeGrid(side, false, vertices, indices);
+
+		auto start = Clock::now();
+		ReferenceTangents(vertices, indices);
+		double referenceMs = ElapsedMs(start);
+		std::vector<Vertex> reference = vertices;
+
+		start = Clock::now();
+		Generate(vertices, indices);
+		double generatorMs = ElapsedMs(start);
+
+		// Frames should agree closely away from degenerate corners
+		double maxAngle = 0.0, maxOrthogonality = 0.0;
+		for (size_t i = 0; i < vertices.size(); i++)
+		{
+			glm::vec3 t = glm::vec3(vertices[i].Tangent);
+			glm::vec3 r = glm::normalize(glm::vec3(reference[i].Tangent) -
+				vertices[i].Normal * glm::dot(vertices[i].Normal, glm::vec3(reference[i].Tangent)));
+			maxAngle = std::max(maxAngle, (double)std::acos(glm::clamp(glm::dot(t, r), -1.0f, 1.0f)));
+			maxOrthogonality = std::max(maxOrthogonality, (double)std::abs(glm::dot(t, vertices[i].Normal)));
+		}
+
+		double triangles = indices.size() / 3.0;
+		std::printf("%8.0f triangles | %8zu vertices\n", triangles, vertices.size());
+		std::printf("    reference %9.2f ms  (%6.1f M tris/s)\n", referenceMs, triangles / referenceMs / 1000.0);
+		std::printf("    generator %9.2f ms  (%6.1f M tris/s, %u workers + caller)\n",
+			generatorMs, triangles / generatorMs / 1000.0, ThreadPool::Get().GetWorkerCount());
+		std::printf("    max deviation %.3f deg, max |dot(T, N)| %.2e\n", glm::degrees(maxAngle), maxOrthogonality);
+	}
+
+	// Every corner in the mirrored half must reference a vertex with
+	// w = -1, the rest +1 -- including the mirror line, whose vertices
+	// are split between the two halves
+	void CheckHandedness()
+	{
+		std::vector<Vertex> vertices;
+		std::vector<uint32_t> indices;
+		const uint32_t side = 64;
+		MakeGrid(side, true, vertices, indices);
+		const size_t gridVertices = vertices.size();
+		Generate(vertices, indices);
+
+		uint32_t wrong = 0;
+		for (size_t i = 0; i < indices.size(); i++)
+		{
+			uint32_t x = (uint32_t)(i / 6) % side;   // 6 indices per quad
+			float expected = x >= side / 2 ? -1.0f : 1.0f;
+			wrong += vertices[indices[i]].Tangent.w != expected ? 1 : 0;
+		}
+
+		std::printf("handedness check %s (%u / %zu corners wrong, %zu seam vertices split)\n",
+			wrong == 0 ? "ok" : "FAILED", wrong, indices.size(), vertices.size() - gridVertices);
+	}
+}
+
+int main()
+{
+	for (uint32_t side : { 64u, 256u, 724u, 1448u })   // ~8K .. ~4M triangles
+		Run(side);
+	CheckHandedness();
+	return 0;
+}
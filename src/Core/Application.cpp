@@ -4,15 +4,26 @@
 #include "Graphics/Material.h"
 #include "Graphics/Light.h"
 #include "Graphics/Framebuffer.h"
+#include "Graphics/MeshFile.h"
+#include "Graphics/TextureLibrary.h"
+#include "Scene/GltfImporter.h"
+#include "Utils/FileSystem.h"
 #include <GLFW/glfw3.h>
 
+namespace
+{
+	// Render-thread time per frame for uploading async-loaded textures
+	constexpr float TextureUploadBudgetMs = 2.0f;
+}
+
 //---------------------------------------------------------
 // Constructor  camera controller initialized here
 //---------------------------------------------------------
-Application::Application()
+Application::Application(const std::string& scenePath)
 	: m_Window(1280, 720, "GraphicHW")
 	, m_UI(&m_Window)
 	, m_CamController(&m_Scene.GetCamera(), &m_Window)
+	, m_ScenePath(scenePath)
 {
 	Init();
 }
@@ -32,7 +43,11 @@ void Application::Init()
 	// =====================================================
 	// 1) Create off-screen framebuffer
 	// =====================================================
-	m_Framebuffer = new Framebuffer(1280, 720);
+	FramebufferSpecification viewportSpec;
+	viewportSpec.Width = 1280;
+	viewportSpec.Height = 720;
+	viewportSpec.Pool = &m_Renderer.GetRenderTargetPool();
+	m_Framebuffer = new Framebuffer(viewportSpec);
 	m_Renderer.SetFramebuffer(m_Framebuffer);
 
 	// =====================================================
@@ -51,14 +66,43 @@ void Application::Init()
 	m_Scene.AddLight(pointLight);
 
 	// =====================================================
-	// 3) Mesh + Material
+	// 3) Imported scene, if one was given
 	// =====================================================
-	Mesh* cubeMesh = Mesh::CreateCube();
+	if (!m_ScenePath.empty())
+	{
+		// OBJ models go through the .mesh cache (MeshFile::LoadCached)
+		bool loaded = false;
+		if (FileSystem::GetExtension(m_ScenePath) == "obj")
+		{
+			if (Mesh* mesh = MeshFile::LoadCached(m_ScenePath, SceneVertexFormat))
+			{
+				Material material;
+				m_Scene.CreateEntity(mesh, &material);
+				loaded = true;
+			}
+		}
+		else
+		{
+			loaded = GltfImporter::Import(m_ScenePath, m_Scene, SceneVertexFormat);
+		}
+
+		if (loaded)
+		{
+			m_AnimateEntities = false;
+			return;
+		}
+		Log::Warn("Falling back to the sample scene: " + m_ScenePath);
+	}
+
+	// =====================================================
+	// 4) Mesh + Material
+	// =====================================================
+	Mesh* cubeMesh = Mesh::CreateCube(SceneVertexFormat);
 	Material* cubeMat = new Material();
 	cubeMat->SetDiffuseColor({ 0.6f, 0.6f, 0.8f });
 
 	// =====================================================
-	// 4) Create sample entities
+	// 5) Create sample entities
 	// =====================================================
 	const float spacing = 2.0f;
 	for (int i = 0; i < 3; i++)
@@ -81,6 +125,9 @@ void Application::Shutdown()
 
 void Application::UpdateEntityAnimations(float dt)
 {
+	if (!m_AnimateEntities)
+		return;
+
 	for (auto& e : m_Scene.GetEntities())
 	{
 		glm::vec3 rot = e.GetTransform().GetRotation();
@@ -125,6 +172,11 @@ void Application::Run()
 
 		// 6) Auto-rotation animation
 		 UpdateEntityAnimations(dt);
+		m_Scene.UpdateBounds();
+
+		// Swap in textures that finished loading in the background
+		TextureLibrary::Update(TextureUploadBudgetMs,
+			m_Renderer.GetMaterialBinding() == MaterialBinding::TextureArrays);
 
 		// 7) Render world into Framebuffer (NOT to screen)
 		m_Renderer.Render(m_Scene);
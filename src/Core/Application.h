@@ -1,8 +1,10 @@
 #pragma once
 
+#include <string>
 #include "Window.h"
 #include "Timer.h"
 #include "Scene/Scene.h"
+#include "Graphics/GeometryArena.h"
 #include "UI/UIManager.h"
 #include "Graphics/Renderer.h"
 #include "Graphics/Framebuffer.h"       //  NEW for Task10
@@ -11,7 +13,13 @@
 class Application
 {
 public:
-	Application();
+	// Vertex format of imported models (and of the .mesh files written
+	// by --convert, so the cache matches)
+	static constexpr VertexFormat SceneVertexFormat = VertexFormat::PackedQuantized;
+
+	// 'scenePath': optional glTF / glb / obj file to show instead of the
+	// sample cubes
+	explicit Application(const std::string& scenePath = "");
 	~Application();
 
 	void Run();
@@ -33,5 +41,8 @@ private:
 
 	CameraController m_CamController;
 
+	std::string      m_ScenePath;
+	bool             m_AnimateEntities = true;   // sample cubes spin, imported scenes stay put
+
 	bool             m_Running = true;
 };
@@ -0,0 +1,131 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned int workerCount)
+{
+	m_Workers.reserve(workerCount);
+	for (unsigned int i = 0; i < workerCount; i++)
+		m_Workers.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Stopping = true;
+	}
+	m_Condition.notify_all();
+
+	for (auto& worker : m_Workers)
+		worker.join();
+}
+
+ThreadPool& ThreadPool::Get()
+{
+	static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+	return pool;
+}
+
+// ------------------------------------------------------------
+// Queue
+// ------------------------------------------------------------
+void ThreadPool::Enqueue(std::function<void()> job)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Jobs.push(std::move(job));
+	}
+	m_Condition.notify_one();
+}
+
+void ThreadPool::WorkerLoop()
+{
+	for (;;)
+	{
+		std::function<void()> job;
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Condition.wait(lock, [this]() { return m_Stopping || !m_Jobs.empty(); });
+
+			// Drain remaining work before exiting
+			if (m_Jobs.empty())
+				return;
+
+			job = std::move(m_Jobs.front());
+			m_Jobs.pop();
+		}
+		job();
+	}
+}
+
+// ------------------------------------------------------------
+// ParallelFor -- chunks are claimed from a shared atomic cursor,
+// so fast threads take more of them and no chunk runs twice
+// ------------------------------------------------------------
+void ThreadPool::ParallelFor(uint32_t count, uint32_t grainSize,
+	const std::function<void(uint32_t begin, uint32_t end)>& body)
+{
+	if (count == 0)
+		return;
+
+	grainSize = std::max(grainSize, 1u);
+	uint32_t chunkCount = (count + grainSize - 1) / grainSize;
+
+	if (chunkCount == 1 || m_Workers.empty())
+	{
+		body(0, count);
+		return;
+	}
+
+	// Helpers only help: the caller claims chunks too, so the loop finishes
+	// even if every worker is busy with long Submit() jobs. Helpers that
+	// start after the caller is done see 'Closed' and never touch 'body'.
+	struct Shared
+	{
+		std::atomic<uint32_t>   NextChunk{ 0 };
+		std::mutex              Mutex;
+		std::condition_variable Idle;
+		uint32_t                Active = 0;
+		bool                    Closed = false;
+	};
+	auto shared = std::make_shared<Shared>();
+	const auto* bodyPtr = &body;
+
+	auto run = [shared, bodyPtr, count, grainSize, chunkCount]()
+	{
+		uint32_t chunk;
+		while ((chunk = shared->NextChunk.fetch_add(1)) < chunkCount)
+		{
+			uint32_t begin = chunk * grainSize;
+			(*bodyPtr)(begin, std::min(begin + grainSize, count));
+		}
+	};
+
+	uint32_t helpers = std::min<uint32_t>((uint32_t)m_Workers.size(), chunkCount - 1);
+	for (uint32_t i = 0; i < helpers; i++)
+	{
+		Enqueue([shared, run]()
+		{
+			{
+				std::lock_guard<std::mutex> lock(shared->Mutex);
+				if (shared->Closed)
+					return;
+				shared->Active++;
+			}
+
+			run();
+
+			std::lock_guard<std::mutex> lock(shared->Mutex);
+			if (--shared->Active == 0)
+				shared->Idle.notify_one();
+		});
+	}
+
+	run();
+
+	// 'body' lives on the caller's stack -- wait out helpers still inside it
+	std::unique_lock<std::mutex> lock(shared->Mutex);
+	shared->Closed = true;
+	shared->Idle.wait(lock, [&]() { return shared->Active == 0; });
+}
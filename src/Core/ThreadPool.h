@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// ThreadPool -- fixed set of worker threads fed from one FIFO queue.
+// Get() returns the process-wide pool (hardware threads - 1 workers); the
+// calling thread joins in on ParallelFor so a frame never idles waiting.
+// -----------------------------------------------------------------------------
+class ThreadPool
+{
+public:
+	explicit ThreadPool(unsigned int workerCount);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	static ThreadPool& Get();
+
+	unsigned int GetWorkerCount() const { return (unsigned int)m_Workers.size(); }
+
+	// Run 'task' on a worker; the future carries its result (or exception)
+	template<typename F>
+	auto Submit(F&& task) -> std::future<decltype(task())>
+	{
+		using Result = decltype(task());
+		auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+		std::future<Result> future = packaged->get_future();
+		Enqueue([packaged]() { (*packaged)(); });
+		return future;
+	}
+
+	// Split [0, count) into chunks of 'grainSize' and run 'body(begin, end)'
+	// on the workers and the calling thread; returns when all chunks are done
+	void ParallelFor(uint32_t count, uint32_t grainSize,
+		const std::function<void(uint32_t begin, uint32_t end)>& body);
+
+private:
+	void Enqueue(std::function<void()> job);
+	void WorkerLoop();
+
+private:
+	std::vector<std::thread>          m_Workers;
+	std::queue<std::function<void()>> m_Jobs;
+	std::mutex                        m_Mutex;
+	std::condition_variable           m_Condition;
+	bool                              m_Stopping = false;
+};
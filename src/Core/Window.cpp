@@ -1,5 +1,6 @@
 #include "Window.h"
 #include "Utils/Log.h"
+#include "Graphics/GLExtensions.h"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -75,6 +76,8 @@ Window::Window(int width, int height, const std::string& title)
 		return;
 	}
 
+	GLExtensions::Load((GLExtensions::LoadProc)glfwGetProcAddress);
+
 	Log::Info("Window created successfully: " + title);
 }
 
@@ -0,0 +1,130 @@
+#include "Bounds.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// ------------------------------------------------------------
+// AABB
+// ------------------------------------------------------------
+AABB AABB::FromCenterExtents(const glm::vec3& center, const glm::vec3& extents)
+{
+	AABB box;
+	box.Min = center - extents;
+	box.Max = center + extents;
+	return box;
+}
+
+AABB AABB::Empty()
+{
+	AABB box;
+	box.Min = glm::vec3(std::numeric_limits<float>::max());
+	box.Max = glm::vec3(-std::numeric_limits<float>::max());
+	return box;
+}
+
+// Arvo: new extents = |M3x3| * extents
+AABB AABB::Transformed(const glm::mat4& matrix) const
+{
+	glm::vec3 center = glm::vec3(matrix * glm::vec4(GetCenter(), 1.0f));
+	glm::vec3 extents = GetExtents();
+
+	glm::vec3 newExtents;
+	for (int row = 0; row < 3; row++)
+	{
+		newExtents[row] =
+			std::abs(matrix[0][row]) * extents.x +
+			std::abs(matrix[1][row]) * extents.y +
+			std::abs(matrix[2][row]) * extents.z;
+	}
+
+	return FromCenterExtents(center, newExtents);
+}
+
+// ------------------------------------------------------------
+// BoundingSphere
+// ------------------------------------------------------------
+BoundingSphere BoundingSphere::Transformed(const glm::mat4& matrix) const
+{
+	float sx = glm::dot(glm::vec3(matrix[0]), glm::vec3(matrix[0]));
+	float sy = glm::dot(glm::vec3(matrix[1]), glm::vec3(matrix[1]));
+	float sz = glm::dot(glm::vec3(matrix[2]), glm::vec3(matrix[2]));
+
+	BoundingSphere sphere;
+	sphere.Center = glm::vec3(matrix * glm::vec4(Center, 1.0f));
+	sphere.Radius = Radius * std::sqrt(std::max(sx, std::max(sy, sz)));
+	return sphere;
+}
+
+// ------------------------------------------------------------
+// Frustum
+// ------------------------------------------------------------
+Frustum Frustum::FromMatrix(const glm::mat4& m)
+{
+	// glm is column-major: row i = (m[0][i], m[1][i], m[2][i], m[3][i])
+	auto Row = [&](int i) { return glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]); };
+
+	glm::vec4 r0 = Row(0), r1 = Row(1), r2 = Row(2), r3 = Row(3);
+
+	Frustum frustum;
+	frustum.m_Planes[Left] = r3 + r0;
+	frustum.m_Planes[Right] = r3 - r0;
+	frustum.m_Planes[Bottom] = r3 + r1;
+	frustum.m_Planes[Top] = r3 - r1;
+	frustum.m_Planes[Near] = r3 + r2;
+	frustum.m_Planes[Far] = r3 - r2;
+
+	for (auto& plane : frustum.m_Planes)
+		plane /= glm::length(glm::vec3(plane));
+
+	return frustum;
+}
+
+bool Frustum::Intersects(const AABB& box) const
+{
+	glm::vec3 center = box.GetCenter();
+	glm::vec3 extents = box.GetExtents();
+
+	for (const auto& plane : m_Planes)
+	{
+		glm::vec3 n = glm::vec3(plane);
+		float distance = glm::dot(n, center) + plane.w;
+		float radius = glm::dot(glm::abs(n), extents);
+
+		if (distance + radius < 0.0f)
+			return false;
+	}
+	return true;
+}
+
+bool Frustum::Intersects(const AABB& box, uint32_t& mask) const
+{
+	glm::vec3 center = box.GetCenter();
+	glm::vec3 extents = box.GetExtents();
+
+	for (int i = 0; i < Count; i++)
+	{
+		if (!(mask & (1u << i)))
+			continue;
+
+		glm::vec3 n = glm::vec3(m_Planes[i]);
+		float distance = glm::dot(n, center) + m_Planes[i].w;
+		float radius = glm::dot(glm::abs(n), extents);
+
+		if (distance + radius < 0.0f)
+			return false;
+		if (distance - radius >= 0.0f)
+			mask &= ~(1u << i);
+	}
+	return true;
+}
+
+bool Frustum::Intersects(const BoundingSphere& sphere) const
+{
+	for (const auto& plane : m_Planes)
+	{
+		if (glm::dot(glm::vec3(plane), sphere.Center) + plane.w < -sphere.Radius)
+			return false;
+	}
+	return true;
+}
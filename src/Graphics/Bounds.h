@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+// -----------------------------------------------------------------------------
+// Bounding volumes + view frustum used for visibility tests
+// -----------------------------------------------------------------------------
+
+struct AABB
+{
+	glm::vec3 Min = glm::vec3(0.0f);
+	glm::vec3 Max = glm::vec3(0.0f);
+
+	glm::vec3 GetCenter() const  { return (Min + Max) * 0.5f; }
+	glm::vec3 GetExtents() const { return (Max - Min) * 0.5f; }
+
+	float GetSurfaceArea() const
+	{
+		glm::vec3 d = Max - Min;
+		return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+	}
+
+	void Expand(const AABB& other)       { Min = glm::min(Min, other.Min); Max = glm::max(Max, other.Max); }
+	void Expand(const glm::vec3& point)  { Min = glm::min(Min, point); Max = glm::max(Max, point); }
+
+	bool Intersects(const AABB& other) const
+	{
+		return glm::all(glm::lessThanEqual(Min, other.Max)) &&
+			glm::all(glm::greaterThanEqual(Max, other.Min));
+	}
+
+	// Smallest AABB enclosing this box after an affine transform
+	AABB Transformed(const glm::mat4& matrix) const;
+
+	static AABB FromCenterExtents(const glm::vec3& center, const glm::vec3& extents);
+
+	// Inverted box that any Expand() overwrites
+	static AABB Empty();
+};
+
+struct BoundingSphere
+{
+	glm::vec3 Center = glm::vec3(0.0f);
+	float     Radius = 0.0f;
+
+	// Conservative: radius scales by the largest axis scale
+	BoundingSphere Transformed(const glm::mat4& matrix) const;
+};
+
+struct Ray
+{
+	glm::vec3 Origin    = glm::vec3(0.0f);
+	glm::vec3 Direction = glm::vec3(0.0f, 0.0f, -1.0f);
+};
+
+class Frustum
+{
+public:
+	// Planes (normal.xyz, distance.w) pointing inward, normalized
+	enum Plane { Left = 0, Right, Bottom, Top, Near, Far, Count };
+
+	Frustum() = default;
+
+	// Gribb-Hartmann extraction from projection * view
+	static Frustum FromMatrix(const glm::mat4& viewProjection);
+
+	bool Intersects(const AABB& box) const;
+	bool Intersects(const BoundingSphere& sphere) const;
+
+	// Plane-masked test for hierarchical traversal: bit i of 'mask' set means
+	// plane i still needs testing. Planes the box lies fully inside are cleared
+	// from the mask; returns false if the box is outside any plane.
+	bool Intersects(const AABB& box, uint32_t& mask) const;
+
+	const glm::vec4& GetPlane(int index) const { return m_Planes[index]; }
+
+private:
+	glm::vec4 m_Planes[Count];
+};
@@ -41,6 +41,14 @@ glm::mat4 Camera::GetProjectionMatrix(float aspectRatio) const
 	return glm::perspective(glm::radians(m_FOV), aspectRatio, m_NearClip, m_FarClip);
 }
 
+//---------------------------------------------------------
+// View frustum (planes from projection * view)
+//---------------------------------------------------------
+Frustum Camera::GetFrustum(float aspectRatio) const
+{
+	return Frustum::FromMatrix(GetProjectionMatrix(aspectRatio) * GetViewMatrix());
+}
+
 //---------------------------------------------------------
 // Position control
 //---------------------------------------------------------
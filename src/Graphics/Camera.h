@@ -1,6 +1,7 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include "Graphics/Bounds.h"
 
 class Camera
 {
@@ -11,6 +12,9 @@ public:
 	glm::mat4 GetViewMatrix() const;
 	glm::mat4 GetProjectionMatrix(float aspectRatio) const;
 
+	// World-space frustum planes for the given aspect ratio
+	Frustum GetFrustum(float aspectRatio) const;
+
 	// Position
 	void SetPosition(const glm::vec3& pos);
 	const glm::vec3& GetPosition() const;
@@ -0,0 +1,50 @@
+#include "DynamicResolution.h"
+
+#include <algorithm>
+#include <cmath>
+
+bool DynamicResolution::Update(float gpuMs)
+{
+	if (gpuMs <= 0.0f)
+		return false;
+
+	m_SmoothedMs = m_Samples++ == 0 ? gpuMs :
+		m_SmoothedMs + (gpuMs - m_SmoothedMs) * m_Settings.Smoothing;
+
+	if (!m_Settings.Enabled)
+		return false;
+
+	float target = m_Settings.TargetMs;
+	if (std::abs(m_SmoothedMs - target) <= target * m_Settings.DeadBand)
+		return false;
+
+	// Pixel cost ~ scale^2; move halfway to the estimate to damp oscillation
+	float scale = GetScale();
+	float ideal = scale * std::sqrt(target / m_SmoothedMs);
+	float next = scale + (ideal - scale) * 0.5f;
+
+	next = std::round(next / m_Settings.ScaleStep) * m_Settings.ScaleStep;
+	next = std::clamp(next, m_Settings.MinScale, m_Settings.MaxScale);
+
+	if (next == scale)
+		return false;
+
+	// Until new measurements arrive, assume cost follows the pixel count
+	m_SmoothedMs *= (next * next) / (scale * scale);
+	m_Scale = next;
+	return true;
+}
+
+float DynamicResolution::GetScale() const
+{
+	if (!m_Settings.Enabled)
+		return 1.0f;
+	return std::clamp(m_Scale, m_Settings.MinScale, m_Settings.MaxScale);
+}
+
+void DynamicResolution::GetRenderSize(int width, int height, int& renderWidth, int& renderHeight) const
+{
+	float scale = GetScale();
+	renderWidth = std::max(1, (int)std::lround(width * scale));
+	renderHeight = std::max(1, (int)std::lround(height * scale));
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+
+// -----------------------------------------------------------------------------
+// DynamicResolution -- picks the internal render scale from measured GPU
+// frame time. Cost is roughly proportional to pixel count (scale^2), so the
+// controller moves the scale by sqrt(target / measured), smoothed and damped:
+//   - measurements go through an exponential moving average
+//   - no change inside a dead band around the target
+//   - the scale is quantized so the viewport size does not shimmer
+// -----------------------------------------------------------------------------
+class DynamicResolution
+{
+public:
+	struct Settings
+	{
+		bool  Enabled = false;
+		float TargetMs = 1000.0f / 60.0f;
+		float MinScale = 0.5f;
+		float MaxScale = 1.0f;
+		float DeadBand = 0.1f;       // fraction of TargetMs left alone
+		float Smoothing = 0.2f;      // weight of the newest measurement
+		float ScaleStep = 1.0f / 32.0f;
+	};
+
+	Settings& GetSettings() { return m_Settings; }
+	const Settings& GetSettings() const { return m_Settings; }
+
+	// Feed one GPU frame time; returns true when the scale changed
+	bool Update(float gpuMs);
+
+	// Current scale (1 when disabled), clamped to [MinScale, MaxScale]
+	float GetScale() const;
+
+	float GetSmoothedMs() const { return m_SmoothedMs; }
+
+	// Render size for an output of width x height (at least 1 x 1)
+	void GetRenderSize(int width, int height, int& renderWidth, int& renderHeight) const;
+
+private:
+	Settings m_Settings;
+	float    m_Scale = 1.0f;
+	float    m_SmoothedMs = 0.0f;
+	uint32_t m_Samples = 0;
+};
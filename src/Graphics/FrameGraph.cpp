@@ -0,0 +1,463 @@
+#include "FrameGraph.h"
+#include "Graphics/GLState.h"
+#include "Graphics/RenderTargetPool.h"
+#include "Utils/Log.h"
+
+#include <glad/glad.h>
+#include <algorithm>
+
+// ------------------------------------------------------------
+// Builder
+// ------------------------------------------------------------
+FrameGraphResource FrameGraphBuilder::Create(const std::string& name, const FrameGraphTextureDesc& desc)
+{
+	FrameGraph::ResourceNode node;
+	node.Name = name;
+	node.Desc = desc;
+	m_Graph.m_Resources.push_back(node);
+
+	return Write((FrameGraphResource)(m_Graph.m_Resources.size() - 1));
+}
+
+FrameGraphResource FrameGraphBuilder::Read(FrameGraphResource resource)
+{
+	auto& reads = m_Graph.m_Passes[m_Pass].Reads;
+	if (std::find(reads.begin(), reads.end(), resource) == reads.end())
+		reads.push_back(resource);
+	return resource;
+}
+
+FrameGraphResource FrameGraphBuilder::Write(FrameGraphResource resource)
+{
+	FrameGraph::PassNode& pass = m_Graph.m_Passes[m_Pass];
+	FrameGraph::ResourceNode& node = m_Graph.m_Resources[resource];
+
+	if (std::find(pass.Writes.begin(), pass.Writes.end(), resource) == pass.Writes.end())
+	{
+		pass.Writes.push_back(resource);
+		node.Writers.push_back(m_Pass);
+	}
+
+	// Results leave the graph -- nothing inside it can tell they are unused
+	if (node.Imported)
+		pass.SideEffect = true;
+
+	return resource;
+}
+
+void FrameGraphBuilder::SetSideEffect()
+{
+	m_Graph.m_Passes[m_Pass].SideEffect = true;
+}
+
+// ------------------------------------------------------------
+// Execute-time resource access
+// ------------------------------------------------------------
+unsigned int FrameGraphResources::GetTexture(FrameGraphResource resource) const
+{
+	const FrameGraph::ResourceNode& node = m_Graph.m_Resources[resource];
+	if (node.Imported)
+		return node.Imported->GetColorAttachmentID();
+	return node.Physical >= 0 ? m_Graph.m_Physical[node.Physical].TextureID : 0;
+}
+
+const FrameGraphTextureDesc& FrameGraphResources::GetDesc(FrameGraphResource resource) const
+{
+	return m_Graph.m_Resources[resource].Desc;
+}
+
+void FrameGraphResources::BindRenderTarget() const
+{
+	const FrameGraph::PassNode& pass = m_Graph.m_Passes[m_Pass];
+
+	for (FrameGraphResource resource : pass.Writes)
+	{
+		if (Framebuffer* framebuffer = m_Graph.m_Resources[resource].Imported)
+		{
+			framebuffer->Bind();
+			return;
+		}
+	}
+
+	GLState::BindFramebuffer(pass.FramebufferID);
+}
+
+// ------------------------------------------------------------
+// Graph
+// ------------------------------------------------------------
+FrameGraph::FrameGraph(RenderTargetPool& pool)
+	: m_Pool(pool)
+{
+}
+
+FrameGraph::~FrameGraph()
+{
+	for (auto& entry : m_Framebuffers)
+	{
+		GLState::OnFramebufferDeleted(entry.second.ID);
+		glDeleteFramebuffers(1, &entry.second.ID);
+	}
+}
+
+void FrameGraph::Reset()
+{
+	m_Resources.clear();
+	m_Passes.clear();
+	m_Order.clear();
+	m_Physical.clear();
+	m_Compiled = false;
+	m_Stats = Stats();
+}
+
+FrameGraphResource FrameGraph::ImportFramebuffer(const std::string& name, Framebuffer* framebuffer)
+{
+	ResourceNode node;
+	node.Name = name;
+	node.Imported = framebuffer;
+	node.Desc.Format = framebuffer->GetSpecification().ColorAttachments.empty() ?
+		FramebufferTextureFormat::None : framebuffer->GetSpecification().ColorAttachments[0];
+	node.Desc.Width = framebuffer->GetAllocatedWidth();
+	node.Desc.Height = framebuffer->GetAllocatedHeight();
+	m_Resources.push_back(node);
+
+	return (FrameGraphResource)(m_Resources.size() - 1);
+}
+
+void FrameGraph::AddPass(const std::string& name, const SetupFunc& setup, const ExecuteFunc& execute)
+{
+	PassNode pass;
+	pass.Name = name;
+	pass.Execute = execute;
+	m_Passes.push_back(pass);
+
+	FrameGraphBuilder builder(*this, (uint32_t)(m_Passes.size() - 1));
+	setup(builder);
+}
+
+void FrameGraph::Compile()
+{
+	CullPasses();
+	OrderPasses();
+	AssignPhysicalTextures();
+
+	m_Stats.Passes = (uint32_t)m_Order.size();
+	m_Stats.CulledPasses = (uint32_t)(m_Passes.size() - m_Order.size());
+	m_Compiled = true;
+}
+
+// ------------------------------------------------------------
+// 1) Culling -- reference counts: a pass is needed by the resources it
+// writes, a resource by the passes reading it. Unread resources release
+// their writers; writers left with no needed output release their reads.
+// ------------------------------------------------------------
+void FrameGraph::CullPasses()
+{
+	for (PassNode& pass : m_Passes)
+	{
+		pass.RefCount = (uint32_t)pass.Writes.size();
+		pass.Culled = false;
+	}
+
+	for (ResourceNode& resource : m_Resources)
+		resource.RefCount = 0;
+	for (const PassNode& pass : m_Passes)
+		for (FrameGraphResource resource : pass.Reads)
+			m_Resources[resource].RefCount++;
+
+	std::vector<FrameGraphResource> unused;
+	for (uint32_t i = 0; i < (uint32_t)m_Resources.size(); i++)
+	{
+		if (m_Resources[i].RefCount == 0 && !m_Resources[i].Imported)
+			unused.push_back(i);
+	}
+
+	while (!unused.empty())
+	{
+		FrameGraphResource resource = unused.back();
+		unused.pop_back();
+
+		for (uint32_t writer : m_Resources[resource].Writers)
+		{
+			PassNode& pass = m_Passes[writer];
+			if (pass.SideEffect || pass.Culled || --pass.RefCount > 0)
+				continue;
+
+			pass.Culled = true;
+			for (FrameGraphResource read : pass.Reads)
+			{
+				if (--m_Resources[read].RefCount == 0 && !m_Resources[read].Imported)
+					unused.push_back(read);
+			}
+		}
+	}
+
+	// Side-effect passes that write nothing still count as live
+	for (PassNode& pass : m_Passes)
+	{
+		if (pass.Writes.empty() && !pass.SideEffect)
+			pass.Culled = true;
+	}
+}
+
+// ------------------------------------------------------------
+// 2) Ordering -- Kahn's algorithm over writer -> reader edges (and
+// writer -> writer in declaration order); ties go to the pass declared
+// first, so an already valid declaration order is kept as is
+// ------------------------------------------------------------
+void FrameGraph::OrderPasses()
+{
+	size_t passCount = m_Passes.size();
+	std::vector<std::vector<uint32_t>> successors(passCount);
+	std::vector<uint32_t> inDegree(passCount, 0);
+
+	auto addEdge = [&](uint32_t from, uint32_t to)
+	{
+		if (from == to || m_Passes[from].Culled || m_Passes[to].Culled)
+			return;
+		successors[from].push_back(to);
+		inDegree[to]++;
+	};
+
+	for (uint32_t p = 0; p < passCount; p++)
+	{
+		for (FrameGraphResource resource : m_Passes[p].Reads)
+		{
+			for (uint32_t writer : m_Resources[resource].Writers)
+				addEdge(writer, p);
+		}
+	}
+
+	for (const ResourceNode& resource : m_Resources)
+	{
+		for (size_t w = 1; w < resource.Writers.size(); w++)
+			addEdge(resource.Writers[w - 1], resource.Writers[w]);
+	}
+
+	m_Order.clear();
+	std::vector<uint32_t> ready;
+	for (uint32_t p = 0; p < passCount; p++)
+	{
+		if (!m_Passes[p].Culled && inDegree[p] == 0)
+			ready.push_back(p);
+	}
+
+	while (!ready.empty())
+	{
+		auto first = std::min_element(ready.begin(), ready.end());
+		uint32_t pass = *first;
+		ready.erase(first);
+		m_Order.push_back(pass);
+
+		for (uint32_t next : successors[pass])
+		{
+			if (--inDegree[next] == 0)
+				ready.push_back(next);
+		}
+	}
+
+	// A cycle leaves passes with pending inputs -- fall back to declaration order
+	size_t livePasses = std::count_if(m_Passes.begin(), m_Passes.end(),
+		[](const PassNode& pass) { return !pass.Culled; });
+
+	if (m_Order.size() != livePasses)
+	{
+		Log::Error("FrameGraph: dependency cycle, executing passes in declaration order");
+
+		m_Order.clear();
+		for (uint32_t p = 0; p < passCount; p++)
+		{
+			if (!m_Passes[p].Culled)
+				m_Order.push_back(p);
+		}
+	}
+}
+
+// ------------------------------------------------------------
+// 3) Aliasing -- lifetimes span first..last use in execution order;
+// a transient takes over a physical texture of the same description
+// whose previous owner's lifetime has ended
+// ------------------------------------------------------------
+void FrameGraph::AssignPhysicalTextures()
+{
+	for (uint32_t position = 0; position < (uint32_t)m_Order.size(); position++)
+	{
+		const PassNode& pass = m_Passes[m_Order[position]];
+
+		for (const auto* list : { &pass.Reads, &pass.Writes })
+		{
+			for (FrameGraphResource resource : *list)
+			{
+				ResourceNode& node = m_Resources[resource];
+				node.FirstUse = std::min(node.FirstUse, position);
+				node.LastUse = std::max(node.LastUse, position);
+			}
+		}
+	}
+
+	std::vector<FrameGraphResource> transients;
+	for (uint32_t i = 0; i < (uint32_t)m_Resources.size(); i++)
+	{
+		if (!m_Resources[i].Imported && m_Resources[i].FirstUse != UINT32_MAX)
+			transients.push_back(i);
+	}
+
+	std::stable_sort(transients.begin(), transients.end(), [this](FrameGraphResource a, FrameGraphResource b)
+	{
+		return m_Resources[a].FirstUse < m_Resources[b].FirstUse;
+	});
+
+	m_Physical.clear();
+	for (FrameGraphResource resource : transients)
+	{
+		ResourceNode& node = m_Resources[resource];
+
+		for (size_t i = 0; i < m_Physical.size(); i++)
+		{
+			PhysicalTexture& physical = m_Physical[i];
+			if (physical.Desc == node.Desc && physical.FreeAfter < node.FirstUse)
+			{
+				node.Physical = (int32_t)i;
+				physical.FreeAfter = node.LastUse;
+				break;
+			}
+		}
+
+		if (node.Physical < 0)
+		{
+			node.Physical = (int32_t)m_Physical.size();
+			m_Physical.push_back({ node.Desc, node.LastUse });
+		}
+
+		m_Stats.TransientTextures++;
+		m_Stats.TransientBytes += RenderTargetPool::GetTargetBytes(node.Desc.Format, node.Desc.Width, node.Desc.Height);
+	}
+
+	m_Stats.PhysicalTextures = (uint32_t)m_Physical.size();
+	for (const PhysicalTexture& physical : m_Physical)
+		m_Stats.PeakTransientBytes += RenderTargetPool::GetTargetBytes(physical.Desc.Format, physical.Desc.Width, physical.Desc.Height);
+}
+
+// ------------------------------------------------------------
+// FBO over a pass's transient outputs
+// ------------------------------------------------------------
+unsigned int FrameGraph::GetPassFramebuffer(const PassNode& pass)
+{
+	std::vector<unsigned int> colors;
+	unsigned int depth = 0;
+	FramebufferTextureFormat depthFormat = FramebufferTextureFormat::None;
+
+	for (FrameGraphResource resource : pass.Writes)
+	{
+		const ResourceNode& node = m_Resources[resource];
+		if (node.Imported)
+			return 0;
+
+		unsigned int texture = m_Physical[node.Physical].TextureID;
+		if (RenderTargetPool::IsDepthFormat(node.Desc.Format))
+		{
+			depth = texture;
+			depthFormat = node.Desc.Format;
+		}
+		else
+		{
+			colors.push_back(texture);
+		}
+	}
+
+	std::vector<unsigned int> key = colors;
+	key.push_back(depth);
+
+	auto it = m_Framebuffers.find(key);
+	if (it != m_Framebuffers.end())
+	{
+		it->second.LastUsedFrame = m_Frame;
+		return it->second.ID;
+	}
+
+	GLuint fbo = 0;
+	glGenFramebuffers(1, &fbo);
+	GLState::BindFramebuffer(fbo);
+
+	std::vector<GLenum> drawBuffers;
+	for (size_t i = 0; i < colors.size(); i++)
+	{
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + (GLenum)i, GL_TEXTURE_2D, colors[i], 0);
+		drawBuffers.push_back(GL_COLOR_ATTACHMENT0 + (GLenum)i);
+	}
+
+	if (drawBuffers.empty())
+	{
+		glDrawBuffer(GL_NONE);
+		glReadBuffer(GL_NONE);
+	}
+	else
+	{
+		glDrawBuffers((GLsizei)drawBuffers.size(), drawBuffers.data());
+	}
+
+	if (depth)
+	{
+		GLenum attachment = depthFormat == FramebufferTextureFormat::Depth24Stencil8 ?
+			GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+		glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, depth, 0);
+	}
+
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		Log::Error("FrameGraph: framebuffer for pass '" + pass.Name + "' is incomplete");
+
+	m_Framebuffers[key] = { fbo, m_Frame };
+	return fbo;
+}
+
+// ------------------------------------------------------------
+// Execute
+// ------------------------------------------------------------
+void FrameGraph::Execute()
+{
+	if (!m_Compiled)
+		Compile();
+
+	for (PhysicalTexture& physical : m_Physical)
+		physical.TextureID = m_Pool.Acquire(physical.Desc.Format, physical.Desc.Width, physical.Desc.Height);
+
+	for (uint32_t index : m_Order)
+	{
+		PassNode& pass = m_Passes[index];
+		pass.FramebufferID = GetPassFramebuffer(pass);
+
+		FrameGraphResources resources(*this, index);
+		pass.Execute(resources);
+	}
+
+	// Textures go back to the pool; next frame usually gets the same ones
+	for (PhysicalTexture& physical : m_Physical)
+	{
+		m_Pool.Release(physical.TextureID);
+		physical.TextureID = 0;
+	}
+
+	// FBOs not used this frame may reference textures the pool deletes later
+	for (auto it = m_Framebuffers.begin(); it != m_Framebuffers.end();)
+	{
+		if (it->second.LastUsedFrame != m_Frame)
+		{
+			GLState::OnFramebufferDeleted(it->second.ID);
+			glDeleteFramebuffers(1, &it->second.ID);
+			it = m_Framebuffers.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	m_Frame++;
+}
+
+std::vector<std::string> FrameGraph::GetExecutionOrder() const
+{
+	std::vector<std::string> names;
+	for (uint32_t index : m_Order)
+		names.push_back(m_Passes[index].Name);
+	return names;
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Graphics/Framebuffer.h"
+
+class RenderTargetPool;
+
+// -----------------------------------------------------------------------------
+// FrameGraph -- per-frame list of render passes and the textures they use.
+// Each frame: Reset(), AddPass() for every pass (the setup callback runs
+// immediately and declares reads / writes), Compile(), Execute().
+//
+// Compile() culls passes whose outputs nobody reads (unless they write an
+// imported resource or are marked as side effects), orders the remaining
+// passes so producers run before consumers, and assigns transient textures
+// with non-overlapping lifetimes and matching descriptions to the same
+// physical texture. Physical textures are borrowed from the RenderTargetPool
+// for the duration of Execute().
+// -----------------------------------------------------------------------------
+
+using FrameGraphResource = uint32_t;
+static constexpr FrameGraphResource InvalidFrameGraphResource = UINT32_MAX;
+
+struct FrameGraphTextureDesc
+{
+	FramebufferTextureFormat Format = FramebufferTextureFormat::RGBA8;
+	int Width = 0;
+	int Height = 0;
+
+	bool operator==(const FrameGraphTextureDesc& other) const
+	{
+		return Format == other.Format && Width == other.Width && Height == other.Height;
+	}
+};
+
+class FrameGraph;
+
+// Handed to a pass's setup callback
+class FrameGraphBuilder
+{
+public:
+	// New transient texture, written by this pass
+	FrameGraphResource Create(const std::string& name, const FrameGraphTextureDesc& desc);
+
+	FrameGraphResource Read(FrameGraphResource resource);
+	FrameGraphResource Write(FrameGraphResource resource);
+
+	// Keep the pass even if nothing reads what it writes
+	void SetSideEffect();
+
+private:
+	friend class FrameGraph;
+	FrameGraphBuilder(FrameGraph& graph, uint32_t pass) : m_Graph(graph), m_Pass(pass) {}
+
+	FrameGraph& m_Graph;
+	uint32_t    m_Pass;
+};
+
+// Handed to a pass's execute callback
+class FrameGraphResources
+{
+public:
+	// GL texture backing a resource the pass declared (imported: color attachment 0)
+	unsigned int GetTexture(FrameGraphResource resource) const;
+	const FrameGraphTextureDesc& GetDesc(FrameGraphResource resource) const;
+
+	// Bind the pass's render target: the imported framebuffer it writes, or
+	// an FBO over its written transient textures (colors in Write() order)
+	void BindRenderTarget() const;
+
+private:
+	friend class FrameGraph;
+	FrameGraphResources(const FrameGraph& graph, uint32_t pass) : m_Graph(graph), m_Pass(pass) {}
+
+	const FrameGraph& m_Graph;
+	uint32_t          m_Pass;
+};
+
+class FrameGraph
+{
+public:
+	using SetupFunc = std::function<void(FrameGraphBuilder&)>;
+	using ExecuteFunc = std::function<void(const FrameGraphResources&)>;
+
+	struct Stats
+	{
+		uint32_t Passes = 0;
+		uint32_t CulledPasses = 0;
+		uint32_t TransientTextures = 0;   // declared by live passes
+		uint32_t PhysicalTextures = 0;    // after aliasing
+		size_t   TransientBytes = 0;      // what the declared textures would need on their own
+		size_t   PeakTransientBytes = 0;  // what is actually allocated (aliased)
+	};
+
+	explicit FrameGraph(RenderTargetPool& pool);
+	~FrameGraph();
+
+	FrameGraph(const FrameGraph&) = delete;
+	FrameGraph& operator=(const FrameGraph&) = delete;
+
+	// Drop last frame's passes and resources (cached FBOs are kept)
+	void Reset();
+
+	// External framebuffer; passes writing it are never culled
+	FrameGraphResource ImportFramebuffer(const std::string& name, Framebuffer* framebuffer);
+
+	void AddPass(const std::string& name, const SetupFunc& setup, const ExecuteFunc& execute);
+
+	void Compile();
+	void Execute();
+
+	const Stats& GetStats() const { return m_Stats; }
+
+	// Names of the live passes in execution order (valid after Compile)
+	std::vector<std::string> GetExecutionOrder() const;
+
+private:
+	friend class FrameGraphBuilder;
+	friend class FrameGraphResources;
+
+	struct ResourceNode
+	{
+		std::string           Name;
+		FrameGraphTextureDesc Desc;
+		Framebuffer*          Imported = nullptr;
+		std::vector<uint32_t> Writers;      // pass indices, in declaration order
+		uint32_t              RefCount = 0; // live readers
+		uint32_t              FirstUse = UINT32_MAX;   // execution positions
+		uint32_t              LastUse = 0;
+		int32_t               Physical = -1;
+	};
+
+	struct PassNode
+	{
+		std::string                     Name;
+		ExecuteFunc                     Execute;
+		std::vector<FrameGraphResource> Reads;
+		std::vector<FrameGraphResource> Writes;
+		bool                            SideEffect = false;
+		uint32_t                        RefCount = 0;   // written resources still needed
+		bool                            Culled = false;
+		unsigned int                    FramebufferID = 0;
+	};
+
+	struct PhysicalTexture
+	{
+		FrameGraphTextureDesc Desc;
+		uint32_t              FreeAfter;   // last execution position using it
+		unsigned int          TextureID = 0;
+	};
+
+	struct CachedFramebuffer
+	{
+		unsigned int ID;
+		uint64_t     LastUsedFrame;
+	};
+
+	void CullPasses();
+	void OrderPasses();
+	void AssignPhysicalTextures();
+	unsigned int GetPassFramebuffer(const PassNode& pass);
+
+private:
+	RenderTargetPool& m_Pool;
+
+	std::vector<ResourceNode>    m_Resources;
+	std::vector<PassNode>        m_Passes;
+	std::vector<uint32_t>        m_Order;   // live pass indices in execution order
+	std::vector<PhysicalTexture> m_Physical;
+	bool                         m_Compiled = false;
+
+	// FBOs over transient attachment sets, keyed by the attached texture
+	// names (stable while the pool keeps handing back the same textures)
+	std::map<std::vector<unsigned int>, CachedFramebuffer> m_Framebuffers;
+	uint64_t                                               m_Frame = 0;
+
+	Stats m_Stats;
+};
@@ -1,8 +1,24 @@
 #include "Framebuffer.h"
+#include "Graphics/GLState.h"
+#include "Graphics/RenderTargetPool.h"
 #include "Utils/Log.h"
 
 #include <glad/glad.h>
 
+namespace
+{
+	GLenum GetDepthAttachmentPoint(FramebufferTextureFormat format)
+	{
+		return format == FramebufferTextureFormat::Depth24Stencil8 ?
+			GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+	}
+
+	int RoundUpToGranularity(int size)
+	{
+		return (size + Framebuffer::SizeGranularity - 1) / Framebuffer::SizeGranularity * Framebuffer::SizeGranularity;
+	}
+}
+
 // ------------------------------------------------------------
 // Default constructor (no GPU resource yet)
 // ------------------------------------------------------------
@@ -14,24 +30,57 @@ Framebuffer::Framebuffer()
 // Construct + initialize
 // ------------------------------------------------------------
 Framebuffer::Framebuffer(int width, int height)
-	: m_Width(width), m_Height(height)
 {
 	Initialize(width, height);
 }
 
+Framebuffer::Framebuffer(const FramebufferSpecification& spec)
+	: m_Spec(spec)
+{
+	Invalidate();
+}
+
 // ------------------------------------------------------------
 // Destructor  cleanup GPU resources
 // ------------------------------------------------------------
 Framebuffer::~Framebuffer()
 {
-	if (m_ColorAttachment)
-		glDeleteTextures(1, &m_ColorAttachment);
+	Release();
+}
 
-	if (m_DepthRBO)
-		glDeleteRenderbuffers(1, &m_DepthRBO);
+void Framebuffer::Release()
+{
+	ReleaseAttachments();
 
+	GLState::OnFramebufferDeleted(m_FBO);
 	if (m_FBO)
 		glDeleteFramebuffers(1, &m_FBO);
+	m_FBO = 0;
+}
+
+// Hand the attachments back to the pool (or delete them without one)
+void Framebuffer::ReleaseAttachments()
+{
+	RenderTargetPool* pool = m_Spec.Pool;
+
+	auto release = [pool](GLuint& id, bool renderbuffer)
+	{
+		if (id == 0)
+			return;
+
+		if (pool)
+			pool->Release(id, renderbuffer);
+		else
+			RenderTargetPool::DeleteTarget(id, renderbuffer);
+		id = 0;
+	};
+
+	for (GLuint& texture : m_ColorAttachments)
+		release(texture, false);
+	m_ColorAttachments.clear();
+
+	release(m_DepthAttachment, false);
+	release(m_DepthRBO, true);
 }
 
 // ------------------------------------------------------------
@@ -39,27 +88,45 @@ Framebuffer::~Framebuffer()
 // ------------------------------------------------------------
 void Framebuffer::Initialize(int width, int height)
 {
-	m_Width = width;
-	m_Height = height;
+	m_Spec.Width = width;
+	m_Spec.Height = height;
 
 	Invalidate();
 }
 
 // ------------------------------------------------------------
-// Resize framebuffer (called when Viewport size changes)
+// Resize framebuffer (called when Viewport size changes).
+// Within the allocated storage this only changes the rendered
+// size -- no GL calls, so dragging the viewport edge is free.
 // ------------------------------------------------------------
 void Framebuffer::Resize(int width, int height)
 {
-	if (width == 0 || height == 0)
+	if (width <= 0 || height <= 0)
 		return;
 
-	if (width == m_Width && height == m_Height)
+	if (width == m_Spec.Width && height == m_Spec.Height)
 		return;
 
-	m_Width = width;
-	m_Height = height;
+	m_Spec.Width = width;
+	m_Spec.Height = height;
 
-	Invalidate();
+	if (NeedsReallocation())
+		Invalidate();
+}
+
+// Grow as soon as the storage is too small; shrink only once the
+// rounded size would free more than half of it (hysteresis)
+bool Framebuffer::NeedsReallocation() const
+{
+	if (m_FBO == 0)
+		return true;
+
+	if (m_Spec.Width > m_AllocatedWidth || m_Spec.Height > m_AllocatedHeight)
+		return true;
+
+	size_t needed = (size_t)RoundUpToGranularity(m_Spec.Width) * (size_t)RoundUpToGranularity(m_Spec.Height);
+	size_t allocated = (size_t)m_AllocatedWidth * (size_t)m_AllocatedHeight;
+	return needed * 2 < allocated;
 }
 
 // ------------------------------------------------------------
@@ -67,7 +134,7 @@ void Framebuffer::Resize(int width, int height)
 // ------------------------------------------------------------
 void Framebuffer::Bind()
 {
-	glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
+	GLState::BindFramebuffer(m_FBO);
 }
 
 // ------------------------------------------------------------
@@ -75,7 +142,7 @@ void Framebuffer::Bind()
 // ------------------------------------------------------------
 void Framebuffer::Unbind()
 {
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLState::BindFramebuffer(0);
 }
 
 // ------------------------------------------------------------
@@ -83,64 +150,69 @@ void Framebuffer::Unbind()
 // ------------------------------------------------------------
 void Framebuffer::Invalidate()
 {
-	// Delete previous attachments if any
-	if (m_FBO)
-		glDeleteFramebuffers(1, &m_FBO);
-	if (m_ColorAttachment)
-		glDeleteTextures(1, &m_ColorAttachment);
-	if (m_DepthRBO)
-		glDeleteRenderbuffers(1, &m_DepthRBO);
+	// Previous attachments go back to the pool
+	ReleaseAttachments();
+
+	m_AllocatedWidth = RoundUpToGranularity(m_Spec.Width);
+	m_AllocatedHeight = RoundUpToGranularity(m_Spec.Height);
+
+	auto acquire = [this](FramebufferTextureFormat format, bool renderbuffer) -> GLuint
+	{
+		if (m_Spec.Pool)
+			return m_Spec.Pool->Acquire(format, m_AllocatedWidth, m_AllocatedHeight, renderbuffer);
+		return RenderTargetPool::CreateTarget(format, m_AllocatedWidth, m_AllocatedHeight, renderbuffer);
+	};
 
 	// --------------------------------------------------------
-	// Generate new FBO
+	// FBO object survives reallocation
 	// --------------------------------------------------------
-	glGenFramebuffers(1, &m_FBO);
-	glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
+	if (!m_FBO)
+		glGenFramebuffers(1, &m_FBO);
+	GLState::BindFramebuffer(m_FBO);
 
 	// --------------------------------------------------------
-	// Create Color Texture Attachment
+	// Color Texture Attachments
 	// --------------------------------------------------------
-	glGenTextures(1, &m_ColorAttachment);
-	glBindTexture(GL_TEXTURE_2D, m_ColorAttachment);
-	glTexImage2D(
-		GL_TEXTURE_2D,
-		0,
-		GL_RGBA8,
-		m_Width, m_Height,
-		0,
-		GL_RGBA,
-		GL_UNSIGNED_BYTE,
-		nullptr
-	);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-	glFramebufferTexture2D(
-		GL_FRAMEBUFFER,
-		GL_COLOR_ATTACHMENT0,
-		GL_TEXTURE_2D,
-		m_ColorAttachment,
-		0
-	);
+	std::vector<GLenum> drawBuffers;
+	for (size_t i = 0; i < m_Spec.ColorAttachments.size(); i++)
+	{
+		m_ColorAttachments.push_back(acquire(m_Spec.ColorAttachments[i], false));
+
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + (GLenum)i,
+			GL_TEXTURE_2D, m_ColorAttachments[i], 0);
+
+		drawBuffers.push_back(GL_COLOR_ATTACHMENT0 + (GLenum)i);
+	}
+
+	if (drawBuffers.empty())
+	{
+		// Depth-only target
+		glDrawBuffer(GL_NONE);
+		glReadBuffer(GL_NONE);
+	}
+	else
+	{
+		glDrawBuffers((GLsizei)drawBuffers.size(), drawBuffers.data());
+	}
 
 	// --------------------------------------------------------
-	// Create Depth + Stencil Renderbuffer
+	// Depth (+ Stencil) Texture or Renderbuffer
 	// --------------------------------------------------------
-	glGenRenderbuffers(1, &m_DepthRBO);
-	glBindRenderbuffer(GL_RENDERBUFFER, m_DepthRBO);
-	glRenderbufferStorage(
-		GL_RENDERBUFFER,
-		GL_DEPTH24_STENCIL8,
-		m_Width, m_Height
-	);
-
-	glFramebufferRenderbuffer(
-		GL_FRAMEBUFFER,
-		GL_DEPTH_STENCIL_ATTACHMENT,
-		GL_RENDERBUFFER,
-		m_DepthRBO
-	);
+	if (m_Spec.DepthAttachment != FramebufferTextureFormat::None)
+	{
+		GLenum attachment = GetDepthAttachmentPoint(m_Spec.DepthAttachment);
+
+		if (m_Spec.DepthAsTexture)
+		{
+			m_DepthAttachment = acquire(m_Spec.DepthAttachment, false);
+			glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, m_DepthAttachment, 0);
+		}
+		else
+		{
+			m_DepthRBO = acquire(m_Spec.DepthAttachment, true);
+			glFramebufferRenderbuffer(GL_FRAMEBUFFER, attachment, GL_RENDERBUFFER, m_DepthRBO);
+		}
+	}
 
 	// --------------------------------------------------------
 	// Check FBO completeness
@@ -151,13 +223,14 @@ void Framebuffer::Invalidate()
 	}
 	else
 	{
-		Log::Info("Framebuffer created: " +
-			std::to_string(m_Width) + "x" +
-			std::to_string(m_Height));
+		Log::Info("Framebuffer storage: " +
+			std::to_string(m_AllocatedWidth) + "x" +
+			std::to_string(m_AllocatedHeight) + ", " +
+			std::to_string(m_ColorAttachments.size()) + " color target(s)");
 	}
 
 	// --------------------------------------------------------
 	// Unbind  finished
 	// --------------------------------------------------------
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLState::BindFramebuffer(0);
 }
@@ -1,26 +1,73 @@
 #pragma once
 
 #include <glad/glad.h>
+#include <cstddef>
+#include <vector>
+
+class RenderTargetPool;
 
 // -----------------------------------------------------------------------------
 // Framebuffer (FBO)  Off-screen render target for the dockable Viewport
 // -----------------------------------------------------------------------------
 
+enum class FramebufferTextureFormat
+{
+	None = 0,
+
+	// Color
+	RGBA8,
+	RGBA16F,
+	RGB10A2,
+	R32F,
+
+	// Depth
+	Depth24Stencil8,
+	Depth32F
+};
+
+struct FramebufferSpecification
+{
+	int Width = 0;
+	int Height = 0;
+
+	// One texture per entry, attached to GL_COLOR_ATTACHMENT0 + index
+	std::vector<FramebufferTextureFormat> ColorAttachments = { FramebufferTextureFormat::RGBA8 };
+
+	// None = no depth; sampled as a texture when DepthAsTexture is set,
+	// otherwise stored in a renderbuffer
+	FramebufferTextureFormat DepthAttachment = FramebufferTextureFormat::Depth24Stencil8;
+	bool DepthAsTexture = false;
+
+	// Attachments are borrowed from / returned to this pool when set
+	RenderTargetPool* Pool = nullptr;
+};
+
+// -----------------------------------------------------------------------------
+// Width/Height are the rendered size. Storage is allocated in SizeGranularity
+// steps and only reallocated when the rendered size outgrows it, or shrinks
+// to less than half of it; in between, rendering uses the lower-left
+// sub-rectangle (see GetUVScaleX/Y()).
+// -----------------------------------------------------------------------------
 class Framebuffer
 {
 public:
+	static constexpr int SizeGranularity = 128;
+
 	// Default constructor (no allocation)
 	Framebuffer();
 
-	// Construct and immediately allocate GPU storage
+	// Construct and immediately allocate GPU storage (one RGBA8 target + depth/stencil)
 	Framebuffer(int width, int height);
 
+	// Construct from an attachment specification
+	explicit Framebuffer(const FramebufferSpecification& spec);
+
 	~Framebuffer();
 
 	// Initialize or reinitialize render targets
 	void Initialize(int width, int height);
 
-	// Resize when viewport size changes
+	// Resize when viewport size changes (cheap unless storage must change)
 	void Resize(int width, int height);
 
 	// Bind / unbind framebuffer
@@ -28,20 +75,41 @@ public:
 	void Unbind();
 
 	// Access color texture for ImGui::Image
-	GLuint GetColorAttachmentID() const { return m_ColorAttachment; }
+	GLuint GetColorAttachmentID(size_t index = 0) const { return m_ColorAttachments[index]; }
+	size_t GetColorAttachmentCount() const { return m_ColorAttachments.size(); }
+
+	// Depth texture (0 when depth lives in a renderbuffer)
+	GLuint GetDepthAttachmentID() const { return m_DepthAttachment; }
+
+	GLuint GetRendererID() const { return m_FBO; }
+	const FramebufferSpecification& GetSpecification() const { return m_Spec; }
 
-	int GetWidth()  const { return m_Width; }
-	int GetHeight() const { return m_Height; }
+	int GetWidth()  const { return m_Spec.Width; }
+	int GetHeight() const { return m_Spec.Height; }
+
+	// Size of the attachments (>= GetWidth() / GetHeight())
+	int GetAllocatedWidth()  const { return m_AllocatedWidth; }
+	int GetAllocatedHeight() const { return m_AllocatedHeight; }
+
+	// Texture coordinate of the rendered region's far corner
+	float GetUVScaleX() const { return m_AllocatedWidth  > 0 ? (float)m_Spec.Width  / m_AllocatedWidth  : 1.0f; }
+	float GetUVScaleY() const { return m_AllocatedHeight > 0 ? (float)m_Spec.Height / m_AllocatedHeight : 1.0f; }
 
 private:
-	// Destroy + recreate FBO & attachments
+	// Reallocate attachments for the current size (FBO object is kept)
 	void Invalidate();
+	bool NeedsReallocation() const;
+	void ReleaseAttachments();
+	void Release();
 
 private:
-	GLuint m_FBO = 0;
-	GLuint m_ColorAttachment = 0;
-	GLuint m_DepthRBO = 0;
+	FramebufferSpecification m_Spec;
 
-	int m_Width = 0;
-	int m_Height = 0;
+	int m_AllocatedWidth = 0;
+	int m_AllocatedHeight = 0;
+
+	GLuint m_FBO = 0;
+	std::vector<GLuint> m_ColorAttachments;
+	GLuint m_DepthAttachment = 0;   // depth texture
+	GLuint m_DepthRBO = 0;          // or depth renderbuffer
 };
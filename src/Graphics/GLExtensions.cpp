@@ -0,0 +1,66 @@
+#include "GLExtensions.h"
+#include "Utils/Log.h"
+
+#include <cstring>
+
+PFNGLGETPROGRAMBINARYPROC  GLExtensions::GetProgramBinary = nullptr;
+PFNGLPROGRAMBINARYPROC     GLExtensions::ProgramBinary = nullptr;
+PFNGLPROGRAMPARAMETERIPROC GLExtensions::ProgramParameteri = nullptr;
+PFNGLMULTIDRAWELEMENTSINDIRECTPROC GLExtensions::MultiDrawElementsIndirect = nullptr;
+
+bool GLExtensions::s_ProgramBinary = false;
+bool GLExtensions::s_MultiDrawIndirect = false;
+
+// ------------------------------------------------------------
+// Supported through the core version or the extension string
+// ------------------------------------------------------------
+bool GLExtensions::IsSupported(const char* extension, int major, int minor)
+{
+	int ctxMajor = 0;
+	int ctxMinor = 0;
+	glGetIntegerv(GL_MAJOR_VERSION, &ctxMajor);
+	glGetIntegerv(GL_MINOR_VERSION, &ctxMinor);
+
+	if (ctxMajor > major || (ctxMajor == major && ctxMinor >= minor))
+		return true;
+
+	int count = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+	for (int i = 0; i < count; i++)
+	{
+		const char* name = (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+		if (name && std::strcmp(name, extension) == 0)
+			return true;
+	}
+	return false;
+}
+
+// ------------------------------------------------------------
+// Resolve entry points and availability flags
+// ------------------------------------------------------------
+void GLExtensions::Load(LoadProc loader)
+{
+	if (IsSupported("GL_ARB_get_program_binary", 4, 1))
+	{
+		GetProgramBinary = (PFNGLGETPROGRAMBINARYPROC)loader("glGetProgramBinary");
+		ProgramBinary = (PFNGLPROGRAMBINARYPROC)loader("glProgramBinary");
+		ProgramParameteri = (PFNGLPROGRAMPARAMETERIPROC)loader("glProgramParameteri");
+
+		// A driver may expose the API but accept no binary formats at all
+		int formats = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+
+		s_ProgramBinary = GetProgramBinary && ProgramBinary && ProgramParameteri && formats > 0;
+	}
+
+	Log::Info(std::string("Program binary cache: ") + (s_ProgramBinary ? "available" : "unavailable"));
+
+	// Instanced batches address their instance range through baseInstance
+	if (IsSupported("GL_ARB_multi_draw_indirect", 4, 3) && IsSupported("GL_ARB_base_instance", 4, 2))
+	{
+		MultiDrawElementsIndirect = (PFNGLMULTIDRAWELEMENTSINDIRECTPROC)loader("glMultiDrawElementsIndirect");
+		s_MultiDrawIndirect = MultiDrawElementsIndirect != nullptr;
+	}
+
+	Log::Info(std::string("Multi-draw indirect: ") + (s_MultiDrawIndirect ? "available" : "unavailable"));
+}
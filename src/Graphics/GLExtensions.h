@@ -0,0 +1,52 @@
+#pragma once
+
+#include <glad/glad.h>
+
+// -----------------------------------------------------------------------------
+// GLExtensions -- entry points beyond the GL 3.3 core profile glad was
+// generated for. Loaded once after context creation; every feature has an
+// availability flag and callers must fall back when it is false.
+// -----------------------------------------------------------------------------
+
+// ARB_get_program_binary (core in 4.1)
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH           0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS      0x87FE
+
+typedef void (APIENTRYP PFNGLGETPROGRAMBINARYPROC)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+typedef void (APIENTRYP PFNGLPROGRAMBINARYPROC)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+typedef void (APIENTRYP PFNGLPROGRAMPARAMETERIPROC)(GLuint program, GLenum pname, GLint value);
+
+// ARB_multi_draw_indirect + ARB_base_instance (core in 4.3 / 4.2)
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+
+typedef void (APIENTRYP PFNGLMULTIDRAWELEMENTSINDIRECTPROC)(GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride);
+
+class GLExtensions
+{
+public:
+	typedef void* (*LoadProc)(const char* name);
+
+	// Resolve optional entry points (call after gladLoadGLLoader)
+	static void Load(LoadProc loader);
+
+	static bool HasProgramBinary() { return s_ProgramBinary; }
+	static bool HasMultiDrawIndirect() { return s_MultiDrawIndirect; }
+
+	// Program binaries
+	static PFNGLGETPROGRAMBINARYPROC  GetProgramBinary;
+	static PFNGLPROGRAMBINARYPROC     ProgramBinary;
+	static PFNGLPROGRAMPARAMETERIPROC ProgramParameteri;
+
+	// Indirect draws (baseInstance is honoured)
+	static PFNGLMULTIDRAWELEMENTSINDIRECTPROC MultiDrawElementsIndirect;
+
+private:
+	GLExtensions() = delete;
+
+	static bool IsSupported(const char* extension, int major, int minor);
+
+private:
+	static bool s_ProgramBinary;
+	static bool s_MultiDrawIndirect;
+};
@@ -0,0 +1,224 @@
+#include "GLState.h"
+
+#include <glad/glad.h>
+
+namespace
+{
+	// Cache value meaning "unknown" -- never equal to a real GL value we set
+	constexpr unsigned int Unknown = 0xFFFFFFFFu;
+}
+
+unsigned int GLState::s_Program = Unknown;
+unsigned int GLState::s_VertexArray = Unknown;
+unsigned int GLState::s_Framebuffer = Unknown;
+unsigned int GLState::s_ActiveUnit = Unknown;
+unsigned int GLState::s_Textures[GLState::MaxTextureUnits] =
+{
+	Unknown, Unknown, Unknown, Unknown, Unknown, Unknown, Unknown, Unknown,
+	Unknown, Unknown, Unknown, Unknown, Unknown, Unknown, Unknown, Unknown
+};
+unsigned int GLState::s_TextureTargets[GLState::MaxTextureUnits] =
+{
+	Unknown, Unknown, Unknown, Unknown, Unknown, Unknown, Unknown, Unknown,
+	Unknown, Unknown, Unknown, Unknown, Unknown, Unknown, Unknown, Unknown
+};
+
+unsigned int GLState::s_DepthTest = Unknown;
+unsigned int GLState::s_DepthWrite = Unknown;
+unsigned int GLState::s_DepthFunc = Unknown;
+unsigned int GLState::s_ColorWrite = Unknown;
+unsigned int GLState::s_Blend = Unknown;
+unsigned int GLState::s_FaceCulling = Unknown;
+unsigned int GLState::s_CullFace = Unknown;
+unsigned int GLState::s_BlendSrc = Unknown;
+unsigned int GLState::s_BlendDst = Unknown;
+
+GLState::Counters GLState::s_Counters;
+
+bool GLState::Changed(unsigned int& cached, unsigned int value)
+{
+	if (cached == value)
+	{
+		s_Counters.Skipped++;
+		return false;
+	}
+
+	cached = value;
+	s_Counters.Issued++;
+	return true;
+}
+
+// ------------------------------------------------------------
+// Object bindings
+// ------------------------------------------------------------
+void GLState::UseProgram(unsigned int program)
+{
+	if (Changed(s_Program, program))
+		glUseProgram(program);
+}
+
+void GLState::BindVertexArray(unsigned int vao)
+{
+	if (Changed(s_VertexArray, vao))
+		glBindVertexArray(vao);
+}
+
+void GLState::BindTexture(unsigned int unit, unsigned int target, unsigned int texture)
+{
+	if (unit >= MaxTextureUnits)
+	{
+		glActiveTexture(GL_TEXTURE0 + unit);
+		glBindTexture(target, texture);
+		s_ActiveUnit = unit;
+		s_Counters.Issued++;
+		return;
+	}
+
+	if (s_Textures[unit] == texture && s_TextureTargets[unit] == target)
+	{
+		s_Counters.Skipped++;
+		return;
+	}
+
+	if (s_ActiveUnit != unit)
+	{
+		glActiveTexture(GL_TEXTURE0 + unit);
+		s_ActiveUnit = unit;
+	}
+
+	glBindTexture(target, texture);
+	s_Textures[unit] = texture;
+	s_TextureTargets[unit] = target;
+	s_Counters.Issued++;
+}
+
+void GLState::BindFramebuffer(unsigned int framebuffer)
+{
+	if (Changed(s_Framebuffer, framebuffer))
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+}
+
+// ------------------------------------------------------------
+// Fixed-function state
+// ------------------------------------------------------------
+void GLState::SetDepthTest(bool enabled)
+{
+	if (Changed(s_DepthTest, enabled ? 1u : 0u))
+	{
+		if (enabled) glEnable(GL_DEPTH_TEST);
+		else         glDisable(GL_DEPTH_TEST);
+	}
+}
+
+void GLState::SetDepthWrite(bool enabled)
+{
+	if (Changed(s_DepthWrite, enabled ? 1u : 0u))
+		glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+}
+
+void GLState::SetDepthFunc(unsigned int func)
+{
+	if (Changed(s_DepthFunc, func))
+		glDepthFunc(func);
+}
+
+void GLState::SetColorWrite(bool enabled)
+{
+	if (Changed(s_ColorWrite, enabled ? 1u : 0u))
+	{
+		GLboolean mask = enabled ? GL_TRUE : GL_FALSE;
+		glColorMask(mask, mask, mask, mask);
+	}
+}
+
+void GLState::SetBlend(bool enabled)
+{
+	if (Changed(s_Blend, enabled ? 1u : 0u))
+	{
+		if (enabled) glEnable(GL_BLEND);
+		else         glDisable(GL_BLEND);
+	}
+}
+
+void GLState::SetBlendFunc(unsigned int src, unsigned int dst)
+{
+	if (s_BlendSrc == src && s_BlendDst == dst)
+	{
+		s_Counters.Skipped++;
+		return;
+	}
+
+	glBlendFunc(src, dst);
+	s_BlendSrc = src;
+	s_BlendDst = dst;
+	s_Counters.Issued++;
+}
+
+void GLState::SetFaceCulling(bool enabled)
+{
+	if (Changed(s_FaceCulling, enabled ? 1u : 0u))
+	{
+		if (enabled) glEnable(GL_CULL_FACE);
+		else         glDisable(GL_CULL_FACE);
+	}
+}
+
+void GLState::SetCullFace(unsigned int face)
+{
+	if (Changed(s_CullFace, face))
+		glCullFace(face);
+}
+
+// ------------------------------------------------------------
+// Cache maintenance
+// ------------------------------------------------------------
+void GLState::Invalidate()
+{
+	s_Program = Unknown;
+	s_VertexArray = Unknown;
+	s_Framebuffer = Unknown;
+	s_ActiveUnit = Unknown;
+
+	for (unsigned int i = 0; i < MaxTextureUnits; i++)
+	{
+		s_Textures[i] = Unknown;
+		s_TextureTargets[i] = Unknown;
+	}
+
+	s_DepthTest = Unknown;
+	s_DepthWrite = Unknown;
+	s_DepthFunc = Unknown;
+	s_ColorWrite = Unknown;
+	s_Blend = Unknown;
+	s_BlendSrc = Unknown;
+	s_BlendDst = Unknown;
+	s_FaceCulling = Unknown;
+	s_CullFace = Unknown;
+}
+
+void GLState::OnProgramDeleted(unsigned int program)
+{
+	if (s_Program == program)
+		s_Program = Unknown;
+}
+
+void GLState::OnVertexArrayDeleted(unsigned int vao)
+{
+	if (s_VertexArray == vao)
+		s_VertexArray = Unknown;
+}
+
+void GLState::OnTextureDeleted(unsigned int texture)
+{
+	for (unsigned int i = 0; i < MaxTextureUnits; i++)
+	{
+		if (s_Textures[i] == texture)
+			s_Textures[i] = Unknown;
+	}
+}
+
+void GLState::OnFramebufferDeleted(unsigned int framebuffer)
+{
+	if (s_Framebuffer == framebuffer)
+		s_Framebuffer = Unknown;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+
+// -----------------------------------------------------------------------------
+// GLState -- shadow copy of the bind points we touch, so redundant GL calls
+// are filtered before they reach the driver. Every GL object class binds
+// through here; code outside our control (ImGui) must be followed by
+// Invalidate(), and deleted objects must be forgotten (names get reused).
+// -----------------------------------------------------------------------------
+
+class GLState
+{
+public:
+	static constexpr unsigned int MaxTextureUnits = 16;
+
+	struct Counters
+	{
+		uint32_t Issued = 0;    // calls forwarded to GL
+		uint32_t Skipped = 0;   // calls filtered as redundant
+	};
+
+	// Object bindings
+	static void UseProgram(unsigned int program);
+	static void BindVertexArray(unsigned int vao);
+	static void BindTexture(unsigned int unit, unsigned int target, unsigned int texture);
+	static void BindFramebuffer(unsigned int framebuffer);
+
+	// Fixed-function state
+	static void SetDepthTest(bool enabled);
+	static void SetDepthWrite(bool enabled);
+	static void SetDepthFunc(unsigned int func);
+	static void SetColorWrite(bool enabled);
+	static void SetBlend(bool enabled);
+	static void SetBlendFunc(unsigned int src, unsigned int dst);
+	static void SetFaceCulling(bool enabled);
+	static void SetCullFace(unsigned int face);
+
+	// Forget everything (next call of each kind is always issued)
+	static void Invalidate();
+
+	// Drop cached references to deleted objects
+	static void OnProgramDeleted(unsigned int program);
+	static void OnVertexArrayDeleted(unsigned int vao);
+	static void OnTextureDeleted(unsigned int texture);
+	static void OnFramebufferDeleted(unsigned int framebuffer);
+
+	static const Counters& GetCounters() { return s_Counters; }
+	static void ResetCounters() { s_Counters = Counters(); }
+
+private:
+	GLState() = delete;
+
+	// Returns true (and counts) when the new value differs from the cache
+	static bool Changed(unsigned int& cached, unsigned int value);
+
+private:
+	static unsigned int s_Program;
+	static unsigned int s_VertexArray;
+	static unsigned int s_Framebuffer;
+	static unsigned int s_ActiveUnit;
+	static unsigned int s_Textures[MaxTextureUnits];
+	static unsigned int s_TextureTargets[MaxTextureUnits];
+
+	static unsigned int s_DepthTest;
+	static unsigned int s_DepthWrite;
+	static unsigned int s_DepthFunc;
+	static unsigned int s_ColorWrite;
+	static unsigned int s_Blend;
+	static unsigned int s_BlendSrc;
+	static unsigned int s_BlendDst;
+	static unsigned int s_FaceCulling;
+	static unsigned int s_CullFace;
+
+	static Counters s_Counters;
+};
@@ -0,0 +1,60 @@
+#include "GPUTimer.h"
+
+#include <glad/glad.h>
+
+GPUTimer::GPUTimer()
+{
+	glGenQueries(QueryCount, m_Queries);
+}
+
+GPUTimer::~GPUTimer()
+{
+	glDeleteQueries(QueryCount, m_Queries);
+}
+
+void GPUTimer::Begin()
+{
+	// Ring full: the oldest result is dropped rather than waited for
+	if (m_Pending[m_Next])
+	{
+		m_Pending[m_Next] = false;
+		m_Oldest = (m_Next + 1) % QueryCount;
+	}
+
+	glBeginQuery(GL_TIME_ELAPSED, m_Queries[m_Next]);
+}
+
+void GPUTimer::End()
+{
+	glEndQuery(GL_TIME_ELAPSED);
+
+	m_Pending[m_Next] = true;
+	m_Next = (m_Next + 1) % QueryCount;
+}
+
+// ------------------------------------------------------------
+// Results arrive in submission order -- stop at the first one
+// the GPU has not finished
+// ------------------------------------------------------------
+bool GPUTimer::Poll()
+{
+	bool updated = false;
+
+	while (m_Pending[m_Oldest])
+	{
+		GLint available = 0;
+		glGetQueryObjectiv(m_Queries[m_Oldest], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+			break;
+
+		GLuint64 elapsedNs = 0;
+		glGetQueryObjectui64v(m_Queries[m_Oldest], GL_QUERY_RESULT, &elapsedNs);
+
+		m_LastMs = (float)(elapsedNs / 1.0e6);
+		m_Pending[m_Oldest] = false;
+		m_Oldest = (m_Oldest + 1) % QueryCount;
+		updated = true;
+	}
+
+	return updated;
+}
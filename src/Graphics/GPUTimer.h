@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+// -----------------------------------------------------------------------------
+// GPUTimer -- GL_TIME_ELAPSED queries in a small ring. Results are read back
+// a few frames late, only once the driver reports them available, so timing
+// never stalls the pipeline. One Begin()/End() pair per frame.
+// -----------------------------------------------------------------------------
+class GPUTimer
+{
+public:
+	static constexpr uint32_t QueryCount = 4;   // frames in flight
+
+	GPUTimer();
+	~GPUTimer();
+
+	GPUTimer(const GPUTimer&) = delete;
+	GPUTimer& operator=(const GPUTimer&) = delete;
+
+	// Queries cannot nest -- don't wrap another GL_TIME_ELAPSED scope
+	void Begin();
+	void End();
+
+	// Collect finished queries; true when a new measurement arrived
+	bool Poll();
+
+	// Most recent finished measurement (milliseconds)
+	float GetLastMs() const { return m_LastMs; }
+
+private:
+	unsigned int m_Queries[QueryCount] = {};
+	bool         m_Pending[QueryCount] = {};
+	uint32_t     m_Next = 0;     // ring slot for the next Begin()
+	uint32_t     m_Oldest = 0;   // oldest slot that may be pending
+	float        m_LastMs = 0.0f;
+};
@@ -0,0 +1,250 @@
+#include "GeometryArena.h"
+#include "Graphics/GLState.h"
+#include "Graphics/Mesh.h"
+#include "Utils/Log.h"
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <string>
+
+std::vector<GeometryArena::Block> GeometryArena::s_Blocks;
+GeometryArena::Stats              GeometryArena::s_Stats;
+
+// ------------------------------------------------------------
+// Place the mesh in the first block with room for both ranges
+// ------------------------------------------------------------
+GeometryAllocation GeometryArena::Allocate(VertexFormat format, const void* vertices, uint32_t vertexCount,
+	const void* indices, uint32_t indexCount, uint32_t indexSize)
+{
+	GeometryAllocation allocation;
+	if (vertexCount == 0 || indexCount == 0)
+		return allocation;
+
+	for (uint32_t i = 0; i < (uint32_t)s_Blocks.size() && !allocation.IsValid(); i++)
+	{
+		Block& block = s_Blocks[i];
+		if (block.Format != format || block.IndexSize != indexSize)
+			continue;
+
+		if (!AllocateRange(block.FreeVertices, vertexCount, allocation.BaseVertex))
+			continue;
+
+		if (!AllocateRange(block.FreeIndices, indexCount, allocation.FirstIndex))
+		{
+			FreeRange(block.FreeVertices, allocation.BaseVertex, vertexCount);
+			continue;
+		}
+
+		allocation.Block = i;
+	}
+
+	if (!allocation.IsValid())
+	{
+		allocation.Block = CreateBlock(format, indexSize,
+			std::max(vertexCount, BlockVertices), std::max(indexCount, BlockIndices));
+
+		Block& block = s_Blocks[allocation.Block];
+		AllocateRange(block.FreeVertices, vertexCount, allocation.BaseVertex);
+		AllocateRange(block.FreeIndices, indexCount, allocation.FirstIndex);
+	}
+
+	allocation.VertexCount = vertexCount;
+	allocation.IndexCount = indexCount;
+	allocation.IndexSize = indexSize;
+
+	// Copy targets leave the bound VAO's element buffer alone
+	const Block& block = s_Blocks[allocation.Block];
+	const uint32_t stride = GetVertexStride(format);
+
+	glBindBuffer(GL_COPY_WRITE_BUFFER, block.VBO);
+	glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)allocation.BaseVertex * stride,
+		(GLsizeiptr)vertexCount * stride, vertices);
+
+	glBindBuffer(GL_COPY_WRITE_BUFFER, block.EBO);
+	glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)allocation.FirstIndex * indexSize,
+		(GLsizeiptr)indexCount * indexSize, indices);
+
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	s_Stats.Allocations++;
+	s_Stats.UsedBytes += (size_t)vertexCount * stride + (size_t)indexCount * indexSize;
+	return allocation;
+}
+
+void GeometryArena::Free(const GeometryAllocation& allocation)
+{
+	if (!allocation.IsValid() || allocation.Block >= s_Blocks.size())
+		return;
+
+	Block& block = s_Blocks[allocation.Block];
+	FreeRange(block.FreeVertices, allocation.BaseVertex, allocation.VertexCount);
+	FreeRange(block.FreeIndices, allocation.FirstIndex, allocation.IndexCount);
+
+	s_Stats.Allocations--;
+	s_Stats.UsedBytes -= (size_t)allocation.VertexCount * GetVertexStride(block.Format) +
+		(size_t)allocation.IndexCount * allocation.IndexSize;
+}
+
+unsigned int GeometryArena::GetVertexArray(uint32_t block)
+{
+	return block < s_Blocks.size() ? s_Blocks[block].VAO : 0;
+}
+
+uint32_t GeometryArena::GetVertexStride(VertexFormat format)
+{
+	switch (format)
+	{
+	case VertexFormat::Packed:          return sizeof(Mesh::PackedVertex);
+	case VertexFormat::PackedQuantized: return sizeof(Mesh::QuantizedVertex);
+	default:                            return sizeof(Mesh::Vertex);
+	}
+}
+
+void GeometryArena::Clear()
+{
+	for (Block& block : s_Blocks)
+	{
+		GLState::OnVertexArrayDeleted(block.VAO);
+		glDeleteVertexArrays(1, &block.VAO);
+		glDeleteBuffers(1, &block.VBO);
+		glDeleteBuffers(1, &block.EBO);
+	}
+	s_Blocks.clear();
+	s_Stats = Stats();
+}
+
+// ------------------------------------------------------------
+// Block = VBO + EBO + VAO decoding one vertex format
+// ------------------------------------------------------------
+uint32_t GeometryArena::CreateBlock(VertexFormat format, uint32_t indexSize,
+	uint32_t vertexCapacity, uint32_t indexCapacity)
+{
+	Block block;
+	block.Format = format;
+	block.IndexSize = indexSize;
+	block.VertexCapacity = vertexCapacity;
+	block.IndexCapacity = indexCapacity;
+	block.FreeVertices.push_back({ 0, vertexCapacity });
+	block.FreeIndices.push_back({ 0, indexCapacity });
+
+	const uint32_t stride = GetVertexStride(format);
+
+	glGenVertexArrays(1, &block.VAO);
+	glGenBuffers(1, &block.VBO);
+	glGenBuffers(1, &block.EBO);
+
+	GLState::BindVertexArray(block.VAO);
+
+	glBindBuffer(GL_ARRAY_BUFFER, block.VBO);
+	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)vertexCapacity * stride, nullptr, GL_STATIC_DRAW);
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, block.EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)indexCapacity * indexSize, nullptr, GL_STATIC_DRAW);
+
+	SetupAttributes(format);
+
+	GLState::BindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	s_Blocks.push_back(std::move(block));
+
+	s_Stats.Blocks++;
+	s_Stats.Bytes += (size_t)vertexCapacity * stride + (size_t)indexCapacity * indexSize;
+
+	Log::Info("Geometry arena block " + std::to_string(s_Blocks.size() - 1) + ": " +
+		std::to_string(vertexCapacity) + " vertices (" + std::to_string(stride) + " bytes), " +
+		std::to_string(indexCapacity) + " indices (" + std::to_string(indexSize * 8) + "-bit)");
+
+	return (uint32_t)s_Blocks.size() - 1;
+}
+
+// ------------------------------------------------------------
+// Packed snorm16 data is read as plain integers -- GL 3.3's
+// normalization maps 0 off zero -- and scaled in pbr.vert
+// (PACKED_VERTICES) or by the dequantization matrix
+// ------------------------------------------------------------
+void GeometryArena::GetVertexLayout(VertexFormat format, VertexAttribute (&layout)[VertexAttributeCount])
+{
+	switch (format)
+	{
+	case VertexFormat::Packed:
+		layout[0] = { 0, 3, GL_FLOAT, (uint32_t)offsetof(Mesh::PackedVertex, Position) };
+		layout[1] = { 1, 2, GL_SHORT, (uint32_t)offsetof(Mesh::PackedVertex, Normal) };
+		layout[2] = { 2, 2, GL_HALF_FLOAT, (uint32_t)offsetof(Mesh::PackedVertex, UV) };
+		layout[3] = { 3, 2, GL_SHORT, (uint32_t)offsetof(Mesh::PackedVertex, Tangent) };
+		break;
+	case VertexFormat::PackedQuantized:
+		layout[0] = { 0, 3, GL_SHORT, (uint32_t)offsetof(Mesh::QuantizedVertex, Position) };
+		layout[1] = { 1, 2, GL_SHORT, (uint32_t)offsetof(Mesh::QuantizedVertex, Normal) };
+		layout[2] = { 2, 2, GL_HALF_FLOAT, (uint32_t)offsetof(Mesh::QuantizedVertex, UV) };
+		layout[3] = { 3, 2, GL_SHORT, (uint32_t)offsetof(Mesh::QuantizedVertex, Tangent) };
+		break;
+	default:
+		layout[0] = { 0, 3, GL_FLOAT, (uint32_t)offsetof(Mesh::Vertex, Position) };
+		layout[1] = { 1, 3, GL_FLOAT, (uint32_t)offsetof(Mesh::Vertex, Normal) };
+		layout[2] = { 2, 2, GL_FLOAT, (uint32_t)offsetof(Mesh::Vertex, UV) };
+		layout[3] = { 3, 4, GL_FLOAT, (uint32_t)offsetof(Mesh::Vertex, Tangent) };
+		break;
+	}
+}
+
+void GeometryArena::SetupAttributes(VertexFormat format)
+{
+	VertexAttribute layout[VertexAttributeCount];
+	GetVertexLayout(format, layout);
+
+	const GLsizei stride = (GLsizei)GetVertexStride(format);
+	for (const VertexAttribute& attribute : layout)
+	{
+		glEnableVertexAttribArray(attribute.Location);
+		glVertexAttribPointer(attribute.Location, (GLint)attribute.Components, attribute.Type, GL_FALSE,
+			stride, (void*)(uintptr_t)attribute.Offset);
+	}
+}
+
+// ------------------------------------------------------------
+// First fit -- meshes are loaded once and rarely freed, so the
+// free lists stay short
+// ------------------------------------------------------------
+bool GeometryArena::AllocateRange(std::vector<Range>& freeList, uint32_t count, uint32_t& offset)
+{
+	for (size_t i = 0; i < freeList.size(); i++)
+	{
+		Range& range = freeList[i];
+		if (range.Count < count)
+			continue;
+
+		offset = range.Offset;
+		range.Offset += count;
+		range.Count -= count;
+		if (range.Count == 0)
+			freeList.erase(freeList.begin() + i);
+		return true;
+	}
+	return false;
+}
+
+// Insert in offset order and merge with the neighbours it touches
+void GeometryArena::FreeRange(std::vector<Range>& freeList, uint32_t offset, uint32_t count)
+{
+	auto it = std::lower_bound(freeList.begin(), freeList.end(), offset,
+		[](const Range& range, uint32_t value) { return range.Offset < value; });
+	it = freeList.insert(it, { offset, count });
+
+	auto next = it + 1;
+	if (next != freeList.end() && it->Offset + it->Count == next->Offset)
+	{
+		it->Count += next->Count;
+		freeList.erase(next);
+	}
+
+	if (it != freeList.begin())
+	{
+		auto prev = it - 1;
+		if (prev->Offset + prev->Count == it->Offset)
+		{
+			prev->Count += it->Count;
+			freeList.erase(it);
+		}
+	}
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Vertex layout of a mesh (see Mesh::Vertex / PackedVertex / QuantizedVertex)
+enum class VertexFormat : uint8_t
+{
+	Float,             // 48 bytes: float position, normal, UV, tangent + handedness
+	Packed,            // 24 bytes: float position, octahedral snorm16 normal/tangent, half UV
+	PackedQuantized    // 20 bytes: as Packed, snorm16 position dequantized by the model matrix
+};
+
+// One vertex attribute of a format, as passed to glVertexAttribPointer
+// (never normalized). Mesh files store the layout they were written with.
+struct VertexAttribute
+{
+	uint32_t Location;
+	uint32_t Components;
+	uint32_t Type;       // GL_FLOAT, GL_SHORT or GL_HALF_FLOAT
+	uint32_t Offset;     // bytes into the vertex
+};
+
+// Where a mesh lives inside the arena. Indices are stored relative to
+// BaseVertex, so draws pass it as the base vertex -- which is also what
+// lets any mesh of up to 65536 vertices use 16-bit indices.
+struct GeometryAllocation
+{
+	uint32_t Block = UINT32_MAX;
+	uint32_t BaseVertex = 0;
+	uint32_t VertexCount = 0;
+	uint32_t FirstIndex = 0;     // in indices of IndexSize bytes
+	uint32_t IndexCount = 0;
+	uint32_t IndexSize = 4;      // 2 or 4
+
+	bool IsValid() const { return Block != UINT32_MAX; }
+};
+
+// -----------------------------------------------------------------------------
+// GeometryArena -- every mesh is sub-allocated out of a few large blocks, each
+// one vertex buffer + one index buffer + one VAO. Meshes in the same block
+// draw without a VAO switch and can be submitted together by one multi-draw.
+// Ranges are first-fit from per-block free lists, merged again on Free().
+// Every block holds one VertexFormat and one index size; its VAO decodes
+// that layout, so a multi-draw over one block has a single index type.
+// -----------------------------------------------------------------------------
+class GeometryArena
+{
+public:
+	// Default block size; larger meshes get a block of their own
+	static constexpr uint32_t BlockVertices = 1u << 18;   // 12 MB of Mesh::Vertex, 5 MB quantized
+	static constexpr uint32_t BlockIndices = 1u << 20;    // 4 MB (2 MB of 16-bit)
+
+	struct Stats
+	{
+		uint32_t Blocks = 0;
+		uint32_t Allocations = 0;
+		size_t   UsedBytes = 0;      // vertex + index data of live meshes
+		size_t   Bytes = 0;          // storage of all blocks
+	};
+
+	// 'vertices' are laid out as GetVertexStride(format) bytes each,
+	// 'indices' as indexSize (2 or 4) bytes each
+	static GeometryAllocation Allocate(VertexFormat format, const void* vertices, uint32_t vertexCount,
+		const void* indices, uint32_t indexCount, uint32_t indexSize);
+
+	static void Free(const GeometryAllocation& allocation);
+
+	// Shared VAO of a block (vertex attributes 0..3, element buffer)
+	static unsigned int GetVertexArray(uint32_t block);
+
+	static uint32_t GetVertexStride(VertexFormat format);
+
+	// Attribute locations are the same for every format (0 position,
+	// 1 normal, 2 UV, 3 tangent); only types and offsets differ
+	static constexpr uint32_t VertexAttributeCount = 4;
+	static void GetVertexLayout(VertexFormat format, VertexAttribute (&layout)[VertexAttributeCount]);
+
+	static const Stats& GetStats() { return s_Stats; }
+
+	// Delete every block (shutdown; outstanding allocations become invalid)
+	static void Clear();
+
+private:
+	GeometryArena() = delete;
+
+	struct Range
+	{
+		uint32_t Offset;
+		uint32_t Count;
+	};
+
+	struct Block
+	{
+		unsigned int VAO = 0;
+		unsigned int VBO = 0;
+		unsigned int EBO = 0;
+		VertexFormat Format = VertexFormat::Float;
+		uint32_t     IndexSize = 4;
+		uint32_t     VertexCapacity = 0;
+		uint32_t     IndexCapacity = 0;
+		std::vector<Range> FreeVertices;   // sorted by offset
+		std::vector<Range> FreeIndices;
+	};
+
+	static uint32_t CreateBlock(VertexFormat format, uint32_t indexSize,
+		uint32_t vertexCapacity, uint32_t indexCapacity);
+	static void SetupAttributes(VertexFormat format);
+
+	static bool AllocateRange(std::vector<Range>& freeList, uint32_t count, uint32_t& offset);
+	static void FreeRange(std::vector<Range>& freeList, uint32_t offset, uint32_t count);
+
+private:
+	static std::vector<Block> s_Blocks;
+	static Stats              s_Stats;
+};
@@ -0,0 +1,38 @@
+#include "IndirectBuffer.h"
+#include "Graphics/GLExtensions.h"
+
+static_assert(sizeof(DrawElementsIndirectCommand) == 20, "Indirect command layout mismatch");
+
+IndirectBuffer::IndirectBuffer()
+{
+	glGenBuffers(1, &m_RendererID);
+}
+
+IndirectBuffer::~IndirectBuffer()
+{
+	glDeleteBuffers(1, &m_RendererID);
+}
+
+// ------------------------------------------------------------
+// Upload -- orphaned like the instance stream
+// ------------------------------------------------------------
+void IndirectBuffer::Upload(const std::vector<DrawElementsIndirectCommand>& commands)
+{
+	if (commands.size() > m_Capacity)
+		m_Capacity = commands.size() + commands.size() / 2;
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_RendererID);
+	glBufferData(GL_DRAW_INDIRECT_BUFFER, m_Capacity * sizeof(DrawElementsIndirectCommand), nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, commands.size() * sizeof(DrawElementsIndirectCommand), commands.data());
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void IndirectBuffer::Bind() const
+{
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_RendererID);
+}
+
+void IndirectBuffer::Unbind()
+{
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
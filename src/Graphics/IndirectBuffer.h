@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// IndirectBuffer -- per-frame GL_DRAW_INDIRECT_BUFFER of draw commands.
+// One command per instanced batch; a multi-draw then submits a run of
+// commands that share program, textures and arena block in a single call.
+// -----------------------------------------------------------------------------
+
+// Layout fixed by glMultiDrawElementsIndirect
+struct DrawElementsIndirectCommand
+{
+	uint32_t Count;           // indices
+	uint32_t InstanceCount;
+	uint32_t FirstIndex;
+	int32_t  BaseVertex;
+	uint32_t BaseInstance;    // offset into the instance stream
+};
+
+class IndirectBuffer
+{
+public:
+	IndirectBuffer();
+	~IndirectBuffer();
+
+	IndirectBuffer(const IndirectBuffer&) = delete;
+	IndirectBuffer& operator=(const IndirectBuffer&) = delete;
+
+	// Replace the whole frame's commands (storage grows, never shrinks)
+	void Upload(const std::vector<DrawElementsIndirectCommand>& commands);
+
+	void Bind() const;
+	static void Unbind();
+
+private:
+	unsigned int m_RendererID = 0;
+	size_t m_Capacity = 0;   // in commands
+};
@@ -0,0 +1,66 @@
+#include "InstanceBuffer.h"
+
+#include <glad/glad.h>
+#include <cstddef>
+
+InstanceBuffer::InstanceBuffer()
+{
+	glGenBuffers(1, &m_RendererID);
+}
+
+InstanceBuffer::~InstanceBuffer()
+{
+	glDeleteBuffers(1, &m_RendererID);
+}
+
+// ------------------------------------------------------------
+// Upload -- orphan the old storage so the driver never stalls
+// on draws from the previous frame
+// ------------------------------------------------------------
+void InstanceBuffer::Upload(const std::vector<InstanceData>& instances)
+{
+	if (instances.size() > m_Capacity)
+		m_Capacity = instances.size() + instances.size() / 2;
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+	glBufferData(GL_ARRAY_BUFFER, m_Capacity * sizeof(InstanceData), nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(InstanceData), instances.data());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// ------------------------------------------------------------
+// Attribute layout: mat4 model (4 x vec4), albedo, params, light list
+// ------------------------------------------------------------
+void InstanceBuffer::BindAttributes(size_t firstInstance) const
+{
+	glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+
+	const size_t base = firstInstance * sizeof(InstanceData);
+	const GLsizei stride = sizeof(InstanceData);
+
+	for (unsigned int column = 0; column < 4; column++)
+	{
+		unsigned int location = FirstAttribute + column;
+		glEnableVertexAttribArray(location);
+		glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, stride,
+			(void*)(base + offsetof(InstanceData, Model) + column * sizeof(glm::vec4)));
+		glVertexAttribDivisor(location, 1);
+	}
+
+	glEnableVertexAttribArray(FirstAttribute + 4);
+	glVertexAttribPointer(FirstAttribute + 4, 4, GL_FLOAT, GL_FALSE, stride,
+		(void*)(base + offsetof(InstanceData, Albedo)));
+	glVertexAttribDivisor(FirstAttribute + 4, 1);
+
+	glEnableVertexAttribArray(FirstAttribute + 5);
+	glVertexAttribPointer(FirstAttribute + 5, 4, GL_FLOAT, GL_FALSE, stride,
+		(void*)(base + offsetof(InstanceData, MaterialParams)));
+	glVertexAttribDivisor(FirstAttribute + 5, 1);
+
+	glEnableVertexAttribArray(FirstAttribute + 6);
+	glVertexAttribIPointer(FirstAttribute + 6, 4, GL_UNSIGNED_INT, stride,
+		(void*)(base + offsetof(InstanceData, LightIndices)));
+	glVertexAttribDivisor(FirstAttribute + 6, 1);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
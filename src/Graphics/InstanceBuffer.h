@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+// -----------------------------------------------------------------------------
+// InstanceBuffer -- per-instance vertex stream shared by every instanced draw.
+// All instances of a frame are uploaded at once; each batch then points the
+// instance attributes of the bound VAO at its own range (GL 3.3 has no
+// base-instance draws).
+// -----------------------------------------------------------------------------
+
+// Matches the a_Model / a_Albedo / a_MaterialParams / a_LightIndices inputs of pbr.vert
+struct InstanceData
+{
+	glm::mat4  Model;
+	glm::vec4  Albedo;           // rgb = fallback albedo
+	glm::vec4  MaterialParams;   // x = roughness, y = metalness
+	glm::uvec4 LightIndices;     // per-object light list, 2 x 16 bits per component
+};
+
+class InstanceBuffer
+{
+public:
+	// First attribute location used by the instance stream (4..10)
+	static constexpr unsigned int FirstAttribute = 4;
+
+	InstanceBuffer();
+	~InstanceBuffer();
+
+	// Replace the whole frame's instance data (storage grows, never shrinks)
+	void Upload(const std::vector<InstanceData>& instances);
+
+	// Point the currently bound VAO's instance attributes at 'firstInstance'
+	void BindAttributes(size_t firstInstance) const;
+
+private:
+	unsigned int m_RendererID = 0;
+	size_t m_Capacity = 0;   // in instances
+};
@@ -30,6 +30,16 @@ const glm::vec3& Light::GetPosition() const
 	return m_Position;
 }
 
+void Light::SetRadius(float radius)
+{
+	m_Radius = radius;
+}
+
+float Light::GetRadius() const
+{
+	return m_Radius;
+}
+
 void Light::SetIntensity(float intensity)
 {
 	m_Intensity = intensity;
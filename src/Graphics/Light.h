@@ -24,6 +24,11 @@ public:
 	void SetPosition(const glm::vec3& pos);
 	const glm::vec3& GetPosition() const;
 
+	// Point light only: distance at which the contribution reaches zero.
+	// Bounds the light for clustered light assignment.
+	void SetRadius(float radius);
+	float GetRadius() const;
+
 	// Strength/intensity for UI tuning
 	void SetIntensity(float intensity);
 	float GetIntensity() const;
@@ -34,5 +39,6 @@ private:
 	glm::vec3  m_Color = glm::vec3(1.0f);
 	glm::vec3  m_Position = glm::vec3(0.0f); // used by Point light
 
+	float      m_Radius = 10.0f;              // used by Point light
 	float      m_Intensity = 1.0f;
 };
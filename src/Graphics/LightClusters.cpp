@@ -0,0 +1,260 @@
+#include "LightClusters.h"
+#include "Graphics/Camera.h"
+#include "Graphics/Light.h"
+#include "Graphics/Shader.h"
+#include "Graphics/TextureBuffer.h"
+#include "Core/ThreadPool.h"
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LIGHT_CLUSTERS_SSE 1
+#include <emmintrin.h>
+#endif
+
+LightClusters::LightClusters()
+{
+	m_ClusterBounds.resize(ClusterCount);
+	m_Grid.resize(ClusterCount);
+
+	m_LightDataBuffer = new TextureBuffer(GL_RGBA32F);
+	m_GridBuffer = new TextureBuffer(GL_RG32UI);
+	m_IndexBuffer = new TextureBuffer(GL_R16UI);
+}
+
+LightClusters::~LightClusters()
+{
+	delete m_IndexBuffer;
+	delete m_GridBuffer;
+	delete m_LightDataBuffer;
+}
+
+void LightClusters::BindSamplerUnits(Shader& shader)
+{
+	shader.Bind();
+	shader.Set(shader.GetUniform<int>("u_LightData"), (int)LightDataUnit);
+	shader.Set(shader.GetUniform<int>("u_ClusterGrid"), (int)ClusterGridUnit);
+	shader.Set(shader.GetUniform<int>("u_LightIndices"), (int)LightIndexUnit);
+}
+
+void LightClusters::Bind() const
+{
+	m_LightDataBuffer->Bind(LightDataUnit);
+	m_GridBuffer->Bind(ClusterGridUnit);
+	m_IndexBuffer->Bind(LightIndexUnit);
+}
+
+glm::vec4 LightClusters::GetShaderParams(int viewportWidth, int viewportHeight) const
+{
+	float nearClip = m_ProjectionKey.z;
+	float farClip = m_ProjectionKey.w;
+	float logRange = std::log(farClip / nearClip);
+
+	return glm::vec4(
+		(float)GridX / (float)viewportWidth,
+		(float)GridY / (float)viewportHeight,
+		GridZ / logRange,
+		-(float)GridZ * std::log(nearClip) / logRange);
+}
+
+// ------------------------------------------------------------
+// Cluster boxes -- exponential slices, so clusters stay roughly
+// cubic in view space from the near plane to the far plane
+// ------------------------------------------------------------
+void LightClusters::BuildClusterBounds(float fovY, float aspectRatio, float nearClip, float farClip)
+{
+	float tanY = std::tan(glm::radians(fovY) * 0.5f);
+	float tanX = tanY * aspectRatio;
+
+	for (uint32_t z = 0; z <= GridZ; z++)
+		m_SliceDepths[z] = nearClip * std::pow(farClip / nearClip, (float)z / GridZ);
+
+	for (uint32_t z = 0; z < GridZ; z++)
+	{
+		float depths[2] = { m_SliceDepths[z], m_SliceDepths[z + 1] };
+
+		for (uint32_t y = 0; y < GridY; y++)
+		{
+			for (uint32_t x = 0; x < GridX; x++)
+			{
+				// Tile edges in NDC, y = -1 at the bottom (gl_FragCoord origin)
+				float ndcX[2] = { -1.0f + 2.0f * x / GridX, -1.0f + 2.0f * (x + 1) / GridX };
+				float ndcY[2] = { -1.0f + 2.0f * y / GridY, -1.0f + 2.0f * (y + 1) / GridY };
+
+				AABB box = AABB::Empty();
+				for (float depth : depths)
+					for (float nx : ndcX)
+						for (float ny : ndcY)
+							box.Expand(glm::vec3(nx * tanX * depth, ny * tanY * depth, -depth));
+
+				m_ClusterBounds[x + GridX * (y + GridY * z)] = box;
+			}
+		}
+	}
+}
+
+// ------------------------------------------------------------
+// Bin every light touching the clusters of one depth slice
+// ------------------------------------------------------------
+void LightClusters::BinSlice(uint32_t z)
+{
+	SliceBin& bin = m_Slices[z];
+	float nearDepth = m_SliceDepths[z];
+	float farDepth = m_SliceDepths[z + 1];
+
+	// 1) Candidates: lights whose depth interval overlaps the slice
+	bin.X.clear();
+	bin.Y.clear();
+	bin.Z.clear();
+	bin.RadiusSq.clear();
+	bin.LightIndex.clear();
+
+	for (uint32_t i = 0; i < m_LightCount; i++)
+	{
+		const glm::vec4& light = m_ViewLights[i];
+		float depth = -light.z;
+		if (depth + light.w < nearDepth || depth - light.w > farDepth)
+			continue;
+
+		bin.X.push_back(light.x);
+		bin.Y.push_back(light.y);
+		bin.Z.push_back(light.z);
+		bin.RadiusSq.push_back(light.w * light.w);
+		bin.LightIndex.push_back((uint16_t)i);
+	}
+
+	// Pad to a multiple of 4; a negative squared radius never passes
+	uint32_t candidates = (uint32_t)bin.LightIndex.size();
+	while (bin.X.size() % 4)
+	{
+		bin.X.push_back(0.0f);
+		bin.Y.push_back(0.0f);
+		bin.Z.push_back(0.0f);
+		bin.RadiusSq.push_back(-1.0f);
+	}
+
+	// 2) Sphere vs cluster AABB: squared distance from the center to the box
+	bin.Indices.clear();
+
+	uint32_t first = GridX * GridY * z;
+	for (uint32_t c = first; c < first + GridX * GridY; c++)
+	{
+		const AABB& box = m_ClusterBounds[c];
+		uint32_t start = (uint32_t)bin.Indices.size();
+
+#if LIGHT_CLUSTERS_SSE
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 minX = _mm_set1_ps(box.Min.x), maxX = _mm_set1_ps(box.Max.x);
+		const __m128 minY = _mm_set1_ps(box.Min.y), maxY = _mm_set1_ps(box.Max.y);
+		const __m128 minZ = _mm_set1_ps(box.Min.z), maxZ = _mm_set1_ps(box.Max.z);
+
+		for (uint32_t i = 0; i < candidates; i += 4)
+		{
+			__m128 cx = _mm_loadu_ps(&bin.X[i]);
+			__m128 cy = _mm_loadu_ps(&bin.Y[i]);
+			__m128 cz = _mm_loadu_ps(&bin.Z[i]);
+
+			__m128 dx = _mm_add_ps(_mm_max_ps(_mm_sub_ps(minX, cx), zero), _mm_max_ps(_mm_sub_ps(cx, maxX), zero));
+			__m128 dy = _mm_add_ps(_mm_max_ps(_mm_sub_ps(minY, cy), zero), _mm_max_ps(_mm_sub_ps(cy, maxY), zero));
+			__m128 dz = _mm_add_ps(_mm_max_ps(_mm_sub_ps(minZ, cz), zero), _mm_max_ps(_mm_sub_ps(cz, maxZ), zero));
+
+			__m128 distSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+			int mask = _mm_movemask_ps(_mm_cmple_ps(distSq, _mm_loadu_ps(&bin.RadiusSq[i])));
+
+			for (int lane = 0; mask; lane++, mask >>= 1)
+			{
+				if (mask & 1)
+					bin.Indices.push_back(bin.LightIndex[i + lane]);
+			}
+		}
+#else
+		for (uint32_t i = 0; i < candidates; i++)
+		{
+			glm::vec3 center(bin.X[i], bin.Y[i], bin.Z[i]);
+			glm::vec3 d = glm::clamp(center, box.Min, box.Max) - center;
+			if (glm::dot(d, d) <= bin.RadiusSq[i])
+				bin.Indices.push_back(bin.LightIndex[i]);
+		}
+#endif
+
+		// Offset is slice-local here; Update() rebases it after the merge
+		m_Grid[c] = glm::uvec2(start, (uint32_t)bin.Indices.size() - start);
+	}
+}
+
+// ------------------------------------------------------------
+// Per-frame update
+// ------------------------------------------------------------
+void LightClusters::Update(const std::vector<Light>& lights, const Camera& camera, float aspectRatio,
+	bool binClusters)
+{
+	glm::vec4 projectionKey(camera.GetFOV(), aspectRatio, camera.GetNearClip(), camera.GetFarClip());
+	if (projectionKey != m_ProjectionKey)
+	{
+		BuildClusterBounds(projectionKey.x, projectionKey.y, projectionKey.z, projectionKey.w);
+		m_ProjectionKey = projectionKey;
+	}
+
+	// 1) Point lights to view space + GPU records
+	glm::mat4 view = camera.GetViewMatrix();
+
+	m_ViewLights.clear();
+	m_LightData.clear();
+
+	for (const Light& light : lights)
+	{
+		if (light.GetType() != LightType::Point || light.GetRadius() <= 0.0f)
+			continue;
+		if (m_ViewLights.size() == MaxLights)
+			break;
+
+		glm::vec3 viewPos = glm::vec3(view * glm::vec4(light.GetPosition(), 1.0f));
+		m_ViewLights.push_back(glm::vec4(viewPos, light.GetRadius()));
+
+		m_LightData.push_back(glm::vec4(light.GetPosition(), light.GetRadius()));
+		m_LightData.push_back(glm::vec4(light.GetColor() * light.GetIntensity(), 0.0f));
+	}
+	m_LightCount = (uint32_t)m_ViewLights.size();
+
+	m_LightDataBuffer->SetData(m_LightData.data(), m_LightData.size() * sizeof(glm::vec4));
+
+	if (!binClusters)
+	{
+		m_Indices.clear();
+		return;
+	}
+
+	// 2) Bin slices in parallel -- each slice owns its clusters and index list
+	ThreadPool::Get().ParallelFor(GridZ, 1, [this](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t z = begin; z < end; z++)
+			BinSlice(z);
+	});
+
+	// 3) Concatenate slice lists in cluster order and rebase offsets
+	size_t total = 0;
+	for (const SliceBin& bin : m_Slices)
+		total += bin.Indices.size();
+	m_Indices.resize(total);
+
+	uint32_t base = 0;
+	for (uint32_t z = 0; z < GridZ; z++)
+	{
+		const SliceBin& bin = m_Slices[z];
+		if (!bin.Indices.empty())
+			std::memcpy(m_Indices.data() + base, bin.Indices.data(), bin.Indices.size() * sizeof(uint16_t));
+
+		uint32_t first = GridX * GridY * z;
+		for (uint32_t c = first; c < first + GridX * GridY; c++)
+			m_Grid[c].x += base;
+
+		base += (uint32_t)bin.Indices.size();
+	}
+
+	// 4) Upload
+	m_GridBuffer->SetData(m_Grid.data(), m_Grid.size() * sizeof(glm::uvec2));
+	m_IndexBuffer->SetData(m_Indices.data(), m_Indices.size() * sizeof(uint16_t));
+}
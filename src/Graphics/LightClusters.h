@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Graphics/Bounds.h"
+
+class Camera;
+class Light;
+class Shader;
+class TextureBuffer;
+
+// -----------------------------------------------------------------------------
+// LightClusters -- clustered forward light assignment
+// The view frustum is split into GridX x GridY screen tiles and GridZ
+// exponential depth slices. Every frame the point lights are binned into the
+// clusters their sphere touches (slices in parallel on the ThreadPool, four
+// lights per SIMD test) and uploaded as three texture buffers:
+//   LightData    RGBA32F  2 texels per light: (position, radius), (color * intensity, 0)
+//   ClusterGrid  RG32UI   per cluster: (first entry in LightIndices, count)
+//   LightIndices R16UI    light indices grouped by cluster
+// -----------------------------------------------------------------------------
+class LightClusters
+{
+public:
+	static constexpr uint32_t GridX = 16;
+	static constexpr uint32_t GridY = 9;
+	static constexpr uint32_t GridZ = 24;
+	static constexpr uint32_t ClusterCount = GridX * GridY * GridZ;
+
+	// Indices are stored as 16 bits
+	static constexpr uint32_t MaxLights = 65535;
+
+	// Texture units (material maps use 0..4)
+	static constexpr unsigned int LightDataUnit = 5;
+	static constexpr unsigned int ClusterGridUnit = 6;
+	static constexpr unsigned int LightIndexUnit = 7;
+
+	LightClusters();
+	~LightClusters();
+
+	// Bin the point lights for this camera and upload the buffers.
+	// With binClusters = false only LightData is refreshed (per-object lighting).
+	void Update(const std::vector<Light>& lights, const Camera& camera, float aspectRatio,
+		bool binClusters = true);
+
+	// Bind the three buffers to their texture units
+	void Bind() const;
+
+	// FrameData.u_ClusterParams: (GridX / width, GridY / height, slice scale, slice bias)
+	// where slice = log(viewDepth) * scale + bias
+	glm::vec4 GetShaderParams(int viewportWidth, int viewportHeight) const;
+
+	// Sampler units never change -- assign them once per program
+	static void BindSamplerUnits(Shader& shader);
+
+	// Uploaded light records, 2 per light (see LightData above)
+	const std::vector<glm::vec4>& GetLightData() const { return m_LightData; }
+
+	uint32_t GetLightCount() const { return m_LightCount; }
+	uint32_t GetIndexCount() const { return (uint32_t)m_Indices.size(); }
+
+private:
+	// Per-slice working set, reused across frames
+	struct SliceBin
+	{
+		// Candidate lights overlapping the slice depth range, SoA padded to 4
+		std::vector<float>    X, Y, Z, RadiusSq;
+		std::vector<uint16_t> LightIndex;
+
+		std::vector<uint16_t> Indices;   // this slice's share of the index list
+	};
+
+	void BuildClusterBounds(float fovY, float aspectRatio, float nearClip, float farClip);
+	void BinSlice(uint32_t slice);
+
+private:
+	// View-space cluster boxes, rebuilt only when the projection changes
+	std::vector<AABB> m_ClusterBounds;
+	float             m_SliceDepths[GridZ + 1] = {};
+	glm::vec4         m_ProjectionKey = glm::vec4(0.0f);   // fovY, aspect, near, far
+
+	// View-space light spheres (x, y, z, radius)
+	std::vector<glm::vec4> m_ViewLights;
+	uint32_t               m_LightCount = 0;
+
+	SliceBin m_Slices[GridZ];
+
+	// CPU copies of the uploaded data
+	std::vector<glm::vec4>  m_LightData;
+	std::vector<glm::uvec2> m_Grid;
+	std::vector<uint16_t>   m_Indices;
+
+	TextureBuffer* m_LightDataBuffer = nullptr;
+	TextureBuffer* m_GridBuffer = nullptr;
+	TextureBuffer* m_IndexBuffer = nullptr;
+};
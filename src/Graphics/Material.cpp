@@ -1,4 +1,7 @@
 #include "Material.h"
+#include "GLState.h"
+
+#include <glad/glad.h>
 
 Material::Material()
 {
@@ -90,85 +93,92 @@ Material* Material::Clone() const
 }
 
 // ============================================================
-// Apply material parameters and bind textures
+// Feature mask -> shader variant
 // ============================================================
-void Material::Apply(Shader& shader) const
+uint32_t Material::GetFeatureMask() const
 {
-	shader.Bind();
+	uint32_t mask = 0;
+	if (m_DiffuseTexture)  mask |= MaterialFeature::AlbedoMap;
+	if (m_NormalMap)       mask |= MaterialFeature::NormalMap;
+	if (m_RoughnessMap)    mask |= MaterialFeature::RoughnessMap;
+	if (m_MetalnessMap)    mask |= MaterialFeature::MetalnessMap;
+	if (m_DisplacementMap) mask |= MaterialFeature::DisplacementMap;
+	return mask;
+}
 
-	// ============================================================
-	// PBR fallback value uniforms (ALL VALID & USED IN SHADER)
-	// ============================================================
-	shader.SetVec3("u_Material_DefaultAlbedo", m_DiffuseColor);
-	shader.SetFloat("u_DefaultRoughness", 0.5f);
-	shader.SetFloat("u_DefaultMetalness", 0.0f);
-
-	// ============================================================
-	// Texture Binding Layout:
-	//   0 = Albedo
-	//   1 = Normal
-	//   2 = Roughness
-	//   3 = Metalness
-	//   4 = Displacement
-	// ============================================================
-
-	// Albedo
-	if (m_DiffuseTexture)
+std::vector<std::string> Material::GetFeatureDefines(uint32_t featureMask)
+{
+	static const char* const names[MaterialFeature::Count] =
 	{
-		m_DiffuseTexture->Bind(0);
-		shader.SetInt("u_AlbedoMap", 0);
-		shader.SetInt("u_AlbedoMapEnabled", 1);
-	}
-	else
+		"HAS_ALBEDO_MAP",
+		"HAS_NORMAL_MAP",
+		"HAS_ROUGHNESS_MAP",
+		"HAS_METALNESS_MAP",
+		"HAS_DISPLACEMENT_MAP"
+	};
+
+	std::vector<std::string> defines;
+	for (uint32_t i = 0; i < MaterialFeature::Count; i++)
 	{
-		shader.SetInt("u_AlbedoMapEnabled", 0);
+		if (featureMask & (1u << i))
+			defines.push_back(names[i]);
 	}
+	return defines;
+}
 
-	// Normal
-	if (m_NormalMap)
-	{
-		m_NormalMap->Bind(1);
-		shader.SetInt("u_NormalMap", 1);
-		shader.SetInt("u_NormalMapEnabled", 1);
-	}
-	else
-	{
-		shader.SetInt("u_NormalMapEnabled", 0);
-	}
+// ============================================================
+// Texture Binding Layout:
+//   0 = Albedo
+//   1 = Normal
+//   2 = Roughness
+//   3 = Metalness
+//   4 = Displacement
+// ============================================================
+void Material::BindSamplerUnits(Shader& shader)
+{
+	shader.Bind();
+	shader.Set(shader.GetUniform<int>("u_AlbedoMap"), 0);
+	shader.Set(shader.GetUniform<int>("u_NormalMap"), 1);
+	shader.Set(shader.GetUniform<int>("u_RoughnessMap"), 2);
+	shader.Set(shader.GetUniform<int>("u_MetalnessMap"), 3);
+	shader.Set(shader.GetUniform<int>("u_DisplacementMap"), 4);
+	shader.Set(shader.GetUniform<int>("u_MaterialData"), (int)MaterialDataUnit);
+}
 
-	// Roughness
-	if (m_RoughnessMap)
-	{
-		m_RoughnessMap->Bind(2);
-		shader.SetInt("u_RoughnessMap", 2);
-		shader.SetInt("u_RoughnessMapEnabled", 1);
-	}
-	else
-	{
-		shader.SetInt("u_RoughnessMapEnabled", 0);
-	}
+// ============================================================
+// Bind textures -- the shader must be the variant for
+// GetFeatureMask(), so only the maps that exist are bound
+// (async loads bind their placeholder until they finish)
+// ============================================================
+void Material::BindTextures() const
+{
+	if (m_DiffuseTexture)  TextureLibrary::GetDrawable(m_DiffuseTexture, TexturePlaceholder::Gray)->Bind(0);
+	if (m_NormalMap)       TextureLibrary::GetDrawable(m_NormalMap, TexturePlaceholder::FlatNormal)->Bind(1);
+	if (m_RoughnessMap)    TextureLibrary::GetDrawable(m_RoughnessMap, TexturePlaceholder::Gray)->Bind(2);
+	if (m_MetalnessMap)    TextureLibrary::GetDrawable(m_MetalnessMap, TexturePlaceholder::Black)->Bind(3);
+	if (m_DisplacementMap) TextureLibrary::GetDrawable(m_DisplacementMap, TexturePlaceholder::Gray)->Bind(4);
+}
 
-	// Metalness
-	if (m_MetalnessMap)
-	{
-		m_MetalnessMap->Bind(3);
-		shader.SetInt("u_MetalnessMap", 3);
-		shader.SetInt("u_MetalnessMapEnabled", 1);
-	}
-	else
-	{
-		shader.SetInt("u_MetalnessMapEnabled", 0);
-	}
+// ============================================================
+// Texture arrays -- same units, GL_TEXTURE_2D_ARRAY targets
+// ============================================================
+void Material::GetArrayLayers(TextureArrayLayer (&layers)[MaterialFeature::Count]) const
+{
+	layers[0] = TextureLibrary::GetArrayLayer(m_DiffuseTexture, TexturePlaceholder::Gray);
+	layers[1] = TextureLibrary::GetArrayLayer(m_NormalMap, TexturePlaceholder::FlatNormal);
+	layers[2] = TextureLibrary::GetArrayLayer(m_RoughnessMap, TexturePlaceholder::Gray);
+	layers[3] = TextureLibrary::GetArrayLayer(m_MetalnessMap, TexturePlaceholder::Black);
+	layers[4] = TextureLibrary::GetArrayLayer(m_DisplacementMap, TexturePlaceholder::Gray);
+}
 
-	// Displacement
-	if (m_DisplacementMap)
-	{
-		m_DisplacementMap->Bind(4);
-		shader.SetInt("u_DisplacementMap", 4);
-		shader.SetInt("u_DisplacementMapEnabled", 1);
-	}
-	else
+void Material::BindTextureArrays() const
+{
+	TextureArrayLayer layers[MaterialFeature::Count];
+	GetArrayLayers(layers);
+
+	for (unsigned int unit = 0; unit < MaterialFeature::Count; unit++)
 	{
-		shader.SetInt("u_DisplacementMapEnabled", 0);
+		if (layers[unit].ArrayID != 0)
+			GLState::BindTexture(unit, GL_TEXTURE_2D_ARRAY, layers[unit].ArrayID);
 	}
 }
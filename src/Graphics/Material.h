@@ -1,12 +1,36 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
 #include "Texture.h"
+#include "TextureLibrary.h"
 #include "Shader.h"
 
+// ------------------------------------------------------------
+// Feature bits derived from the assigned maps -- one shader variant per mask
+// ------------------------------------------------------------
+namespace MaterialFeature
+{
+	enum : uint32_t
+	{
+		AlbedoMap       = 1 << 0,   // HAS_ALBEDO_MAP
+		NormalMap       = 1 << 1,   // HAS_NORMAL_MAP
+		RoughnessMap    = 1 << 2,   // HAS_ROUGHNESS_MAP
+		MetalnessMap    = 1 << 3,   // HAS_METALNESS_MAP
+		DisplacementMap = 1 << 4,   // HAS_DISPLACEMENT_MAP
+
+		Count = 5
+	};
+}
+
 class Material
 {
 public:
+	// Per-material record buffer (TEXTURE_ARRAYS), after the 5 map units
+	static constexpr unsigned int MaterialDataUnit = 11;
+
 	Material();
 
 	// Base color used when no albedo texture is assigned
@@ -17,6 +41,12 @@ public:
 	void SetSpecularColor(const glm::vec3& color);
 	const glm::vec3& GetSpecularColor() const;
 
+	// Scalar PBR fallbacks used when no roughness / metalness map is assigned
+	void SetRoughness(float roughness) { m_Roughness = roughness; }
+	void SetMetalness(float metalness) { m_Metalness = metalness; }
+	float GetRoughness() const { return m_Roughness; }
+	float GetMetalness() const { return m_Metalness; }
+
 	// Shininess (legacy field  still editable but unused by PBR shader)
 	void SetShininess(float shininess);
 	float GetShininess() const;
@@ -44,12 +74,32 @@ public:
 	// Duplicate this material object
 	Material* Clone() const;
 
-	// Apply all active textures and fallback values to the GPU shader
-	void Apply(Shader& shader) const;
+	// Bitmask of MaterialFeature flags for the assigned maps
+	uint32_t GetFeatureMask() const;
+
+	// Preprocessor defines that specialize pbr.frag for a feature mask
+	static std::vector<std::string> GetFeatureDefines(uint32_t featureMask);
+
+	// Assign the fixed texture unit of every sampler (once per shader)
+	static void BindSamplerUnits(Shader& shader);
+
+	// Bind the assigned maps to their fixed units. Scalar parameters
+	// (albedo, roughness, metalness) travel per instance, not as uniforms.
+	void BindTextures() const;
+
+	// Array layer of every map in MaterialFeature bit order
+	// (Layer = -1 where no map is assigned)
+	void GetArrayLayers(TextureArrayLayer (&layers)[MaterialFeature::Count]) const;
+
+	// Bind the texture arrays holding the assigned maps (TEXTURE_ARRAYS
+	// variants). Layers come from the material buffer, not uniforms.
+	void BindTextureArrays() const;
 
 private:
 	// Default PBR albedo if no texture is assigned
 	glm::vec3 m_DiffuseColor = glm::vec3(0.8f);
+	float     m_Roughness = 0.5f;
+	float     m_Metalness = 0.0f;
 
 	// Legacy Phong params (retained for compatibility/UI)
 	glm::vec3 m_SpecularColor = glm::vec3(1.0f);
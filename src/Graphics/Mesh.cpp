@@ -1,21 +1,76 @@
 #include "Mesh.h"
+#include "Graphics/GLState.h"
+#include "Graphics/MeshOptimizer.h"
+#include "Graphics/TangentGenerator.h"
+#include "Utils/Log.h"
 #include <glad/glad.h>
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/packing.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+namespace
+{
+	// Unit vector -> octahedron unfolded onto [-1, 1]^2
+	glm::vec2 OctEncode(glm::vec3 n)
+	{
+		n /= std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+		glm::vec2 e(n.x, n.y);
+		if (n.z < 0.0f)
+		{
+			e = (1.0f - glm::abs(glm::vec2(n.y, n.x))) *
+				glm::vec2(n.x >= 0.0f ? 1.0f : -1.0f, n.y >= 0.0f ? 1.0f : -1.0f);
+		}
+		return e;
+	}
+
+	int16_t ToSnorm16(float v)
+	{
+		return (int16_t)std::lround(glm::clamp(v, -1.0f, 1.0f) * 32767.0f);
+	}
+
+	// y is remapped to [0, 1] so its sign is free for the handedness
+	void PackTangent(const glm::vec3& tangent, float handedness, int16_t out[2])
+	{
+		glm::vec2 e = OctEncode(tangent);
+		float y = glm::max(e.y * 0.5f + 0.5f, 1.0f / 32767.0f);
+		out[0] = ToSnorm16(e.x);
+		out[1] = ToSnorm16(handedness < 0.0f ? -y : y);
+	}
+
+	void PackNormal(const glm::vec3& normal, int16_t out[2])
+	{
+		glm::vec2 e = OctEncode(normal);
+		out[0] = ToSnorm16(e.x);
+		out[1] = ToSnorm16(e.y);
+	}
+}
 
 // Construct from ready vertex buffer
 Mesh::Mesh(const std::vector<Vertex>& vertices,
-	const std::vector<unsigned int>& indices)
-	: m_Vertices(vertices), m_Indices(indices)
+	const std::vector<unsigned int>& indices,
+	VertexFormat format, bool upload)
+	: m_Format(format), m_Vertices(vertices), m_Indices(indices)
 {
 	m_IndexCount = static_cast<unsigned int>(indices.size());
+	Optimize();
+	ComputeBounds();
+	BuildLODs();
 	RecalculateTangents();
-	UploadToGPU();
+	if (upload)
+		UploadToGPU();
 }
 
 // Legacy constructor (positions + normals + uvs)
 Mesh::Mesh(const std::vector<glm::vec3>& positions,
 	const std::vector<glm::vec3>& normals,
 	const std::vector<glm::vec2>& uvs,
-	const std::vector<unsigned int>& indices)
+	const std::vector<unsigned int>& indices,
+	VertexFormat format)
+	: m_Format(format)
 {
 	m_Vertices.reserve(positions.size());
 	for (size_t i = 0; i < positions.size(); i++)
@@ -24,110 +79,337 @@ Mesh::Mesh(const std::vector<glm::vec3>& positions,
 		v.Position = positions[i];
 		v.Normal = normals[i];
 		v.UV = uvs[i];
-		v.Tangent = glm::vec3(0.0f);
+		v.Tangent = glm::vec4(0.0f);
 		m_Vertices.push_back(v);
 	}
 
 	m_Indices = indices;
 	m_IndexCount = static_cast<unsigned int>(indices.size());
 
+	Optimize();
+	ComputeBounds();
+	BuildLODs();
 	RecalculateTangents();
 	UploadToGPU();
 }
 
+// Construct from prepared data (mesh files)
+Mesh::Mesh(const GPUData& data)
+	: m_Format(data.Format), m_Dequantization(data.Dequantization),
+	m_LODs(data.LODs), m_Bounds(data.Bounds), m_BoundingSphere(data.Sphere)
+{
+	if (m_LODs.empty())
+		m_LODs.push_back({ 0, data.IndexCount, 0.0f });
+	m_IndexCount = m_LODs[0].IndexCount;
+
+	m_Allocation = GeometryArena::Allocate(m_Format, data.Vertices, data.VertexCount,
+		data.Indices, data.IndexCount, data.IndexSize);
+}
+
 Mesh::~Mesh()
 {
-	glDeleteBuffers(1, &m_EBO);
-	glDeleteBuffers(1, &m_VBO);
-	glDeleteVertexArrays(1, &m_VAO);
+	GeometryArena::Free(m_Allocation);
 }
 
 void Mesh::Bind() const
 {
-	glBindVertexArray(m_VAO);
+	GLState::BindVertexArray(GetVertexArray());
 }
 
 void Mesh::Draw() const
 {
-	glDrawElements(GL_TRIANGLES, m_IndexCount, GL_UNSIGNED_INT, nullptr);
+	glDrawElementsBaseVertex(GL_TRIANGLES, m_IndexCount, GetIndexType(),
+		(void*)((size_t)m_Allocation.FirstIndex * m_Allocation.IndexSize), (GLint)m_Allocation.BaseVertex);
 }
 
-// Compute per-vertex tangents from triangle data
-void Mesh::RecalculateTangents()
+// Instance attributes must already point at the batch (see InstanceBuffer)
+void Mesh::DrawInstanced(unsigned int instanceCount, uint32_t lod) const
+{
+	const LOD& level = m_LODs[lod];
+	glDrawElementsInstancedBaseVertex(GL_TRIANGLES, level.IndexCount, GetIndexType(),
+		(void*)((size_t)(m_Allocation.FirstIndex + level.FirstIndex) * m_Allocation.IndexSize), instanceCount,
+		(GLint)m_Allocation.BaseVertex);
+}
+
+unsigned int Mesh::GetIndexType() const
+{
+	return m_Allocation.IndexSize == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
+
+// ------------------------------------------------------------
+// Load-time reordering (see MeshOptimizer): triangles for the
+// vertex cache and overdraw, then vertices in first-use order.
+// Unreferenced vertices are dropped.
+// ------------------------------------------------------------
+void Mesh::Optimize()
 {
-	for (auto& v : m_Vertices)
-		v.Tangent = glm::vec3(0.0f);
+	if (m_Indices.size() < 3 || m_Vertices.empty())
+		return;
+
+	uint32_t vertexCount = (uint32_t)m_Vertices.size();
+	float acmrBefore = MeshOptimizer::ComputeACMR(m_Indices, vertexCount);
+
+	std::vector<glm::vec3> positions(vertexCount);
+	for (uint32_t i = 0; i < vertexCount; i++)
+		positions[i] = m_Vertices[i].Position;
+
+	MeshOptimizer::OptimizeVertexCache(m_Indices, vertexCount);
+	MeshOptimizer::OptimizeOverdraw(m_Indices, positions);
 
-	for (size_t i = 0; i < m_Indices.size(); i += 3)
+	std::vector<uint32_t> remap;
+	uint32_t usedCount = MeshOptimizer::OptimizeVertexFetch(m_Indices, vertexCount, remap);
+
+	std::vector<Vertex> reordered(usedCount);
+	for (uint32_t i = 0; i < vertexCount; i++)
 	{
-		Vertex& v0 = m_Vertices[m_Indices[i + 0]];
-		Vertex& v1 = m_Vertices[m_Indices[i + 1]];
-		Vertex& v2 = m_Vertices[m_Indices[i + 2]];
+		if (remap[i] != UINT32_MAX)
+			reordered[remap[i]] = m_Vertices[i];
+	}
+	m_Vertices.swap(reordered);
+
+	float acmrAfter = MeshOptimizer::ComputeACMR(m_Indices, usedCount);
+
+	char message[160];
+	std::snprintf(message, sizeof(message), "Mesh optimized: %zu triangles, %u vertices, ACMR %.3f -> %.3f (FIFO %u)",
+		m_Indices.size() / 3, usedCount, acmrBefore, acmrAfter, MeshOptimizer::FifoCacheSize);
+	Log::Info(message);
+}
+
+// ------------------------------------------------------------
+// LOD chain: each level simplifies the previous one to about half
+// its triangles (see MeshOptimizer::Simplify) and is reordered for
+// the vertex cache. Vertices are shared, so only indices are added.
+// The chain stops when a level no longer saves a quarter of the
+// triangles or the error would pass a tenth of the bounding radius.
+// ------------------------------------------------------------
+void Mesh::BuildLODs()
+{
+	m_LODs.assign(1, { 0, (uint32_t)m_Indices.size(), 0.0f });
+	m_LODIndices.clear();
+
+	const uint32_t vertexCount = (uint32_t)m_Vertices.size();
+	const float maxError = m_BoundingSphere.Radius * 0.1f;
+
+	std::vector<glm::vec3> positions(vertexCount);
+	for (uint32_t i = 0; i < vertexCount; i++)
+		positions[i] = m_Vertices[i].Position;
 
-		glm::vec3 e1 = v1.Position - v0.Position;
-		glm::vec3 e2 = v2.Position - v0.Position;
+	std::vector<uint32_t> level(m_Indices.begin(), m_Indices.end());
+	float error = 0.0f;
 
-		glm::vec2 d1 = v1.UV - v0.UV;
-		glm::vec2 d2 = v2.UV - v0.UV;
+	while (m_LODs.size() < MaxLODs)
+	{
+		size_t previousCount = level.size();
+		size_t targetCount = (previousCount / 6) * 3;
+		if (targetCount < MinLODTriangles * 3 || error >= maxError)
+			break;
 
-		float r = 1.0f;
-		float det = d1.x * d2.y - d1.y * d2.x;
-		if (det != 0.0f)
-			r = 1.0f / det;
+		error += MeshOptimizer::Simplify(level, positions, targetCount, maxError - error);
+		if (level.empty() || level.size() > previousCount * 3 / 4)
+			break;
 
-		glm::vec3 t = (e1 * d2.y - e2 * d1.y) * r;
+		MeshOptimizer::OptimizeVertexCache(level, vertexCount);
 
-		v0.Tangent += t;
-		v1.Tangent += t;
-		v2.Tangent += t;
+		uint32_t first = (uint32_t)(m_Indices.size() + m_LODIndices.size());
+		m_LODs.push_back({ first, (uint32_t)level.size(), error });
+		m_LODIndices.insert(m_LODIndices.end(), level.begin(), level.end());
 	}
 
-	for (auto& v : m_Vertices)
-		v.Tangent = glm::normalize(v.Tangent);
+	if (m_LODs.size() > 1)
+	{
+		std::string message = "Mesh LODs:";
+		for (const LOD& lod : m_LODs)
+		{
+			char entry[48];
+			std::snprintf(entry, sizeof(entry), " %u tris (%.4f)", lod.IndexCount / 3, lod.Error);
+			message += entry;
+		}
+		Log::Info(message);
+	}
 }
 
-// Upload vertex attributes and index buffer
+// Compute per-vertex tangents from LOD 0's triangles. Vertices on
+// mirror seams are split; the copies go at the end of the vertex list.
+void Mesh::RecalculateTangents()
+{
+	if (m_Vertices.empty())
+		return;
+
+	TangentGenerator::Streams streams;
+	streams.Positions = &m_Vertices[0].Position.x;
+	streams.Normals = &m_Vertices[0].Normal.x;
+	streams.UVs = &m_Vertices[0].UV.x;
+	streams.Tangents = &m_Vertices[0].Tangent.x;
+	streams.Stride = sizeof(Vertex);
+
+	const uint32_t vertexCount = (uint32_t)m_Vertices.size();
+	std::vector<TangentGenerator::Split> splits = TangentGenerator::Generate(m_Indices, vertexCount, streams);
+	if (splits.empty())
+		return;
+
+	// Before the copies are added: 'streams' points into m_Vertices
+	TangentGenerator::RemapSplits(m_LODIndices, vertexCount, streams, splits);
+
+	m_Vertices.reserve(vertexCount + splits.size());
+	for (const TangentGenerator::Split& split : splits)
+	{
+		Vertex v = m_Vertices[split.Source];
+		v.Tangent = glm::vec4(split.Tangent[0], split.Tangent[1], split.Tangent[2], split.Tangent[3]);
+		m_Vertices.push_back(v);
+	}
+}
+
+// Local AABB + bounding sphere around the AABB center
+void Mesh::ComputeBounds()
+{
+	if (m_Vertices.empty())
+		return;
+
+	m_Bounds.Min = m_Bounds.Max = m_Vertices[0].Position;
+	for (const auto& v : m_Vertices)
+	{
+		m_Bounds.Min = glm::min(m_Bounds.Min, v.Position);
+		m_Bounds.Max = glm::max(m_Bounds.Max, v.Position);
+	}
+
+	// Tighter than the half diagonal for most shapes
+	float maxDist2 = 0.0f;
+	glm::vec3 center = m_Bounds.GetCenter();
+	for (const auto& v : m_Vertices)
+	{
+		glm::vec3 d = v.Position - center;
+		maxDist2 = glm::max(maxDist2, glm::dot(d, d));
+	}
+
+	m_BoundingSphere.Center = center;
+	m_BoundingSphere.Radius = glm::sqrt(maxDist2);
+
+	// Quantized positions use one scale for all axes (the largest half
+	// extent) so the dequantization stays uniform
+	if (m_Format == VertexFormat::PackedQuantized)
+	{
+		glm::vec3 halfExtents = m_Bounds.GetExtents();
+		float extent = glm::max(glm::max(halfExtents.x, halfExtents.y), glm::max(halfExtents.z, 1e-6f));
+		m_Dequantization = glm::translate(glm::mat4(1.0f), center) *
+			glm::scale(glm::mat4(1.0f), glm::vec3(extent / 32767.0f));
+	}
+}
+
+// ------------------------------------------------------------
+// Copy vertices (converted to m_Format) and indices into the shared
+// geometry arena, then drop the CPU copy -- nothing reads it once the
+// arena holds the data (mesh files are written before upload)
+// ------------------------------------------------------------
 void Mesh::UploadToGPU()
 {
-	glGenVertexArrays(1, &m_VAO);
-	glGenBuffers(1, &m_VBO);
-	glGenBuffers(1, &m_EBO);
+	if (m_Allocation.IsValid())
+		return;
 
-	glBindVertexArray(m_VAO);
+	GPUData data;
+	std::vector<uint8_t> vertexStorage, indexStorage;
+	if (!GetGPUData(data, vertexStorage, indexStorage))
+		return;
 
-	glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-	glBufferData(GL_ARRAY_BUFFER, m_Vertices.size() * sizeof(Vertex),
-		m_Vertices.data(), GL_STATIC_DRAW);
+	m_Allocation = GeometryArena::Allocate(m_Format, data.Vertices, data.VertexCount,
+		data.Indices, data.IndexCount, data.IndexSize);
+	if (!m_Allocation.IsValid())
+		return;
 
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_Indices.size() * sizeof(unsigned int),
-		m_Indices.data(), GL_STATIC_DRAW);
+	std::vector<Vertex>().swap(m_Vertices);
+	std::vector<unsigned int>().swap(m_Indices);
+	std::vector<uint32_t>().swap(m_LODIndices);
+}
 
-	// Position
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-		(void*)offsetof(Vertex, Position));
+// ------------------------------------------------------------
+// LOD 0's indices followed by the coarser levels. Indices are
+// relative to the mesh's base vertex, so up to 65536 vertices
+// fit 16-bit indices.
+// ------------------------------------------------------------
+bool Mesh::GetGPUData(GPUData& data, std::vector<uint8_t>& vertexStorage,
+	std::vector<uint8_t>& indexStorage) const
+{
+	if (m_Vertices.empty())
+		return false;
 
-	// Normal
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-		(void*)offsetof(Vertex, Normal));
+	data.Format = m_Format;
+	data.VertexCount = (uint32_t)m_Vertices.size();
+	data.Vertices = m_Vertices.data();
+	if (m_Format != VertexFormat::Float)
+	{
+		PackVertices(vertexStorage);
+		data.Vertices = vertexStorage.data();
+	}
 
-	// UV
-	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-		(void*)offsetof(Vertex, UV));
+	data.IndexCount = (uint32_t)(m_Indices.size() + m_LODIndices.size());
+	data.IndexSize = m_Vertices.size() <= 65536 ? sizeof(uint16_t) : sizeof(uint32_t);
+	indexStorage.resize((size_t)data.IndexCount * data.IndexSize);
 
-	// Tangent
-	glEnableVertexAttribArray(3);
-	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-		(void*)offsetof(Vertex, Tangent));
+	if (data.IndexSize == sizeof(uint16_t))
+	{
+		uint16_t* out = reinterpret_cast<uint16_t*>(indexStorage.data());
+		out = std::copy(m_Indices.begin(), m_Indices.end(), out);
+		std::copy(m_LODIndices.begin(), m_LODIndices.end(), out);
+	}
+	else
+	{
+		uint32_t* out = reinterpret_cast<uint32_t*>(indexStorage.data());
+		out = std::copy(m_Indices.begin(), m_Indices.end(), out);
+		std::copy(m_LODIndices.begin(), m_LODIndices.end(), out);
+	}
+	data.Indices = indexStorage.data();
 
-	glBindVertexArray(0);
+	data.LODs = m_LODs;
+	data.Bounds = m_Bounds;
+	data.Sphere = m_BoundingSphere;
+	data.Dequantization = m_Dequantization;
+	return true;
+}
+
+// ------------------------------------------------------------
+// Packed layouts. Quantized positions invert m_Dequantization
+// (set up by ComputeBounds).
+// ------------------------------------------------------------
+void Mesh::PackVertices(std::vector<uint8_t>& out) const
+{
+	const size_t stride = GeometryArena::GetVertexStride(m_Format);
+	out.assign(m_Vertices.size() * stride, 0);
+
+	glm::vec3 center = m_Bounds.GetCenter();
+	glm::vec3 halfExtents = m_Bounds.GetExtents();
+	float extent = glm::max(glm::max(halfExtents.x, halfExtents.y), glm::max(halfExtents.z, 1e-6f));
+
+	for (size_t i = 0; i < m_Vertices.size(); i++)
+	{
+		const Vertex& v = m_Vertices[i];
+
+		if (m_Format == VertexFormat::PackedQuantized)
+		{
+			QuantizedVertex& q = reinterpret_cast<QuantizedVertex*>(out.data())[i];
+			glm::vec3 p = (v.Position - center) / extent;
+			q.Position[0] = ToSnorm16(p.x);
+			q.Position[1] = ToSnorm16(p.y);
+			q.Position[2] = ToSnorm16(p.z);
+			PackNormal(v.Normal, q.Normal);
+			PackTangent(glm::vec3(v.Tangent), v.Tangent.w, q.Tangent);
+			q.UV[0] = glm::packHalf1x16(v.UV.x);
+			q.UV[1] = glm::packHalf1x16(v.UV.y);
+		}
+		else
+		{
+			PackedVertex& q = reinterpret_cast<PackedVertex*>(out.data())[i];
+			q.Position[0] = v.Position.x;
+			q.Position[1] = v.Position.y;
+			q.Position[2] = v.Position.z;
+			PackNormal(v.Normal, q.Normal);
+			PackTangent(glm::vec3(v.Tangent), v.Tangent.w, q.Tangent);
+			q.UV[0] = glm::packHalf1x16(v.UV.x);
+			q.UV[1] = glm::packHalf1x16(v.UV.y);
+		}
+	}
 }
 
 // Create cube with normal mapping support
-Mesh* Mesh::CreateCube()
+Mesh* Mesh::CreateCube(VertexFormat format)
 {
 	std::vector<Vertex> v;
 	std::vector<unsigned int> idx;
@@ -137,10 +419,10 @@ Mesh* Mesh::CreateCube()
 		{
 			unsigned int start = v.size();
 
-			v.push_back({ a, normal, {0,0}, glm::vec3(0) });
-			v.push_back({ b, normal, {1,0}, glm::vec3(0) });
-			v.push_back({ c, normal, {1,1}, glm::vec3(0) });
-			v.push_back({ d, normal, {0,1}, glm::vec3(0) });
+			v.push_back({ a, normal, {0,0}, glm::vec4(0) });
+			v.push_back({ b, normal, {1,0}, glm::vec4(0) });
+			v.push_back({ c, normal, {1,1}, glm::vec4(0) });
+			v.push_back({ d, normal, {0,1}, glm::vec4(0) });
 
 			idx.push_back(start + 0);
 			idx.push_back(start + 1);
@@ -157,5 +439,47 @@ Mesh* Mesh::CreateCube()
 	PushFace({ -0.5,0.5,-0.5 }, { 0.5,0.5,-0.5 }, { 0.5,0.5, 0.5 }, { -0.5,0.5, 0.5 }, { 0,1,0 });
 	PushFace({ -0.5,-0.5,-0.5 }, { 0.5,-0.5,-0.5 }, { 0.5,-0.5, 0.5 }, { -0.5,-0.5, 0.5 }, { 0,-1,0 });
 
-	return new Mesh(v, idx);
+	return new Mesh(v, idx, format);
+}
+
+// Create unit sphere (rings run pole to pole, segments around Y)
+Mesh* Mesh::CreateSphere(unsigned int segments, unsigned int rings, VertexFormat format)
+{
+	std::vector<Vertex> v;
+	std::vector<unsigned int> idx;
+
+	for (unsigned int r = 0; r <= rings; r++)
+	{
+		float theta = glm::pi<float>() * r / rings;
+
+		for (unsigned int s = 0; s <= segments; s++)
+		{
+			float phi = glm::two_pi<float>() * s / segments;
+
+			glm::vec3 p(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+			glm::vec4 tangent(-std::sin(phi), 0.0f, std::cos(phi), 1.0f);
+
+			v.push_back({ p, p, { (float)s / segments, (float)r / rings }, tangent });
+		}
+	}
+
+	for (unsigned int r = 0; r < rings; r++)
+	{
+		for (unsigned int s = 0; s < segments; s++)
+		{
+			unsigned int a = r * (segments + 1) + s;
+			unsigned int b = a + segments + 1;   // next ring
+			unsigned int c = a + 1;              // next segment
+			unsigned int d = b + 1;
+
+			idx.push_back(a);
+			idx.push_back(c);
+			idx.push_back(b);
+			idx.push_back(c);
+			idx.push_back(d);
+			idx.push_back(b);
+		}
+	}
+
+	return new Mesh(v, idx, format);
 }
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <glm/glm.hpp>
+#include "Graphics/Bounds.h"
+#include "Graphics/GeometryArena.h"
 
 class Mesh
 {
@@ -11,37 +14,145 @@ public:
 		glm::vec3 Position;
 		glm::vec3 Normal;
 		glm::vec2 UV;
-		glm::vec3 Tangent;
+		glm::vec4 Tangent;   // w = bitangent sign (B = cross(N, T) * w)
+	};
+
+	// GPU layouts of the packed formats. Normal and tangent are octahedral
+	// snorm16; the tangent's second component carries the handedness sign.
+	struct PackedVertex
+	{
+		float    Position[3];
+		int16_t  Normal[2];
+		int16_t  Tangent[2];
+		uint16_t UV[2];          // half floats
+	};
+
+	struct QuantizedVertex
+	{
+		int16_t  Position[4];    // snorm16 over the bounds, w unused (alignment)
+		int16_t  Normal[2];
+		int16_t  Tangent[2];
+		uint16_t UV[2];
+	};
+
+	// One level of detail: a range of the mesh's index data (relative to
+	// the allocation's FirstIndex) drawn over the shared vertex buffer.
+	// Error is the object-space deviation from LOD 0 (conservative).
+	struct LOD
+	{
+		uint32_t FirstIndex = 0;
+		uint32_t IndexCount = 0;
+		float    Error = 0.0f;
+	};
+
+	static constexpr uint32_t MaxLODs = 4;             // including LOD 0
+	static constexpr uint32_t MinLODTriangles = 64;
+
+	// Geometry exactly as the arena stores it: vertices in Format's
+	// layout, IndexSize-byte indices with LOD 0 first (see MeshFile)
+	struct GPUData
+	{
+		VertexFormat     Format = VertexFormat::Float;
+		const void*      Vertices = nullptr;
+		uint32_t         VertexCount = 0;
+		const void*      Indices = nullptr;
+		uint32_t         IndexCount = 0;
+		uint32_t         IndexSize = 4;
+		std::vector<LOD> LODs;
+		AABB             Bounds;
+		BoundingSphere   Sphere;
+		glm::mat4        Dequantization = glm::mat4(1.0f);
 	};
 
 public:
+	// upload = false leaves the GPU side to UploadToGPU(), so the CPU work
+	// (optimization, LODs, tangents) can run off the GL thread
 	Mesh(const std::vector<Vertex>& vertices,
-		const std::vector<unsigned int>& indices);
+		const std::vector<unsigned int>& indices,
+		VertexFormat format = VertexFormat::Float,
+		bool upload = true);
 
 	Mesh(const std::vector<glm::vec3>& positions,
 		const std::vector<glm::vec3>& normals,
 		const std::vector<glm::vec2>& uvs,
-		const std::vector<unsigned int>& indices);
+		const std::vector<unsigned int>& indices,
+		VertexFormat format = VertexFormat::Float);
+
+	// Upload prepared data as is (no optimization, no CPU copy kept);
+	// the pointers only need to live for the call
+	explicit Mesh(const GPUData& data);
 
 	~Mesh();
 
+	// Binds the arena block's shared VAO; draws address the mesh's range
 	void Bind() const;
 	void Draw() const;
+	void DrawInstanced(unsigned int instanceCount, uint32_t lod = 0) const;
 
-	static Mesh* CreateCube();
+	uint32_t GetLODCount() const { return (uint32_t)m_LODs.size(); }
+	const LOD& GetLOD(uint32_t lod) const { return m_LODs[lod]; }
 
+	const GeometryAllocation& GetAllocation() const { return m_Allocation; }
+
+	// GL_UNSIGNED_SHORT for meshes of up to 65536 vertices, else GL_UNSIGNED_INT
+	unsigned int GetIndexType() const;
+	unsigned int GetVertexArray() const { return GeometryArena::GetVertexArray(m_Allocation.Block); }
+
+	VertexFormat GetVertexFormat() const { return m_Format; }
+	bool IsQuantized() const { return m_Format == VertexFormat::PackedQuantized; }
+
+	// Maps quantized positions back to local space; the Renderer folds it
+	// into the model matrix (identity unless quantized). The scale is
+	// uniform so mat3(model) still transforms normals correctly.
+	const glm::mat4& GetDequantization() const { return m_Dequantization; }
+
+	static Mesh* CreateCube(VertexFormat format = VertexFormat::Float);
+
+	// Unit UV sphere, counter-clockwise seen from outside
+	static Mesh* CreateSphere(unsigned int segments, unsigned int rings,
+		VertexFormat format = VertexFormat::Float);
+
+	// MikkTSpace-style tangents with handedness (see TangentGenerator),
+	// splitting vertices on mirror seams; no-op once uploaded
 	void RecalculateTangents();
 
-private:
+	// Copy the mesh into the geometry arena (GL thread, no-op once done).
+	// A successful upload frees the CPU copy of vertices and indices.
 	void UploadToGPU();
+	bool IsUploaded() const { return m_Allocation.IsValid(); }
+
+	// Fill 'data' with this mesh's upload data; the pointers refer to
+	// the storage vectors (or the mesh). False once uploaded and for
+	// meshes built from GPUData, which keep no CPU copy.
+	bool GetGPUData(GPUData& data, std::vector<uint8_t>& vertexStorage,
+		std::vector<uint8_t>& indexStorage) const;
+
+	// Local-space bounds, computed at construction
+	const AABB& GetBounds() const { return m_Bounds; }
+	const BoundingSphere& GetBoundingSphere() const { return m_BoundingSphere; }
+
+private:
+	void Optimize();
+	void BuildLODs();
+	void ComputeBounds();
+	void PackVertices(std::vector<uint8_t>& out) const;
 
 private:
-	unsigned int m_VAO = 0;
-	unsigned int m_VBO = 0;
-	unsigned int m_EBO = 0;
+	GeometryAllocation m_Allocation;
+	VertexFormat       m_Format = VertexFormat::Float;
+	glm::mat4          m_Dequantization = glm::mat4(1.0f);
 
 	unsigned int m_IndexCount = 0;
 
+	// m_LODs[0] covers m_Indices; coarser levels follow it in the index
+	// buffer (m_LODIndices)
+	std::vector<LOD>      m_LODs;
+	std::vector<uint32_t> m_LODIndices;
+
+	AABB           m_Bounds;
+	BoundingSphere m_BoundingSphere;
+
+	// CPU copy, released by UploadToGPU
 	std::vector<Vertex> m_Vertices;
 	std::vector<unsigned int> m_Indices;
 };
@@ -0,0 +1,331 @@
+#include "MeshFile.h"
+#include "Graphics/ObjImporter.h"
+#include "Utils/FileSystem.h"
+#include "Utils/Log.h"
+#include "Utils/MappedFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+const char* MeshFile::s_CacheDirectory = "cache/meshes";
+
+namespace
+{
+	struct FileHeader
+	{
+		char     Magic[4];          // "GHMF"
+		uint32_t Version;
+		uint32_t Format;            // VertexFormat
+		uint32_t VertexStride;
+		uint32_t VertexCount;
+		uint32_t IndexSize;         // 2 or 4
+		uint32_t IndexCount;        // all LODs
+		uint32_t AttributeCount;
+		uint32_t LODCount;
+		uint32_t ImportVersion;     // MeshFile::ImportVersion
+		float    BoundsMin[3];
+		float    BoundsMax[3];
+		float    Sphere[4];         // center, radius
+		float    Dequantization[16];
+		uint64_t AttributeOffset;
+		uint64_t LODOffset;
+		uint64_t VertexOffset;
+		uint64_t IndexOffset;
+		uint64_t SourceSize;        // MeshFile::Source
+		int64_t  SourceTime;
+	};
+
+	struct FileLOD
+	{
+		uint32_t FirstIndex;
+		uint32_t IndexCount;
+		float    Error;
+	};
+
+	static_assert(sizeof(FileHeader) == 192, "FileHeader must not contain padding");
+
+	constexpr uint32_t FileVersion = 2;
+	constexpr size_t   BlobAlignment = 16;
+
+	size_t Align(size_t offset)
+	{
+		return (offset + BlobAlignment - 1) & ~(BlobAlignment - 1);
+	}
+
+	bool InFile(uint64_t offset, uint64_t size, size_t fileSize)
+	{
+		return offset <= fileSize && size <= fileSize - offset;
+	}
+
+	// FNV-1a (64-bit) of the cache key + format, names the cache entry
+	uint64_t HashKey(const std::string& path, VertexFormat format)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		for (char c : path)
+		{
+			hash ^= (uint8_t)c;
+			hash *= 1099511628211ull;
+		}
+		hash ^= (uint8_t)format;
+		hash *= 1099511628211ull;
+		return hash;
+	}
+}
+
+// ------------------------------------------------------------
+// Validate, then upload from the mapping
+// ------------------------------------------------------------
+Mesh* MeshFile::Load(const std::string& path)
+{
+	MappedFile file;
+	if (!file.Open(path))
+	{
+		Log::Error("Failed to open mesh file: " + path);
+		return nullptr;
+	}
+
+	const uint8_t* bytes = static_cast<const uint8_t*>(file.GetData());
+	const size_t size = file.GetSize();
+
+	FileHeader header;
+	if (size < sizeof(header))
+	{
+		Log::Error("Mesh file is truncated: " + path);
+		return nullptr;
+	}
+	std::memcpy(&header, bytes, sizeof(header));
+
+	if (std::memcmp(header.Magic, "GHMF", 4) != 0 || header.Version != FileVersion)
+	{
+		Log::Error("Not a mesh file of version " + std::to_string(FileVersion) + ": " + path);
+		return nullptr;
+	}
+
+	if (header.Format > (uint32_t)VertexFormat::PackedQuantized)
+	{
+		Log::Error("Mesh file has an unknown vertex format: " + path);
+		return nullptr;
+	}
+
+	const VertexFormat format = (VertexFormat)header.Format;
+	VertexAttribute layout[GeometryArena::VertexAttributeCount];
+	GeometryArena::GetVertexLayout(format, layout);
+
+	if (header.VertexStride != GeometryArena::GetVertexStride(format) ||
+		header.AttributeCount != GeometryArena::VertexAttributeCount ||
+		(header.IndexSize != 2 && header.IndexSize != 4) ||
+		header.LODCount == 0 || header.LODCount > Mesh::MaxLODs ||
+		header.VertexCount == 0 || header.IndexCount == 0 ||
+		(header.IndexSize == 2 && header.VertexCount > 65536) ||
+		!InFile(header.AttributeOffset, sizeof(layout), size) ||
+		!InFile(header.LODOffset, (uint64_t)header.LODCount * sizeof(FileLOD), size) ||
+		!InFile(header.VertexOffset, (uint64_t)header.VertexCount * header.VertexStride, size) ||
+		!InFile(header.IndexOffset, (uint64_t)header.IndexCount * header.IndexSize, size) ||
+		std::memcmp(bytes + header.AttributeOffset, layout, sizeof(layout)) != 0)
+	{
+		Log::Error("Mesh file does not match this build's vertex layout or is corrupt: " + path);
+		return nullptr;
+	}
+
+	Mesh::GPUData data;
+	data.Format = format;
+	data.Vertices = bytes + header.VertexOffset;
+	data.VertexCount = header.VertexCount;
+	data.Indices = bytes + header.IndexOffset;
+	data.IndexCount = header.IndexCount;
+	data.IndexSize = header.IndexSize;
+	data.Bounds.Min = glm::vec3(header.BoundsMin[0], header.BoundsMin[1], header.BoundsMin[2]);
+	data.Bounds.Max = glm::vec3(header.BoundsMax[0], header.BoundsMax[1], header.BoundsMax[2]);
+	data.Sphere.Center = glm::vec3(header.Sphere[0], header.Sphere[1], header.Sphere[2]);
+	data.Sphere.Radius = header.Sphere[3];
+	std::memcpy(&data.Dequantization[0][0], header.Dequantization, sizeof(header.Dequantization));
+
+	for (uint32_t i = 0; i < header.LODCount; i++)
+	{
+		FileLOD lod;
+		std::memcpy(&lod, bytes + header.LODOffset + i * sizeof(FileLOD), sizeof(lod));
+		if (lod.FirstIndex > header.IndexCount || lod.IndexCount > header.IndexCount - lod.FirstIndex ||
+			lod.IndexCount % 3 != 0)
+		{
+			Log::Error("Mesh file has an invalid LOD range: " + path);
+			return nullptr;
+		}
+		data.LODs.push_back({ lod.FirstIndex, lod.IndexCount, lod.Error });
+	}
+
+	// Out-of-range indices would read past the mesh's vertices in the
+	// shared arena buffer
+	uint32_t maxIndex = 0;
+	if (header.IndexSize == 2)
+	{
+		const uint16_t* indices = reinterpret_cast<const uint16_t*>(bytes + header.IndexOffset);
+		for (uint32_t i = 0; i < header.IndexCount; i++)
+			maxIndex = std::max<uint32_t>(maxIndex, indices[i]);
+	}
+	else
+	{
+		const uint32_t* indices = reinterpret_cast<const uint32_t*>(bytes + header.IndexOffset);
+		for (uint32_t i = 0; i < header.IndexCount; i++)
+			maxIndex = std::max(maxIndex, indices[i]);
+	}
+	if (maxIndex >= header.VertexCount)
+	{
+		Log::Error("Mesh file has indices past its vertices: " + path);
+		return nullptr;
+	}
+
+	return new Mesh(data);
+}
+
+// ------------------------------------------------------------
+// Header, layout and LOD table, then the aligned blobs
+// ------------------------------------------------------------
+bool MeshFile::Write(const std::string& path, const Mesh& mesh, const Source& source)
+{
+	Mesh::GPUData data;
+	std::vector<uint8_t> vertexStorage, indexStorage;
+	if (!mesh.GetGPUData(data, vertexStorage, indexStorage))
+	{
+		Log::Error("Mesh has no CPU data to write: " + path);
+		return false;
+	}
+
+	FileHeader header = {};
+	std::memcpy(header.Magic, "GHMF", 4);
+	header.Version = FileVersion;
+	header.Format = (uint32_t)data.Format;
+	header.VertexStride = GeometryArena::GetVertexStride(data.Format);
+	header.VertexCount = data.VertexCount;
+	header.IndexSize = data.IndexSize;
+	header.IndexCount = data.IndexCount;
+	header.AttributeCount = GeometryArena::VertexAttributeCount;
+	header.LODCount = (uint32_t)data.LODs.size();
+	header.ImportVersion = ImportVersion;
+	header.SourceSize = source.Size;
+	header.SourceTime = source.Time;
+	std::memcpy(header.BoundsMin, &data.Bounds.Min[0], sizeof(header.BoundsMin));
+	std::memcpy(header.BoundsMax, &data.Bounds.Max[0], sizeof(header.BoundsMax));
+	std::memcpy(header.Sphere, &data.Sphere.Center[0], sizeof(float) * 3);
+	header.Sphere[3] = data.Sphere.Radius;
+	std::memcpy(header.Dequantization, &data.Dequantization[0][0], sizeof(header.Dequantization));
+
+	VertexAttribute layout[GeometryArena::VertexAttributeCount];
+	GeometryArena::GetVertexLayout(data.Format, layout);
+
+	const size_t vertexBytes = (size_t)data.VertexCount * header.VertexStride;
+	const size_t indexBytes = (size_t)data.IndexCount * data.IndexSize;
+	header.AttributeOffset = sizeof(header);
+	header.LODOffset = header.AttributeOffset + sizeof(layout);
+	header.VertexOffset = Align(header.LODOffset + data.LODs.size() * sizeof(FileLOD));
+	header.IndexOffset = Align(header.VertexOffset + vertexBytes);
+
+	std::vector<uint8_t> file(header.IndexOffset + indexBytes, 0);
+	std::memcpy(file.data(), &header, sizeof(header));
+	std::memcpy(file.data() + header.AttributeOffset, layout, sizeof(layout));
+	for (size_t i = 0; i < data.LODs.size(); i++)
+	{
+		FileLOD lod = { data.LODs[i].FirstIndex, data.LODs[i].IndexCount, data.LODs[i].Error };
+		std::memcpy(file.data() + header.LODOffset + i * sizeof(FileLOD), &lod, sizeof(lod));
+	}
+	std::memcpy(file.data() + header.VertexOffset, data.Vertices, vertexBytes);
+	std::memcpy(file.data() + header.IndexOffset, data.Indices, indexBytes);
+
+	if (!FileSystem::WriteBinaryFile(path, file.data(), file.size()))
+	{
+		Log::Error("Failed to write mesh file: " + path);
+		return false;
+	}
+	return true;
+}
+
+// ------------------------------------------------------------
+// Source model -> Mesh (optimized, LODs, tangents; not uploaded)
+// ------------------------------------------------------------
+Mesh* MeshFile::Import(const std::string& sourcePath, VertexFormat format)
+{
+	std::vector<Mesh::Vertex> vertices;
+	std::vector<uint32_t> indices;
+	if (!ObjImporter::Load(sourcePath, vertices, indices))
+		return nullptr;
+
+	return new Mesh(vertices, indices, format, false);
+}
+
+bool MeshFile::Convert(const std::string& sourcePath, const std::string& outputPath, VertexFormat format)
+{
+	Mesh* mesh = Import(sourcePath, format);
+	if (!mesh)
+		return false;
+
+	bool written = Write(outputPath, *mesh, GetSource(sourcePath));
+	delete mesh;
+	return written;
+}
+
+// ------------------------------------------------------------
+// Fresh cache entry -> mapped load; otherwise import and
+// refresh the entry (the imported mesh is returned as is)
+// ------------------------------------------------------------
+Mesh* MeshFile::LoadCached(const std::string& sourcePath, VertexFormat format)
+{
+	const std::string cachePath = GetCachePath(sourcePath, format);
+	const Source source = GetSource(sourcePath);
+	if (IsCacheFresh(cachePath, source))
+	{
+		if (Mesh* mesh = Load(cachePath))
+			return mesh;
+		Log::Warn("Mesh cache entry rejected, reimporting: " + sourcePath);
+	}
+
+	Mesh* mesh = Import(sourcePath, format);
+	if (!mesh)
+		return nullptr;
+
+	if (CreateCacheDirectory())
+		Write(cachePath, *mesh, source);
+	mesh->UploadToGPU();
+	return mesh;
+}
+
+std::string MeshFile::GetCachePath(const std::string& key, VertexFormat format)
+{
+	char name[32];
+	std::snprintf(name, sizeof(name), "%016llx.mesh", (unsigned long long)HashKey(key, format));
+	return std::string(s_CacheDirectory) + "/" + name;
+}
+
+// ------------------------------------------------------------
+// Only the header is read; Load() validates the rest
+// ------------------------------------------------------------
+bool MeshFile::IsCacheFresh(const std::string& cachePath, const Source& source)
+{
+	std::ifstream file(cachePath, std::ios::binary);
+	FileHeader header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+		return false;
+
+	return std::memcmp(header.Magic, "GHMF", 4) == 0 && header.Version == FileVersion &&
+		header.ImportVersion == ImportVersion &&
+		header.SourceSize == source.Size && header.SourceTime == source.Time;
+}
+
+MeshFile::Source MeshFile::GetSource(const std::string& path)
+{
+	Source source;
+	source.Add(path);
+	return source;
+}
+
+void MeshFile::Source::Add(const std::string& path)
+{
+	Size += FileSystem::GetFileSize(path);
+	Time = std::max(Time, FileSystem::GetModificationTime(path));
+}
+
+bool MeshFile::CreateCacheDirectory()
+{
+	return FileSystem::CreateDirectories(s_CacheDirectory);
+}
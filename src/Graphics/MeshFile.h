@@ -0,0 +1,81 @@
+#pragma once
+
+#include <string>
+#include "Graphics/Mesh.h"
+
+// -----------------------------------------------------------------------------
+// MeshFile -- versioned binary mesh container (.mesh). Vertex and index data
+// are stored exactly as the GeometryArena wants them (see Mesh::GPUData), so
+// loading maps the file and uploads straight from the mapping: no parsing,
+// no intermediate copies, bound by disk bandwidth.
+//
+// Layout (little endian, all offsets from the start of the file):
+//   header       magic "GHMF", version, format, counts, bounds, offsets
+//   attributes   VertexAttribute[AttributeCount] the file was written with
+//   LODs         { FirstIndex, IndexCount, Error }[LODCount]
+//   vertices     VertexCount * VertexStride bytes   (16-byte aligned)
+//   indices      IndexCount * IndexSize bytes       (16-byte aligned)
+// The attribute layout must match GetVertexLayout() of the stored format;
+// files from an incompatible build are rejected rather than misread.
+//
+// Imported models are cached as .mesh files under cache/meshes: OBJ files
+// through LoadCached(), glTF primitives by GltfImporter. "GraphicHW
+// --convert <file>" fills the cache (or writes one .mesh) without a window.
+// Each file records the size and write time of its source and the
+// ImportVersion it was built with; a cache entry is reused only if all
+// three still match exactly.
+// -----------------------------------------------------------------------------
+class MeshFile
+{
+public:
+	// Bump whenever the import pipeline's output changes (optimization,
+	// LODs, tangents), so existing cache entries are rebuilt
+	static constexpr uint32_t ImportVersion = 2;
+
+	// Identity of the file(s) a mesh was converted from. Multi-file
+	// sources (glTF + buffers) sum the sizes and keep the newest time.
+	struct Source
+	{
+		uint64_t Size = 0;
+		int64_t  Time = 0;   // FileSystem::GetModificationTime
+
+		void Add(const std::string& path);
+	};
+
+	static Source GetSource(const std::string& path);
+
+	// Map and upload a .mesh file (GL context required); null on error
+	static Mesh* Load(const std::string& path);
+
+	// Serialize a mesh that still has its CPU copy (not yet uploaded);
+	// 'source' is recorded for IsCacheFresh
+	static bool Write(const std::string& path, const Mesh& mesh, const Source& source);
+
+	// Import a source model (.obj) in the given format and write it out;
+	// no GL context needed
+	static bool Convert(const std::string& sourcePath, const std::string& outputPath,
+		VertexFormat format = VertexFormat::Float);
+
+	// Load 'sourcePath' through cache/meshes, converting it first if the
+	// cached file is missing or was built from a different source
+	static Mesh* LoadCached(const std::string& sourcePath, VertexFormat format = VertexFormat::Float);
+
+	// Cache entry for 'key' -- a source path, or a path plus the part of
+	// it for files holding several meshes ("scene.gltf#mesh3/primitive0")
+	static std::string GetCachePath(const std::string& key, VertexFormat format);
+
+	// The entry exists, was written by this ImportVersion and records
+	// exactly 'source'
+	static bool IsCacheFresh(const std::string& cachePath, const Source& source);
+
+	// Call before writing entries (not thread-safe; writes are)
+	static bool CreateCacheDirectory();
+
+private:
+	MeshFile() = delete;
+
+	static Mesh* Import(const std::string& sourcePath, VertexFormat format);
+
+private:
+	static const char* s_CacheDirectory;
+};
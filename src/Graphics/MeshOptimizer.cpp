@@ -0,0 +1,567 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <numeric>
+
+namespace
+{
+	// Forsyth, "Linear-Speed Vertex Cache Optimisation" -- default tuning
+	constexpr uint32_t ScoreCacheSize = 32;
+	constexpr float    CacheDecayPower = 1.5f;
+	constexpr float    LastTriangleScore = 0.75f;
+	constexpr float    ValenceBoostScale = 2.0f;
+	constexpr float    ValenceBoostPower = 0.5f;
+	constexpr uint32_t ValenceTableSize = 32;
+
+	struct ScoreTables
+	{
+		float Cache[ScoreCacheSize];
+		float Valence[ValenceTableSize];
+
+		ScoreTables()
+		{
+			for (uint32_t i = 0; i < ScoreCacheSize; i++)
+			{
+				// The three vertices of the last triangle get a fixed score so
+				// the same triangle's neighbours are not unduly favoured
+				Cache[i] = i < 3 ? LastTriangleScore :
+					std::pow(1.0f - (float)(i - 3) / (ScoreCacheSize - 3), CacheDecayPower);
+			}
+
+			Valence[0] = 0.0f;
+			for (uint32_t i = 1; i < ValenceTableSize; i++)
+				Valence[i] = ValenceBoostScale * std::pow((float)i, -ValenceBoostPower);
+		}
+	};
+
+	const ScoreTables& GetScoreTables()
+	{
+		static const ScoreTables tables;
+		return tables;
+	}
+
+	// Few remaining triangles = boost, so lone triangles are not stranded
+	float VertexScore(int cachePosition, uint32_t liveTriangles)
+	{
+		if (liveTriangles == 0)
+			return -1.0f;
+
+		const ScoreTables& tables = GetScoreTables();
+		float score = cachePosition >= 0 ? tables.Cache[cachePosition] : 0.0f;
+		return score + tables.Valence[std::min(liveTriangles, ValenceTableSize - 1)];
+	}
+}
+
+// ------------------------------------------------------------
+// Greedy: emit the best-scoring triangle touching the cache,
+// rescoring only the vertices that moved in the cache
+// ------------------------------------------------------------
+void MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount)
+{
+	const uint32_t triangleCount = (uint32_t)(indices.size() / 3);
+	if (triangleCount == 0 || vertexCount == 0)
+		return;
+
+	// Vertex -> triangle adjacency (live entries at the front of each range)
+	std::vector<uint32_t> liveTriangles(vertexCount, 0);
+	for (uint32_t index : indices)
+		liveTriangles[index]++;
+
+	std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+	for (uint32_t v = 0; v < vertexCount; v++)
+		adjacencyOffsets[v + 1] = adjacencyOffsets[v] + liveTriangles[v];
+
+	std::vector<uint32_t> adjacency(indices.size());
+	{
+		std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+		for (uint32_t t = 0; t < triangleCount; t++)
+		{
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				uint32_t v = indices[t * 3 + k];
+				adjacency[fill[v]++] = t;
+			}
+		}
+	}
+
+	std::vector<int>   cachePosition(vertexCount, -1);
+	std::vector<float> vertexScores(vertexCount);
+	for (uint32_t v = 0; v < vertexCount; v++)
+		vertexScores[v] = VertexScore(-1, liveTriangles[v]);
+
+	std::vector<float> triangleScores(triangleCount);
+	std::vector<bool>  emitted(triangleCount, false);
+	for (uint32_t t = 0; t < triangleCount; t++)
+	{
+		triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] +
+			vertexScores[indices[t * 3 + 2]];
+	}
+
+	std::vector<uint32_t> output;
+	output.reserve(indices.size());
+
+	std::vector<uint32_t> cache, nextCache;
+	cache.reserve(ScoreCacheSize + 3);
+	nextCache.reserve(ScoreCacheSize + 3);
+
+	uint32_t best = (uint32_t)(std::max_element(triangleScores.begin(), triangleScores.end()) - triangleScores.begin());
+	uint32_t scanCursor = 0;
+
+	for (uint32_t emittedCount = 0; emittedCount < triangleCount; emittedCount++)
+	{
+		// Dead end: nothing in the cache has live triangles -- continue
+		// with the next unemitted triangle in input order
+		if (best == UINT32_MAX)
+		{
+			while (emitted[scanCursor])
+				scanCursor++;
+			best = scanCursor;
+		}
+
+		const uint32_t* triangle = &indices[best * 3];
+		output.insert(output.end(), triangle, triangle + 3);
+		emitted[best] = true;
+
+		// Drop the triangle from its vertices' live ranges
+		for (uint32_t k = 0; k < 3; k++)
+		{
+			uint32_t v = triangle[k];
+			uint32_t* first = &adjacency[adjacencyOffsets[v]];
+			uint32_t* last = first + liveTriangles[v] - 1;
+			std::iter_swap(std::find(first, last + 1, best), last);
+			liveTriangles[v]--;
+		}
+
+		// New cache order: this triangle first, then the previous contents
+		nextCache.assign(triangle, triangle + 3);
+		for (uint32_t v : cache)
+		{
+			if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+				nextCache.push_back(v);
+		}
+		cache.swap(nextCache);
+
+		// Rescore the cached vertices (and those just pushed out), then
+		// their live triangles; the best of those is the next candidate
+		for (uint32_t i = 0; i < (uint32_t)cache.size(); i++)
+		{
+			uint32_t v = cache[i];
+			cachePosition[v] = i < ScoreCacheSize ? (int)i : -1;
+			vertexScores[v] = VertexScore(cachePosition[v], liveTriangles[v]);
+		}
+
+		best = UINT32_MAX;
+		float bestScore = -1.0f;
+		for (uint32_t v : cache)
+		{
+			for (uint32_t i = 0; i < liveTriangles[v]; i++)
+			{
+				uint32_t t = adjacency[adjacencyOffsets[v] + i];
+				float score = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] +
+					vertexScores[indices[t * 3 + 2]];
+				triangleScores[t] = score;
+
+				if (score > bestScore)
+				{
+					bestScore = score;
+					best = t;
+				}
+			}
+		}
+
+		if (cache.size() > ScoreCacheSize)
+			cache.resize(ScoreCacheSize);
+	}
+
+	indices.swap(output);
+}
+
+// ------------------------------------------------------------
+// Overdraw: split at full-miss triangles, sort the clusters by
+// how far they face away from the mesh centre (outermost first)
+// ------------------------------------------------------------
+void MeshOptimizer::OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<glm::vec3>& positions)
+{
+	const uint32_t triangleCount = (uint32_t)(indices.size() / 3);
+	if (triangleCount < 2)
+		return;
+
+	// Cluster starts from a FIFO cache simulation
+	std::vector<uint32_t> clusterStarts;
+	std::vector<uint32_t> cacheTime(positions.size(), 0);
+	uint32_t time = FifoCacheSize + 1;
+
+	for (uint32_t t = 0; t < triangleCount; t++)
+	{
+		uint32_t misses = 0;
+		for (uint32_t k = 0; k < 3; k++)
+		{
+			uint32_t v = indices[t * 3 + k];
+			if (time - cacheTime[v] > FifoCacheSize)
+			{
+				cacheTime[v] = time++;
+				misses++;
+			}
+		}
+
+		if (misses == 3 || t == 0)
+			clusterStarts.push_back(t);
+	}
+	clusterStarts.push_back(triangleCount);
+
+	const uint32_t clusterCount = (uint32_t)clusterStarts.size() - 1;
+	if (clusterCount < 2)
+		return;
+
+	// Area-weighted centroid and normal per cluster (|cross| = 2 * area)
+	std::vector<glm::vec3> clusterCentroids(clusterCount, glm::vec3(0.0f));
+	std::vector<glm::vec3> clusterNormals(clusterCount, glm::vec3(0.0f));
+	glm::vec3 meshCentroid(0.0f);
+	float meshArea = 0.0f;
+
+	for (uint32_t c = 0; c < clusterCount; c++)
+	{
+		float clusterArea = 0.0f;
+		for (uint32_t t = clusterStarts[c]; t < clusterStarts[c + 1]; t++)
+		{
+			const glm::vec3& p0 = positions[indices[t * 3]];
+			const glm::vec3& p1 = positions[indices[t * 3 + 1]];
+			const glm::vec3& p2 = positions[indices[t * 3 + 2]];
+
+			glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+			float area = glm::length(normal);
+			glm::vec3 centroid = (p0 + p1 + p2) / 3.0f;
+
+			clusterCentroids[c] += centroid * area;
+			clusterNormals[c] += normal;
+			clusterArea += area;
+		}
+
+		meshCentroid += clusterCentroids[c];
+		meshArea += clusterArea;
+		clusterCentroids[c] = clusterArea > 0.0f ? clusterCentroids[c] / clusterArea :
+			positions[indices[clusterStarts[c] * 3]];
+	}
+
+	if (meshArea > 0.0f)
+		meshCentroid /= meshArea;
+
+	std::vector<float> sortKeys(clusterCount);
+	for (uint32_t c = 0; c < clusterCount; c++)
+	{
+		float length = glm::length(clusterNormals[c]);
+		sortKeys[c] = length > 0.0f ?
+			glm::dot(clusterCentroids[c] - meshCentroid, clusterNormals[c] / length) : 0.0f;
+	}
+
+	std::vector<uint32_t> order(clusterCount);
+	std::iota(order.begin(), order.end(), 0u);
+	std::stable_sort(order.begin(), order.end(),
+		[&](uint32_t a, uint32_t b) { return sortKeys[a] > sortKeys[b]; });
+
+	std::vector<uint32_t> output;
+	output.reserve(indices.size());
+	for (uint32_t c : order)
+	{
+		output.insert(output.end(),
+			indices.begin() + clusterStarts[c] * 3, indices.begin() + clusterStarts[c + 1] * 3);
+	}
+
+	indices.swap(output);
+}
+
+// ------------------------------------------------------------
+// First-use order = vertices are fetched roughly sequentially
+// ------------------------------------------------------------
+uint32_t MeshOptimizer::OptimizeVertexFetch(std::vector<uint32_t>& indices, uint32_t vertexCount,
+	std::vector<uint32_t>& remap)
+{
+	remap.assign(vertexCount, UINT32_MAX);
+
+	uint32_t next = 0;
+	for (uint32_t& index : indices)
+	{
+		if (remap[index] == UINT32_MAX)
+			remap[index] = next++;
+		index = remap[index];
+	}
+
+	return next;
+}
+
+float MeshOptimizer::ComputeACMR(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize)
+{
+	const size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0)
+		return 0.0f;
+
+	std::vector<uint32_t> cacheTime(vertexCount, 0);
+	uint32_t time = cacheSize + 1;
+	uint32_t misses = 0;
+
+	for (size_t i = 0; i < triangleCount * 3; i++)
+	{
+		uint32_t v = indices[i];
+		if (time - cacheTime[v] > cacheSize)
+		{
+			cacheTime[v] = time++;
+			misses++;
+		}
+	}
+
+	return (float)misses / (float)triangleCount;
+}
+
+// ============================================================
+// Simplification
+// ============================================================
+namespace
+{
+	// Symmetric 4x4 plane quadric, area weighted; Evaluate() / Weight
+	// is the mean squared distance to the accumulated planes
+	struct Quadric
+	{
+		double A00 = 0, A01 = 0, A02 = 0, A03 = 0;
+		double A11 = 0, A12 = 0, A13 = 0;
+		double A22 = 0, A23 = 0;
+		double A33 = 0;
+		double Weight = 0;
+
+		void AddPlane(const glm::dvec3& n, double d, double weight)
+		{
+			A00 += weight * n.x * n.x; A01 += weight * n.x * n.y; A02 += weight * n.x * n.z; A03 += weight * n.x * d;
+			A11 += weight * n.y * n.y; A12 += weight * n.y * n.z; A13 += weight * n.y * d;
+			A22 += weight * n.z * n.z; A23 += weight * n.z * d;
+			A33 += weight * d * d;
+			Weight += weight;
+		}
+
+		void Add(const Quadric& q)
+		{
+			A00 += q.A00; A01 += q.A01; A02 += q.A02; A03 += q.A03;
+			A11 += q.A11; A12 += q.A12; A13 += q.A13;
+			A22 += q.A22; A23 += q.A23;
+			A33 += q.A33;
+			Weight += q.Weight;
+		}
+
+		double Evaluate(const glm::vec3& p) const
+		{
+			double x = p.x, y = p.y, z = p.z;
+			double error = A00 * x * x + 2 * A01 * x * y + 2 * A02 * x * z + 2 * A03 * x +
+				A11 * y * y + 2 * A12 * y * z + 2 * A13 * y +
+				A22 * z * z + 2 * A23 * z + A33;
+			return std::max(error, 0.0);
+		}
+	};
+
+	struct Collapse
+	{
+		uint32_t From;
+		uint32_t To;
+		double   Error;   // mean squared distance
+	};
+
+	double CollapseError(const std::vector<Quadric>& quadrics, const std::vector<glm::vec3>& positions,
+		uint32_t from, uint32_t to)
+	{
+		Quadric q = quadrics[from];
+		q.Add(quadrics[to]);
+		return q.Weight > 0.0 ? q.Evaluate(positions[to]) / q.Weight : 0.0;
+	}
+
+	uint64_t EdgeKey(uint32_t a, uint32_t b)
+	{
+		return a < b ? ((uint64_t)a << 32) | b : ((uint64_t)b << 32) | a;
+	}
+}
+
+float MeshOptimizer::Simplify(std::vector<uint32_t>& indices, const std::vector<glm::vec3>& positions,
+	size_t targetIndexCount, float targetError)
+{
+	const uint32_t vertexCount = (uint32_t)positions.size();
+	const double maxError = (double)targetError * targetError;
+
+	// Plane quadrics of the input triangles
+	std::vector<Quadric> quadrics(vertexCount);
+	for (size_t i = 0; i + 2 < indices.size(); i += 3)
+	{
+		glm::dvec3 p0 = positions[indices[i]];
+		glm::dvec3 p1 = positions[indices[i + 1]];
+		glm::dvec3 p2 = positions[indices[i + 2]];
+
+		glm::dvec3 normal = glm::cross(p1 - p0, p2 - p0);
+		double area = glm::length(normal);
+		if (area <= 0.0)
+			continue;
+
+		normal /= area;
+		for (uint32_t k = 0; k < 3; k++)
+			quadrics[indices[i + k]].AddPlane(normal, -glm::dot(normal, p0), area * 0.5);
+	}
+
+	// Edges used by a single triangle are open -- lock their vertices
+	std::vector<bool> locked(vertexCount, false);
+	{
+		std::vector<uint64_t> edges;
+		edges.reserve(indices.size());
+		for (size_t i = 0; i + 2 < indices.size(); i += 3)
+		{
+			for (uint32_t k = 0; k < 3; k++)
+				edges.push_back(EdgeKey(indices[i + k], indices[i + (k + 1) % 3]));
+		}
+		std::sort(edges.begin(), edges.end());
+
+		for (size_t i = 0; i < edges.size();)
+		{
+			size_t j = i + 1;
+			while (j < edges.size() && edges[j] == edges[i])
+				j++;
+			if (j - i == 1)
+			{
+				locked[(uint32_t)(edges[i] >> 32)] = true;
+				locked[(uint32_t)edges[i]] = true;
+			}
+			i = j;
+		}
+	}
+
+	std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+	std::vector<uint32_t> adjacency;
+	std::vector<Collapse> candidates;
+	std::vector<bool>     touched(vertexCount);
+	double worstError = 0.0;
+
+	// Passes of independent collapses (each vertex at most once per pass)
+	while (indices.size() > targetIndexCount)
+	{
+		const uint32_t triangleCount = (uint32_t)(indices.size() / 3);
+
+		std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0u);
+		for (uint32_t index : indices)
+			adjacencyOffsets[index + 1]++;
+		for (uint32_t v = 0; v < vertexCount; v++)
+			adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+
+		adjacency.resize(indices.size());
+		{
+			std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (uint32_t t = 0; t < triangleCount; t++)
+			{
+				for (uint32_t k = 0; k < 3; k++)
+					adjacency[fill[indices[t * 3 + k]]++] = t;
+			}
+		}
+
+		// Cheaper direction of every edge
+		candidates.clear();
+		for (uint32_t t = 0; t < triangleCount; t++)
+		{
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				uint32_t a = indices[t * 3 + k];
+				uint32_t b = indices[t * 3 + (k + 1) % 3];
+				if (a > b)
+					continue;   // each interior edge is seen twice
+
+				double ab = locked[a] ? DBL_MAX : CollapseError(quadrics, positions, a, b);
+				double ba = locked[b] ? DBL_MAX : CollapseError(quadrics, positions, b, a);
+				if (ab == DBL_MAX && ba == DBL_MAX)
+					continue;
+
+				candidates.push_back(ab <= ba ? Collapse{ a, b, ab } : Collapse{ b, a, ba });
+			}
+		}
+
+		std::sort(candidates.begin(), candidates.end(),
+			[](const Collapse& x, const Collapse& y) { return x.Error < y.Error; });
+
+		// Each collapse removes about two triangles; leave some for the
+		// next pass so collapses see up-to-date quadrics
+		size_t collapseBudget = std::max<size_t>((indices.size() - targetIndexCount) / 6, 1);
+		size_t collapsed = 0;
+		bool errorLimitReached = false;
+
+		std::fill(touched.begin(), touched.end(), false);
+
+		for (const Collapse& collapse : candidates)
+		{
+			if (collapsed >= collapseBudget)
+				break;
+
+			if (collapse.Error > maxError)
+			{
+				errorLimitReached = true;
+				break;
+			}
+
+			if (touched[collapse.From] || touched[collapse.To])
+				continue;
+
+			// Reject collapses that would flip (or turn by more than ~75 deg)
+			// a surviving triangle
+			bool flips = false;
+			for (uint32_t i = adjacencyOffsets[collapse.From]; i < adjacencyOffsets[collapse.From + 1] && !flips; i++)
+			{
+				const uint32_t* triangle = &indices[adjacency[i] * 3];
+				if (triangle[0] == collapse.To || triangle[1] == collapse.To || triangle[2] == collapse.To)
+					continue;
+
+				glm::vec3 before[3], after[3];
+				for (uint32_t k = 0; k < 3; k++)
+				{
+					before[k] = positions[triangle[k]];
+					after[k] = triangle[k] == collapse.From ? positions[collapse.To] : before[k];
+				}
+
+				glm::vec3 n0 = glm::cross(before[1] - before[0], before[2] - before[0]);
+				glm::vec3 n1 = glm::cross(after[1] - after[0], after[2] - after[0]);
+				flips = glm::dot(n0, n1) <= 0.25f * glm::length(n0) * glm::length(n1);
+			}
+			if (flips)
+				continue;
+
+			// Apply: the vertex's triangles now use the target
+			for (uint32_t i = adjacencyOffsets[collapse.From]; i < adjacencyOffsets[collapse.From + 1]; i++)
+			{
+				uint32_t* triangle = &indices[adjacency[i] * 3];
+				for (uint32_t k = 0; k < 3; k++)
+				{
+					if (triangle[k] == collapse.From)
+						triangle[k] = collapse.To;
+				}
+			}
+
+			quadrics[collapse.To].Add(quadrics[collapse.From]);
+
+			// Both ends are locked for the rest of the pass: the target's
+			// adjacency list no longer describes its fan. Neighbours stay
+			// open; their flip tests read the updated indices.
+			touched[collapse.From] = true;
+			touched[collapse.To] = true;
+
+			worstError = std::max(worstError, collapse.Error);
+			collapsed++;
+		}
+
+		// Drop triangles that lost an edge
+		size_t write = 0;
+		for (size_t i = 0; i + 2 < indices.size(); i += 3)
+		{
+			uint32_t a = indices[i], b = indices[i + 1], c = indices[i + 2];
+			if (a == b || b == c || a == c)
+				continue;
+			indices[write++] = a;
+			indices[write++] = b;
+			indices[write++] = c;
+		}
+		indices.resize(write);
+
+		if (collapsed == 0 || errorLimitReached)
+			break;
+	}
+
+	return (float)std::sqrt(worstError);
+}
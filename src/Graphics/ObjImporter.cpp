@@ -0,0 +1,243 @@
+#include "ObjImporter.h"
+#include "Utils/Log.h"
+#include "Utils/MappedFile.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+
+namespace
+{
+	struct Cursor
+	{
+		const char* Pos;
+		const char* End;
+
+		void SkipSpaces()
+		{
+			while (Pos < End && (*Pos == ' ' || *Pos == '\t'))
+				Pos++;
+		}
+
+		void SkipLine()
+		{
+			while (Pos < End && *Pos != '\n')
+				Pos++;
+			if (Pos < End)
+				Pos++;
+		}
+
+		bool AtLineEnd() const
+		{
+			return Pos >= End || *Pos == '\n' || *Pos == '\r' || *Pos == '#';
+		}
+
+		// Numbers are copied out before strtof/strtol so a file without a
+		// trailing newline cannot make them read past the mapping
+		size_t Token(char (&buffer)[64])
+		{
+			size_t length = 0;
+			while (Pos + length < End && length < sizeof(buffer) - 1 &&
+				Pos[length] != ' ' && Pos[length] != '\t' && Pos[length] != '/' &&
+				Pos[length] != '\n' && Pos[length] != '\r')
+				length++;
+			std::memcpy(buffer, Pos, length);
+			buffer[length] = '\0';
+			return length;
+		}
+
+		float ReadFloat()
+		{
+			SkipSpaces();
+			if (AtLineEnd())
+				return 0.0f;
+			char buffer[64];
+			size_t length = Token(buffer);
+			Pos += length;
+			return std::strtof(buffer, nullptr);
+		}
+
+		bool ReadInt(long& value)
+		{
+			char buffer[64];
+			Token(buffer);
+			char* next = nullptr;
+			value = std::strtol(buffer, &next, 10);
+			if (next == buffer)
+				return false;
+			Pos += next - buffer;
+			return true;
+		}
+	};
+
+	// OBJ indices are 1-based; negative ones count back from the end
+	int32_t Resolve(long index, size_t count)
+	{
+		if (index > 0 && (size_t)index <= count)
+			return (int32_t)(index - 1);
+		if (index < 0 && (size_t)(-index) <= count)
+			return (int32_t)(count + index);
+		return -1;
+	}
+
+	struct Triplet
+	{
+		int32_t Position, UV, Normal;
+		bool operator==(const Triplet& other) const
+		{
+			return Position == other.Position && UV == other.UV && Normal == other.Normal;
+		}
+	};
+
+	struct TripletHash
+	{
+		size_t operator()(const Triplet& t) const
+		{
+			return ((size_t)t.Position * 73856093u) ^ ((size_t)t.UV * 19349663u) ^ ((size_t)t.Normal * 83492791u);
+		}
+	};
+}
+
+// ------------------------------------------------------------
+// One pass over the mapped text, no per-line allocations
+// ------------------------------------------------------------
+bool ObjImporter::Load(const std::string& path, std::vector<Mesh::Vertex>& vertices,
+	std::vector<uint32_t>& indices)
+{
+	vertices.clear();
+	indices.clear();
+
+	MappedFile file;
+	if (!file.Open(path))
+	{
+		Log::Error("Failed to open OBJ: " + path);
+		return false;
+	}
+
+	const char* text = static_cast<const char*>(file.GetData());
+	Cursor cursor{ text, text + file.GetSize() };
+
+	std::vector<glm::vec3> positions, normals;
+	std::vector<glm::vec2> uvs;
+	std::unordered_map<Triplet, uint32_t, TripletHash> vertexMap;
+	std::vector<uint32_t> face;
+	bool missingNormals = false;
+
+	while (cursor.Pos < cursor.End)
+	{
+		cursor.SkipSpaces();
+		if (cursor.AtLineEnd())
+		{
+			cursor.SkipLine();
+			continue;
+		}
+
+		char c0 = cursor.Pos[0];
+		char c1 = cursor.Pos + 1 < cursor.End ? cursor.Pos[1] : '\n';
+		char c2 = cursor.Pos + 2 < cursor.End ? cursor.Pos[2] : '\n';
+
+		if (c0 == 'v' && (c1 == ' ' || c1 == '\t'))
+		{
+			cursor.Pos += 1;
+			float x = cursor.ReadFloat(), y = cursor.ReadFloat(), z = cursor.ReadFloat();
+			positions.emplace_back(x, y, z);
+		}
+		else if (c0 == 'v' && c1 == 't' && (c2 == ' ' || c2 == '\t'))
+		{
+			cursor.Pos += 2;
+			float u = cursor.ReadFloat(), v = cursor.ReadFloat();
+			uvs.emplace_back(u, v);
+		}
+		else if (c0 == 'v' && c1 == 'n' && (c2 == ' ' || c2 == '\t'))
+		{
+			cursor.Pos += 2;
+			float x = cursor.ReadFloat(), y = cursor.ReadFloat(), z = cursor.ReadFloat();
+			normals.emplace_back(x, y, z);
+		}
+		else if (c0 == 'f' && (c1 == ' ' || c1 == '\t'))
+		{
+			cursor.Pos += 1;
+			face.clear();
+
+			// v, v/vt, v//vn or v/vt/vn
+			for (;;)
+			{
+				cursor.SkipSpaces();
+				long v = 0, vt = 0, vn = 0;
+				if (!cursor.ReadInt(v))
+					break;
+				if (cursor.Pos < cursor.End && *cursor.Pos == '/')
+				{
+					cursor.Pos++;
+					cursor.ReadInt(vt);
+					if (cursor.Pos < cursor.End && *cursor.Pos == '/')
+					{
+						cursor.Pos++;
+						cursor.ReadInt(vn);
+					}
+				}
+
+				Triplet key{ Resolve(v, positions.size()),
+					vt ? Resolve(vt, uvs.size()) : -1,
+					vn ? Resolve(vn, normals.size()) : -1 };
+				if (key.Position < 0)
+					continue;
+
+				auto it = vertexMap.find(key);
+				if (it == vertexMap.end())
+				{
+					Mesh::Vertex vertex;
+					vertex.Position = positions[key.Position];
+					vertex.Normal = key.Normal >= 0 ? normals[key.Normal] : glm::vec3(0.0f);
+					vertex.UV = key.UV >= 0 ? uvs[key.UV] : glm::vec2(0.0f);
+					vertex.Tangent = glm::vec4(0.0f);
+					missingNormals |= key.Normal < 0;
+
+					it = vertexMap.emplace(key, (uint32_t)vertices.size()).first;
+					vertices.push_back(vertex);
+				}
+				face.push_back(it->second);
+			}
+
+			for (size_t i = 2; i < face.size(); i++)
+			{
+				indices.push_back(face[0]);
+				indices.push_back(face[i - 1]);
+				indices.push_back(face[i]);
+			}
+		}
+
+		cursor.SkipLine();
+	}
+
+	if (indices.empty())
+	{
+		Log::Error("OBJ has no faces: " + path);
+		vertices.clear();
+		return false;
+	}
+
+	// Smooth normals from face normals (cross product length = 2x area)
+	if (missingNormals)
+	{
+		std::vector<glm::vec3> generated(vertices.size(), glm::vec3(0.0f));
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			const glm::vec3& p0 = vertices[indices[i]].Position;
+			glm::vec3 n = glm::cross(vertices[indices[i + 1]].Position - p0, vertices[indices[i + 2]].Position - p0);
+			generated[indices[i]] += n;
+			generated[indices[i + 1]] += n;
+			generated[indices[i + 2]] += n;
+		}
+
+		for (size_t i = 0; i < vertices.size(); i++)
+		{
+			if (vertices[i].Normal != glm::vec3(0.0f))
+				continue;
+			float length = glm::length(generated[i]);
+			vertices[i].Normal = length > 0.0f ? generated[i] / length : glm::vec3(0.0f, 1.0f, 0.0f);
+		}
+	}
+
+	return true;
+}
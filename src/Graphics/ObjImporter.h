@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "Graphics/Mesh.h"
+
+// -----------------------------------------------------------------------------
+// ObjImporter -- Wavefront OBJ geometry (v / vt / vn / f) into one indexed
+// vertex list. Faces are fan-triangulated, negative (relative) indices are
+// supported and identical v/vt/vn triplets share a vertex. Groups, objects
+// and materials are ignored; missing normals are generated (area-weighted,
+// smooth). Mainly a source format for MeshFile::Convert.
+// -----------------------------------------------------------------------------
+class ObjImporter
+{
+public:
+	// False if the file cannot be read or holds no triangles
+	static bool Load(const std::string& path, std::vector<Mesh::Vertex>& vertices,
+		std::vector<uint32_t>& indices);
+
+private:
+	ObjImporter() = delete;
+};
@@ -0,0 +1,146 @@
+#include "RenderQueue.h"
+#include "Scene/Entity.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	constexpr int TextureSetSize = MaterialFeature::Count;
+	constexpr uint32_t DepthMax = (1u << 21) - 1;
+
+	static_assert(Mesh::MaxLODs <= 8, "LODs are packed into 3 bits of the sort key");
+}
+
+// ------------------------------------------------------------
+// Frame reset (keeps allocations)
+// ------------------------------------------------------------
+void RenderQueue::Begin(float farClip, bool textureArrays)
+{
+	m_Items.clear();
+	m_Transforms.clear();
+	m_TextureSets.clear();
+	m_MeshIDs.clear();
+	m_FarClip = farClip > 0.0f ? farClip : 1.0f;
+	m_TextureArrays = textureArrays;
+}
+
+uint64_t RenderQueue::MakeKey(uint32_t variant, uint32_t textureSet, uint32_t mesh, uint32_t lod, uint32_t depth)
+{
+	return ((uint64_t)(variant & 0xFF) << 56) |
+		((uint64_t)(textureSet & 0xFFFF) << 40) |
+		((uint64_t)(mesh & 0xFFFF) << 24) |
+		((uint64_t)(lod & 7) << 21) |
+		(uint64_t)(depth & DepthMax);
+}
+
+// ------------------------------------------------------------
+// Entities with identical maps share one id -> one bind group
+// ------------------------------------------------------------
+uint32_t RenderQueue::GetTextureSetID(const Entity& entity)
+{
+	const Material* mat = entity.GetMaterial();
+	const void* maps[TextureSetSize] =
+	{
+		mat->GetDiffuseTexture(),
+		mat->GetNormalMap(),
+		mat->GetRoughnessMap(),
+		mat->GetMetalnessMap(),
+		mat->GetDisplacementMap()
+	};
+
+	if (m_TextureArrays)
+	{
+		TextureArrayLayer layers[TextureSetSize];
+		mat->GetArrayLayers(layers);
+		for (int i = 0; i < TextureSetSize; i++)
+			maps[i] = reinterpret_cast<const void*>((uintptr_t)layers[i].ArrayID);
+	}
+
+	// Few distinct sets per frame -- a linear scan beats hashing here
+	size_t setCount = m_TextureSets.size() / TextureSetSize;
+	for (size_t i = 0; i < setCount; i++)
+	{
+		if (std::memcmp(&m_TextureSets[i * TextureSetSize], maps, sizeof(maps)) == 0)
+			return (uint32_t)i;
+	}
+
+	m_TextureSets.insert(m_TextureSets.end(), maps, maps + TextureSetSize);
+	return (uint32_t)setCount;
+}
+
+// One id per mesh; its LODs share it and sort apart on the LOD bits
+uint32_t RenderQueue::GetMeshID(const Mesh* mesh)
+{
+	auto it = m_MeshIDs.find(mesh);
+	if (it != m_MeshIDs.end())
+		return it->second;
+
+	uint32_t id = (uint32_t)m_MeshIDs.size();
+	m_MeshIDs.emplace(mesh, id);
+	return id;
+}
+
+// ------------------------------------------------------------
+// Add one draw
+// ------------------------------------------------------------
+void RenderQueue::Submit(const Entity& entity, const ShaderVariant& variant,
+	const glm::mat4& model, float viewDepth, uint32_t lod)
+{
+	float normalized = std::min(std::max(viewDepth / m_FarClip, 0.0f), 1.0f);
+	uint32_t depth = (uint32_t)(normalized * (float)DepthMax);
+
+	DrawItem item;
+	item.Source = &entity;
+	item.Variant = &variant;
+	item.TextureSetID = GetTextureSetID(entity);
+	item.TransformIndex = (uint32_t)m_Transforms.size();
+	item.LOD = lod;
+	item.Key = MakeKey(variant.Index, item.TextureSetID, GetMeshID(entity.GetMesh()), lod, depth);
+
+	m_Items.push_back(item);
+	m_Transforms.push_back(model);
+}
+
+// ------------------------------------------------------------
+// 8 passes of 8 bits; passes where every key shares the same
+// byte are skipped, so sparse keys sort in very few passes
+// ------------------------------------------------------------
+void RenderQueue::Sort()
+{
+	const size_t count = m_Items.size();
+	if (count < 2)
+		return;
+
+	m_Scratch.resize(count);
+
+	DrawItem* src = m_Items.data();
+	DrawItem* dst = m_Scratch.data();
+
+	for (int shift = 0; shift < 64; shift += 8)
+	{
+		uint32_t histogram[256] = {};
+		for (size_t i = 0; i < count; i++)
+			histogram[(src[i].Key >> shift) & 0xFF]++;
+
+		if (histogram[(src[0].Key >> shift) & 0xFF] == count)
+			continue;
+
+		uint32_t offset = 0;
+		for (int b = 0; b < 256; b++)
+		{
+			uint32_t c = histogram[b];
+			histogram[b] = offset;
+			offset += c;
+		}
+
+		for (size_t i = 0; i < count; i++)
+			dst[histogram[(src[i].Key >> shift) & 0xFF]++] = src[i];
+
+		std::swap(src, dst);
+	}
+
+	// Odd number of executed passes leaves the result in scratch
+	if (src != m_Items.data())
+		m_Items.swap(m_Scratch);
+}
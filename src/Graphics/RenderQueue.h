@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+#include "Graphics/ShaderVariantCache.h"
+
+class Entity;
+class Mesh;
+
+// -----------------------------------------------------------------------------
+// RenderQueue -- per-frame list of draw items ordered by a 64-bit sort key
+//
+//   bits 63..56  shader variant index   (fewest program switches first)
+//   bits 55..40  texture set id         (then texture rebinds)
+//   bits 39..24  mesh id                 (then VAO switches)
+//   bits 23..21  LOD                     (levels of a mesh batch separately)
+//   bits 20..0   view depth, front to back (early-z within a state group)
+//
+// Ids wrap at 16 bits; that only costs sort quality, batches are split on
+// the full draw state (Renderer::PrepareBatches).
+// -----------------------------------------------------------------------------
+
+struct DrawItem
+{
+	uint64_t             Key = 0;
+	const Entity*        Source = nullptr;
+	const ShaderVariant* Variant = nullptr;
+	uint32_t             TextureSetID = 0;
+	uint32_t             TransformIndex = 0;   // submission order, unaffected by sorting
+	uint32_t             LOD = 0;              // level of the entity's mesh to draw
+};
+
+class RenderQueue
+{
+public:
+	// Reset for a new frame; depth is quantized over [0, farClip].
+	// With textureArrays, texture sets are keyed by the arrays holding
+	// the maps, so materials sharing arrays share a bind group.
+	void Begin(float farClip, bool textureArrays = false);
+
+	// 'model' is the world matrix already computed for culling
+	void Submit(const Entity& entity, const ShaderVariant& variant,
+		const glm::mat4& model, float viewDepth, uint32_t lod = 0);
+
+	// LSD radix sort on Key (stable)
+	void Sort();
+
+	const std::vector<DrawItem>& GetItems() const { return m_Items; }
+	const glm::mat4& GetTransform(const DrawItem& item) const { return m_Transforms[item.TransformIndex]; }
+
+	static uint64_t MakeKey(uint32_t variant, uint32_t textureSet, uint32_t mesh, uint32_t lod, uint32_t depth);
+
+private:
+	uint32_t GetTextureSetID(const Entity& entity);
+	uint32_t GetMeshID(const Mesh* mesh);
+
+private:
+	std::vector<DrawItem> m_Items;
+	std::vector<DrawItem> m_Scratch;
+	std::vector<glm::mat4> m_Transforms;
+
+	float m_FarClip = 100.0f;
+	bool  m_TextureArrays = false;
+
+	// Compact per-frame ids (texture sets are keyed by their 5 maps / arrays)
+	std::vector<const void*>                   m_TextureSets;
+	std::unordered_map<const Mesh*, uint32_t>  m_MeshIDs;
+};
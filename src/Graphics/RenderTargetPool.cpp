@@ -0,0 +1,178 @@
+#include "RenderTargetPool.h"
+#include "Graphics/GLState.h"
+#include "Utils/Log.h"
+
+#include <glad/glad.h>
+
+namespace
+{
+	struct TextureFormatInfo
+	{
+		GLenum InternalFormat;
+		GLenum Format;
+		GLenum Type;
+		size_t BytesPerPixel;
+	};
+
+	TextureFormatInfo GetFormatInfo(FramebufferTextureFormat format)
+	{
+		switch (format)
+		{
+		case FramebufferTextureFormat::RGBA8:           return { GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, 4 };
+		case FramebufferTextureFormat::RGBA16F:         return { GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT, 8 };
+		case FramebufferTextureFormat::RGB10A2:         return { GL_RGB10_A2, GL_RGBA, GL_UNSIGNED_INT_2_10_10_10_REV, 4 };
+		case FramebufferTextureFormat::R32F:            return { GL_R32F, GL_RED, GL_FLOAT, 4 };
+		case FramebufferTextureFormat::Depth24Stencil8: return { GL_DEPTH24_STENCIL8, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, 4 };
+		case FramebufferTextureFormat::Depth32F:        return { GL_DEPTH_COMPONENT32F, GL_DEPTH_COMPONENT, GL_FLOAT, 4 };
+		default:                                        return { 0, 0, 0, 0 };
+		}
+	}
+}
+
+RenderTargetPool::~RenderTargetPool()
+{
+	Clear();
+
+	if (!m_InUse.empty())
+		Log::Warn("RenderTargetPool destroyed with " + std::to_string(m_InUse.size()) + " target(s) still in use");
+}
+
+// ------------------------------------------------------------
+// Raw allocation
+// ------------------------------------------------------------
+unsigned int RenderTargetPool::CreateTarget(FramebufferTextureFormat format, int width, int height, bool renderbuffer)
+{
+	TextureFormatInfo info = GetFormatInfo(format);
+	GLuint id = 0;
+
+	if (renderbuffer)
+	{
+		glGenRenderbuffers(1, &id);
+		glBindRenderbuffer(GL_RENDERBUFFER, id);
+		glRenderbufferStorage(GL_RENDERBUFFER, info.InternalFormat, width, height);
+		return id;
+	}
+
+	glGenTextures(1, &id);
+	GLState::BindTexture(0, GL_TEXTURE_2D, id);
+	glTexImage2D(GL_TEXTURE_2D, 0, info.InternalFormat, width, height, 0, info.Format, info.Type, nullptr);
+
+	// Depth is read back with texelFetch -- no filtering, no comparison
+	GLint filter = IsDepthFormat(format) ? GL_NEAREST : GL_LINEAR;
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	return id;
+}
+
+void RenderTargetPool::DeleteTarget(unsigned int id, bool renderbuffer)
+{
+	if (id == 0)
+		return;
+
+	if (renderbuffer)
+	{
+		glDeleteRenderbuffers(1, &id);
+	}
+	else
+	{
+		GLState::OnTextureDeleted(id);
+		glDeleteTextures(1, &id);
+	}
+}
+
+bool RenderTargetPool::IsDepthFormat(FramebufferTextureFormat format)
+{
+	return format == FramebufferTextureFormat::Depth24Stencil8 ||
+		format == FramebufferTextureFormat::Depth32F;
+}
+
+size_t RenderTargetPool::GetTargetBytes(FramebufferTextureFormat format, int width, int height)
+{
+	return GetFormatInfo(format).BytesPerPixel * (size_t)width * (size_t)height;
+}
+
+// ------------------------------------------------------------
+// Pooled allocation
+// ------------------------------------------------------------
+unsigned int RenderTargetPool::Acquire(FramebufferTextureFormat format, int width, int height, bool renderbuffer)
+{
+	Key key{ format, width, height, renderbuffer };
+
+	for (size_t i = 0; i < m_Free.size(); i++)
+	{
+		if (m_Free[i].TargetKey == key)
+		{
+			unsigned int id = m_Free[i].ID;
+			m_Free[i] = m_Free.back();
+			m_Free.pop_back();
+
+			m_InUse[MakeHandle(id, renderbuffer)] = key;
+			m_Stats.Reused++;
+			m_Stats.FreeTargets--;
+			return id;
+		}
+	}
+
+	unsigned int id = CreateTarget(format, width, height, renderbuffer);
+	m_InUse[MakeHandle(id, renderbuffer)] = key;
+
+	m_Stats.Created++;
+	m_Stats.LiveTargets++;
+	m_Stats.Bytes += GetTargetBytes(format, width, height);
+	return id;
+}
+
+void RenderTargetPool::Release(unsigned int id, bool renderbuffer)
+{
+	auto it = m_InUse.find(MakeHandle(id, renderbuffer));
+	if (it == m_InUse.end())
+	{
+		Log::Warn("RenderTargetPool::Release() called with a target the pool does not own");
+		return;
+	}
+
+	m_Free.push_back({ it->second, id, m_Frame });
+	m_InUse.erase(it);
+	m_Stats.FreeTargets++;
+}
+
+void RenderTargetPool::Destroy(const Key& key, unsigned int id)
+{
+	DeleteTarget(id, key.Renderbuffer);
+
+	m_Stats.LiveTargets--;
+	m_Stats.FreeTargets--;
+	m_Stats.Bytes -= GetTargetBytes(key.Format, key.Width, key.Height);
+}
+
+// ------------------------------------------------------------
+// Eviction
+// ------------------------------------------------------------
+void RenderTargetPool::EndFrame()
+{
+	m_Frame++;
+
+	for (size_t i = 0; i < m_Free.size();)
+	{
+		if (m_Frame - m_Free[i].LastUsedFrame > MaxIdleFrames)
+		{
+			Destroy(m_Free[i].TargetKey, m_Free[i].ID);
+			m_Free[i] = m_Free.back();
+			m_Free.pop_back();
+		}
+		else
+		{
+			i++;
+		}
+	}
+}
+
+void RenderTargetPool::Clear()
+{
+	for (const FreeTarget& target : m_Free)
+		Destroy(target.TargetKey, target.ID);
+	m_Free.clear();
+}
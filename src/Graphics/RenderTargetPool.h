@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Graphics/Framebuffer.h"
+
+// -----------------------------------------------------------------------------
+// RenderTargetPool -- recycles framebuffer attachments by (format, size, kind).
+// Framebuffers hand their textures back on resize instead of deleting them,
+// so dragging the viewport back and forth between a few size buckets reuses
+// storage rather than allocating every frame. Targets idle for longer than
+// MaxIdleFrames are deleted in EndFrame().
+// -----------------------------------------------------------------------------
+class RenderTargetPool
+{
+public:
+	static constexpr uint64_t MaxIdleFrames = 120;
+
+	struct Stats
+	{
+		uint32_t Created = 0;       // allocations that reached the driver (lifetime)
+		uint32_t Reused = 0;        // requests served from the free list (lifetime)
+		uint32_t LiveTargets = 0;   // in use + free
+		uint32_t FreeTargets = 0;
+		size_t   Bytes = 0;         // estimated storage of all live targets
+	};
+
+	RenderTargetPool() = default;
+	~RenderTargetPool();
+
+	RenderTargetPool(const RenderTargetPool&) = delete;
+	RenderTargetPool& operator=(const RenderTargetPool&) = delete;
+
+	// Texture (or renderbuffer) with exactly this format and size
+	unsigned int Acquire(FramebufferTextureFormat format, int width, int height, bool renderbuffer = false);
+
+	// Return a target obtained from Acquire() to the free list
+	void Release(unsigned int id, bool renderbuffer = false);
+
+	// Advance the frame counter and delete targets nobody asked for lately
+	void EndFrame();
+
+	// Delete every free target (in-use targets are untouched)
+	void Clear();
+
+	const Stats& GetStats() const { return m_Stats; }
+
+	// Unpooled allocation, also used by framebuffers without a pool
+	static unsigned int CreateTarget(FramebufferTextureFormat format, int width, int height, bool renderbuffer);
+	static void DeleteTarget(unsigned int id, bool renderbuffer);
+	static size_t GetTargetBytes(FramebufferTextureFormat format, int width, int height);
+	static bool IsDepthFormat(FramebufferTextureFormat format);
+
+private:
+	struct Key
+	{
+		FramebufferTextureFormat Format;
+		int  Width;
+		int  Height;
+		bool Renderbuffer;
+
+		bool operator==(const Key& other) const
+		{
+			return Format == other.Format && Width == other.Width &&
+				Height == other.Height && Renderbuffer == other.Renderbuffer;
+		}
+	};
+
+	struct FreeTarget
+	{
+		Key          TargetKey;
+		unsigned int ID;
+		uint64_t     LastUsedFrame;
+	};
+
+	void Destroy(const Key& key, unsigned int id);
+
+	// Texture and renderbuffer names are separate namespaces
+	static uint64_t MakeHandle(unsigned int id, bool renderbuffer)
+	{
+		return ((uint64_t)renderbuffer << 32) | id;
+	}
+
+private:
+	std::vector<FreeTarget>                m_Free;
+	std::unordered_map<uint64_t, Key>      m_InUse;
+	uint64_t                               m_Frame = 0;
+	Stats                                  m_Stats;
+};
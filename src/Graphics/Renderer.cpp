@@ -1,20 +1,115 @@
 #include "Renderer.h"
 #include "Graphics/Framebuffer.h"
+#include "Graphics/UniformBuffer.h"
+#include "Graphics/InstanceBuffer.h"
+#include "Graphics/GLState.h"
+#include "Graphics/LightClusters.h"
+#include "Graphics/Mesh.h"
+#include "Graphics/GPUTimer.h"
+#include "Graphics/GLExtensions.h"
+#include "Graphics/TextureBuffer.h"
+#include "Graphics/TextureLibrary.h"
 #include <glad/glad.h>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include "Utils/Log.h"
 
+static_assert(Mesh::MaxLODs <= 4, "RenderStats::LODInstances has one slot per LOD");
+
+// ------------------------------------------------------------
+// std140 mirrors of the FrameData / LightData blocks in pbr.*
+// ------------------------------------------------------------
+namespace
+{
+	struct FrameDataStd140
+	{
+		glm::mat4  View;
+		glm::mat4  Projection;
+		glm::vec4  ViewPos;
+		glm::vec4  ClusterParams;   // see LightClusters::GetShaderParams
+		glm::ivec4 ClusterGrid;     // xyz = grid size
+	};
+
+	// Point lights live in the clustered texture buffers (LightClusters)
+	struct LightDataStd140
+	{
+		glm::vec3 DirectionalColor;
+		float     DirectionalIntensity;
+		int       HasDirectionalLight;
+		int       _Pad0[3];
+	};
+
+	static_assert(sizeof(FrameDataStd140) == 176, "FrameData layout mismatch");
+	static_assert(sizeof(LightDataStd140) == 32, "LightData layout mismatch");
+}
+
 Renderer::Renderer()
 {
 	Log::Info("Rendering to framebuffer...");
-	// Load PBR shader
-	m_DefaultShader = new Shader("assets/shaders/pbr.vert",
+	// PBR shader -- variants are compiled on first use per feature mask
+	m_ShaderVariants = new ShaderVariantCache("assets/shaders/pbr.vert",
 		"assets/shaders/pbr.frag");
 
-	glEnable(GL_DEPTH_TEST);
+	// Warm up the untextured variant used by freshly created materials
+	m_ShaderVariants->Get(0);
+
+	// Per-object light path -- compiled only once the mode is selected
+	m_ObjectLightVariants = new ShaderVariantCache("assets/shaders/pbr.vert",
+		"assets/shaders/pbr.frag", { "PER_OBJECT_LIGHTS" });
+
+	// Texture-array material path -- also compiled on first use
+	m_ArrayVariants = new ShaderVariantCache("assets/shaders/pbr.vert",
+		"assets/shaders/pbr.frag", { "TEXTURE_ARRAYS" });
+	m_ArrayObjectLightVariants = new ShaderVariantCache("assets/shaders/pbr.vert",
+		"assets/shaders/pbr.frag", { "TEXTURE_ARRAYS", "PER_OBJECT_LIGHTS" });
+	m_GBufferArrayVariants = new ShaderVariantCache("assets/shaders/pbr.vert",
+		"assets/shaders/gbuffer.frag", { "TEXTURE_ARRAYS" });
+	m_MaterialBuffer = new TextureBuffer(GL_RGBA32F);
+
+	// Per-frame blocks are allocated once and rewritten every frame
+	m_FrameDataUBO = new UniformBuffer(sizeof(FrameDataStd140), UniformBlockBinding::FrameData);
+	m_LightDataUBO = new UniformBuffer(sizeof(LightDataStd140), UniformBlockBinding::LightData);
+
+	m_InstanceBuffer = new InstanceBuffer();
+	m_IndirectBuffer = new IndirectBuffer();
+	m_LightClusters = new LightClusters();
+
+	m_DepthShader = new Shader("assets/shaders/depth.vert", "assets/shaders/depth.frag");
 
-	m_DefaultShader->Bind();
-	m_DefaultShader->Unbind();
+	// Deferred path -- the G-buffer itself is a set of frame graph transients
+	m_GBufferVariants = new ShaderVariantCache("assets/shaders/pbr.vert",
+		"assets/shaders/gbuffer.frag");
+
+	m_DeferredDirectionalShader = new Shader("assets/shaders/fullscreen.vert",
+		"assets/shaders/deferred_directional.frag");
+	m_LightVolumeShader = new Shader("assets/shaders/light_volume.vert",
+		"assets/shaders/deferred_point.frag");
+
+	for (Shader* shader : { m_DeferredDirectionalShader, m_LightVolumeShader })
+	{
+		shader->Bind();
+		shader->SetInt("u_GBufferAlbedo", (int)GBufferAlbedoUnit);
+		shader->SetInt("u_GBufferNormal", (int)GBufferNormalUnit);
+		shader->SetInt("u_GBufferDepth", (int)GBufferDepthUnit);
+	}
+	m_LightVolumeShader->SetInt("u_LightData", (int)LightClusters::LightDataUnit);
+
+	// The tessellated sphere's faces cut inside the unit sphere; scale it so
+	// the polyhedron encloses the light radius (16 segments, 12 rings)
+	m_LightVolumeMesh = Mesh::CreateSphere(16, 12);
+	float volumeScale = 1.0f / (std::cos(glm::pi<float>() / 16.0f) * std::cos(glm::pi<float>() / 24.0f));
+	m_LightVolumeShader->SetFloat("u_VolumeScale", volumeScale);
+
+	glGenVertexArrays(1, &m_FullscreenVAO);
+
+	m_UpscaleShader = new Shader("assets/shaders/fullscreen.vert", "assets/shaders/upscale.frag");
+	m_UpscaleShader->Bind();
+	m_UpscaleShader->SetInt("u_Source", 0);
+
+	m_GPUTimer = new GPUTimer();
 
 	// Legacy viewport defaults
 	m_ViewportWidth = 1280;
@@ -23,7 +118,28 @@ Renderer::Renderer()
 
 Renderer::~Renderer()
 {
-	delete m_DefaultShader;
+	delete m_GPUTimer;
+	delete m_UpscaleShader;
+
+	GLState::OnVertexArrayDeleted(m_FullscreenVAO);
+	glDeleteVertexArrays(1, &m_FullscreenVAO);
+
+	delete m_LightVolumeMesh;
+	delete m_LightVolumeShader;
+	delete m_DeferredDirectionalShader;
+	delete m_GBufferVariants;
+	delete m_DepthShader;
+	delete m_LightClusters;
+	delete m_IndirectBuffer;
+	delete m_InstanceBuffer;
+	delete m_LightDataUBO;
+	delete m_FrameDataUBO;
+	delete m_MaterialBuffer;
+	delete m_GBufferArrayVariants;
+	delete m_ArrayObjectLightVariants;
+	delete m_ArrayVariants;
+	delete m_ObjectLightVariants;
+	delete m_ShaderVariants;
 }
 
 // ------------------------------------------------------------
@@ -47,64 +163,682 @@ void Renderer::SetViewportSize(int width, int height)
 }
 
 // ------------------------------------------------------------
-// Camera setup (aspect = framebuffer size)
+// Camera setup -- one FrameData update. The aspect ratio comes from
+// the output; the viewport is the (possibly scaled) render size.
+// ------------------------------------------------------------
+void Renderer::SetupCamera(const Camera& camera, float aspectRatio, int viewportWidth, int viewportHeight)
+{
+	FrameDataStd140 data;
+	data.View = camera.GetViewMatrix();
+	data.Projection = camera.GetProjectionMatrix(aspectRatio);
+	data.ViewPos = glm::vec4(camera.GetPosition(), 1.0f);
+	data.ClusterParams = m_LightClusters->GetShaderParams(viewportWidth, viewportHeight);
+	data.ClusterGrid = glm::ivec4(LightClusters::GridX, LightClusters::GridY, LightClusters::GridZ, 0);
+
+	m_FrameDataUBO->SetData(&data, sizeof(data));
+}
+
+// ------------------------------------------------------------
+// Upload lights -- directional light in LightData, point lights
+// binned into the cluster grid
+// ------------------------------------------------------------
+void Renderer::SetupLights(const std::vector<Light>& lights, const Camera& camera, float aspectRatio)
+{
+	LightDataStd140 data = {};
+
+	for (const Light& light : lights)
+	{
+		if (light.GetType() == LightType::Directional)
+		{
+			data.DirectionalColor = light.GetColor();
+			data.DirectionalIntensity = light.GetIntensity();
+			data.HasDirectionalLight = 1;
+			break;
+		}
+	}
+
+	m_LightDataUBO->SetData(&data, sizeof(data));
+
+	auto start = std::chrono::high_resolution_clock::now();
+	// Only the clustered forward path reads the cluster grid
+	bool binClusters = m_RenderPath == RenderPath::Forward &&
+		m_LightAssignment == LightAssignment::Clustered;
+	m_LightClusters->Update(lights, camera, aspectRatio, binClusters);
+	m_LightClusters->Bind();
+
+	m_Stats.PointLights = m_LightClusters->GetLightCount();
+	m_Stats.ClusterLightRefs = m_LightClusters->GetIndexCount();
+	m_Stats.LightBinningMs = std::chrono::duration<float, std::milli>(
+		std::chrono::high_resolution_clock::now() - start).count();
+}
+
+// ------------------------------------------------------------
+// Collect one draw item per visible entity and sort by state
 // ------------------------------------------------------------
-void Renderer::SetupCamera(const Camera& camera, Shader& shader, float aspectRatio)
+void Renderer::BuildQueue(const Scene& scene, float aspectRatio)
 {
+	const Camera& camera = scene.GetCamera();
 	glm::mat4 view = camera.GetViewMatrix();
-	glm::mat4 projection = camera.GetProjectionMatrix(aspectRatio);
+	Frustum frustum = camera.GetFrustum(aspectRatio);
+
+	bool textureArrays = m_MaterialBinding == MaterialBinding::TextureArrays;
+	m_Queue.Begin(camera.GetFarClip(), textureArrays);
+
+	bool deferred = m_RenderPath == RenderPath::Deferred;
+	bool perObjectLights = !deferred && m_LightAssignment == LightAssignment::PerObject;
+
+	ShaderVariantCache* variants = textureArrays ? m_ArrayVariants : m_ShaderVariants;
+	if (deferred)
+		variants = textureArrays ? m_GBufferArrayVariants : m_GBufferVariants;
+	else if (perObjectLights)
+		variants = textureArrays ? m_ArrayObjectLightVariants : m_ObjectLightVariants;
+
+	m_ObjectLightLists.clear();
+	if (perObjectLights)
+		BuildLightBVH();
+
+	// Screen-space size of one unit at distance 1, at the internal resolution
+	m_LODPixelScale = (float)m_RenderHeight / (2.0f * std::tan(glm::radians(camera.GetFOV()) * 0.5f));
+
+	// Scene BVH rejects off-screen entities by their world AABB
+	const auto& entities = scene.GetEntities();
+	const auto& entityBounds = scene.GetEntityBounds();
+	m_EntityLODs.resize(entities.size(), 0);
+
+	m_VisibleEntities.clear();
+	scene.GetBVH().QueryFrustum(frustum, m_VisibleEntities);
+	m_Stats.Culled = (uint32_t)(entities.size() - m_VisibleEntities.size());
+
+	for (uint32_t index : m_VisibleEntities)
+	{
+		const Entity& entity = entities[index];
+		glm::mat4 model = entity.GetTransform().GetMatrix();
+
+		// Each entity picks the variant matching its material's maps;
+		// array programs branch on the layers instead
+		uint32_t featureMask = textureArrays ? 0 : entity.GetMaterial()->GetFeatureMask();
+		if (entity.GetMesh()->GetVertexFormat() != VertexFormat::Float)
+			featureMask |= VariantFeature::PackedVertices;
+
+		const ShaderVariant& variant = variants->Get(featureMask);
+
+		float viewDepth = -(view * glm::vec4(entityBounds[index].GetCenter(), 1.0f)).z;
+		uint32_t lod = SelectLOD(*entity.GetMesh(), model, camera, index);
+		m_Queue.Submit(entity, variant, model, viewDepth, lod);
+
+		if (perObjectLights)
+			m_ObjectLightLists.push_back(AssignObjectLights(entityBounds[index]));
+	}
+
+	m_Queue.Sort();
+}
+
+// ------------------------------------------------------------
+// Projected error = world error / distance * pixel scale, with the
+// distance measured to the near side of the bounding sphere. Errors
+// grow with the level, so the search walks from last frame's level.
+// ------------------------------------------------------------
+uint32_t Renderer::SelectLOD(const Mesh& mesh, const glm::mat4& model, const Camera& camera, uint32_t entityIndex)
+{
+	const uint32_t lodCount = mesh.GetLODCount();
+	if (!m_LODSettings.Enabled || lodCount < 2)
+		return 0;
+
+	float scale = glm::max(glm::length(glm::vec3(model[0])),
+		glm::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
 
-	shader.SetMat4("u_View", view);
-	shader.SetMat4("u_Projection", projection);
+	const BoundingSphere& sphere = mesh.GetBoundingSphere();
+	glm::vec3 center = glm::vec3(model * glm::vec4(sphere.Center, 1.0f));
+	float distance = glm::length(center - camera.GetPosition()) - sphere.Radius * scale;
+	distance = glm::max(distance, camera.GetNearClip());
 
-	shader.SetVec3("u_ViewPos", camera.GetPosition());
+	const float pixelsPerUnit = scale * m_LODPixelScale / distance;
+	const float threshold = m_LODSettings.ErrorPixels;
+	auto projectedError = [&](uint32_t lod) { return mesh.GetLOD(lod).Error * pixelsPerUnit; };
+
+	uint32_t lod = glm::min((uint32_t)m_EntityLODs[entityIndex], lodCount - 1);
+	if (projectedError(lod) > threshold)
+	{
+		while (lod > 0 && projectedError(lod) > threshold)
+			lod--;
+	}
+	else
+	{
+		while (lod + 1 < lodCount && projectedError(lod + 1) <= threshold * (1.0f - m_LODSettings.Hysteresis))
+			lod++;
+	}
+
+	m_EntityLODs[entityIndex] = (uint8_t)lod;
+	return lod;
 }
 
 // ------------------------------------------------------------
-// Upload lights to shader
+// Per-object lights -- BVH over the point light spheres uploaded
+// by LightClusters this frame (same indices as u_LightData)
 // ------------------------------------------------------------
-void Renderer::SetupLights(const std::vector<Light>& lights, Shader& shader)
+void Renderer::BuildLightBVH()
 {
-	int dirCount = 0;
-	int pointCount = 0;
+	const std::vector<glm::vec4>& lightData = m_LightClusters->GetLightData();
 
-	for (size_t i = 0; i < lights.size(); i++)
+	m_LightBounds.clear();
+	for (size_t i = 0; i < lightData.size(); i += 2)
 	{
-		const Light& light = lights[i];
+		glm::vec3 center = glm::vec3(lightData[i]);
+		m_LightBounds.push_back(AABB::FromCenterExtents(center, glm::vec3(lightData[i].w)));
+	}
 
-		if (light.GetType() == LightType::Directional)
+	m_LightBVH.Build(m_LightBounds);
+}
+
+// Strongest MaxObjectLights lights reaching 'bounds', packed two
+// 16-bit indices per component, 0xFFFF terminated
+glm::uvec4 Renderer::AssignObjectLights(const AABB& bounds)
+{
+	const std::vector<glm::vec4>& lightData = m_LightClusters->GetLightData();
+
+	m_LightCandidates.clear();
+	m_LightBVH.QueryAABB(bounds, m_LightCandidates);
+
+	// Score = luminance at the closest point of the bounds, same falloff as pbr.frag
+	m_LightScores.clear();
+	for (uint32_t index : m_LightCandidates)
+	{
+		glm::vec3 position = glm::vec3(lightData[index * 2]);
+		float radius = lightData[index * 2].w;
+		glm::vec3 radiance = glm::vec3(lightData[index * 2 + 1]);
+
+		float dist = glm::length(glm::clamp(position, bounds.Min, bounds.Max) - position);
+		if (dist >= radius)
+			continue;
+
+		float ratio = dist / radius;
+		float window = 1.0f - ratio * ratio * ratio * ratio;
+		float luminance = glm::dot(radiance, glm::vec3(0.2126f, 0.7152f, 0.0722f));
+		float score = luminance * window * window / (1.0f + 0.09f * dist + 0.032f * dist * dist);
+
+		m_LightScores.emplace_back(score, index);
+	}
+
+	size_t count = std::min<size_t>(m_LightScores.size(), MaxObjectLights);
+	std::partial_sort(m_LightScores.begin(), m_LightScores.begin() + count, m_LightScores.end(),
+		[](const auto& a, const auto& b) { return a.first > b.first; });
+
+	glm::uvec4 packed(0xFFFFFFFFu);
+	for (size_t i = 0; i < count; i++)
+	{
+		uint32_t shift = (i & 1) * 16;
+		packed[i / 2] &= ~(0xFFFFu << shift);
+		packed[i / 2] |= m_LightScores[i].second << shift;
+	}
+
+	m_Stats.ObjectLightRefs += (uint32_t)count;
+	return packed;
+}
+
+// ------------------------------------------------------------
+// Runs of queue items with the same variant, texture set, mesh and
+// LOD become one instanced batch. The runs are found by comparing
+// those values, not the sort key: its id fields are 16 bits wide and
+// can collide once a frame has more distinct meshes or sets.
+// Instance data for the whole frame is uploaded once and shared
+// by the depth pre-pass and the shading pass.
+// ------------------------------------------------------------
+void Renderer::PrepareBatches()
+{
+	const std::vector<DrawItem>& items = m_Queue.GetItems();
+
+	m_Batches.clear();
+	m_Instances.clear();
+	m_MaterialData.clear();
+	m_MaterialIndices.clear();
+	if (items.empty())
+		return;
+
+	bool textureArrays = m_MaterialBinding == MaterialBinding::TextureArrays;
+
+	const DrawItem* batchItem = nullptr;
+	for (const DrawItem& item : items)
+	{
+		if (!batchItem || item.Variant != batchItem->Variant || item.TextureSetID != batchItem->TextureSetID ||
+			item.Source->GetMesh() != batchItem->Source->GetMesh() || item.LOD != batchItem->LOD)
+		{
+			m_Batches.push_back({ &item, m_Instances.size(), 0, item.Source->GetMesh()->GetVertexArray() });
+			batchItem = &item;
+		}
+
+		const Material* material = item.Source->GetMaterial();
+		const Mesh* mesh = item.Source->GetMesh();
+
+		// Quantized positions are decoded by the model matrix (the
+		// depth pre-pass shares it, so depths still match)
+		InstanceData instance;
+		instance.Model = m_Queue.GetTransform(item);
+		if (mesh->IsQuantized())
+			instance.Model = instance.Model * mesh->GetDequantization();
+		instance.Albedo = glm::vec4(material->GetDiffuseColor(), 1.0f);
+		instance.MaterialParams = glm::vec4(material->GetRoughness(), material->GetMetalness(), 0.0f, 0.0f);
+		if (textureArrays)
+			instance.MaterialParams.z = (float)GetMaterialIndex(material);
+		instance.LightIndices = m_ObjectLightLists.empty() ?
+			glm::uvec4(0xFFFFFFFFu) : m_ObjectLightLists[item.TransformIndex];
+		m_Instances.push_back(instance);
+
+		m_Batches.back().Count++;
+	}
+
+	m_InstanceBuffer->Upload(m_Instances);
+
+	if (IsMultiDrawActive())
+	{
+		m_Commands.clear();
+		for (const DrawBatch& batch : m_Batches)
+		{
+			const Mesh* mesh = batch.First->Source->GetMesh();
+			const GeometryAllocation& geometry = mesh->GetAllocation();
+			const Mesh::LOD& lod = mesh->GetLOD(batch.First->LOD);
+			m_Commands.push_back({ lod.IndexCount, batch.Count, geometry.FirstIndex + lod.FirstIndex,
+				(int32_t)geometry.BaseVertex, (uint32_t)batch.FirstInstance });
+		}
+		m_IndirectBuffer->Upload(m_Commands);
+	}
+
+	if (textureArrays)
+	{
+		m_MaterialBuffer->SetData(m_MaterialData.data(), m_MaterialData.size() * sizeof(glm::vec4));
+		m_MaterialBuffer->Bind(Material::MaterialDataUnit);
+
+		m_Stats.Materials = (uint32_t)m_MaterialIndices.size();
+		m_Stats.TextureArrays = (uint32_t)TextureLibrary::GetArrayCount();
+	}
+}
+
+// ------------------------------------------------------------
+// Material record for the texture-array path, appended on first
+// use this frame (3 texels, layout in pbr.vert)
+// ------------------------------------------------------------
+uint32_t Renderer::GetMaterialIndex(const Material* material)
+{
+	auto it = m_MaterialIndices.find(material);
+	if (it != m_MaterialIndices.end())
+		return it->second;
+
+	TextureArrayLayer layers[MaterialFeature::Count];
+	material->GetArrayLayers(layers);
+
+	uint32_t index = (uint32_t)m_MaterialIndices.size();
+	m_MaterialIndices.emplace(material, index);
+
+	m_MaterialData.push_back(glm::vec4(material->GetDiffuseColor(), material->GetRoughness()));
+	m_MaterialData.push_back(glm::vec4(material->GetMetalness(),
+		(float)layers[0].Layer, (float)layers[1].Layer, (float)layers[2].Layer));
+	m_MaterialData.push_back(glm::vec4((float)layers[3].Layer, (float)layers[4].Layer, 0.0f, 0.0f));
+	return index;
+}
+
+bool Renderer::IsMultiDrawActive() const
+{
+	return m_MultiDraw && GLExtensions::HasMultiDrawIndirect();
+}
+
+// ------------------------------------------------------------
+// Draw m_Batches[first, first + count), which share one arena
+// block; returns the number of draw calls issued
+// ------------------------------------------------------------
+uint32_t Renderer::SubmitBatches(size_t first, size_t count)
+{
+	if (IsMultiDrawActive())
+	{
+		// baseInstance offsets the stream -- attributes start at 0
+		m_InstanceBuffer->BindAttributes(0);
+		m_IndirectBuffer->Bind();
+		// One block = one index type
+		GLenum indexType = m_Batches[first].First->Source->GetMesh()->GetIndexType();
+		GLExtensions::MultiDrawElementsIndirect(GL_TRIANGLES, indexType,
+			(const void*)(first * sizeof(DrawElementsIndirectCommand)), (GLsizei)count, 0);
+		return 1;
+	}
+
+	// GL 3.3: no base instance, re-point the stream per batch
+	for (size_t i = first; i < first + count; i++)
+	{
+		const DrawBatch& batch = m_Batches[i];
+		m_InstanceBuffer->BindAttributes(batch.FirstInstance);
+		batch.First->Source->GetMesh()->DrawInstanced(batch.Count, batch.First->LOD);
+	}
+	return (uint32_t)count;
+}
+
+// ------------------------------------------------------------
+// Depth-only pass over the same batches: one program, so runs
+// only break on the arena block
+// ------------------------------------------------------------
+void Renderer::DrawDepthPrepass()
+{
+	if (m_Batches.empty())
+		return;
+
+	m_DepthShader->Bind();
+	m_Stats.ProgramBinds++;
+
+	size_t first = 0;
+	while (first < m_Batches.size())
+	{
+		unsigned int vertexArray = m_Batches[first].VertexArray;
+
+		size_t end = first + 1;
+		while (end < m_Batches.size() && m_Batches[end].VertexArray == vertexArray)
+			end++;
+
+		GLState::BindVertexArray(vertexArray);
+		m_Stats.MeshBinds++;
+
+		m_Stats.PrepassDrawCalls += SubmitBatches(first, end - first);
+		first = end;
+	}
+}
+
+// ------------------------------------------------------------
+// Shading pass in key order. Binds matching the previous run are
+// skipped; a run ends where variant, textures or block change.
+// ------------------------------------------------------------
+void Renderer::DrawQueue()
+{
+	const ShaderVariant* boundVariant = nullptr;
+	unsigned int boundVertexArray = 0;
+	uint32_t boundTextureSet = UINT32_MAX;
+
+	size_t first = 0;
+	while (first < m_Batches.size())
+	{
+		const DrawBatch& batch = m_Batches[first];
+		const DrawItem& item = *batch.First;
+
+		if (item.Variant != boundVariant)
 		{
-			shader.SetVec3("u_DirectionalLight.color", light.GetColor());
-			shader.SetFloat("u_DirectionalLight.intensity", light.GetIntensity());
-			dirCount++;
+			item.Variant->Program->Bind();
+			boundVariant = item.Variant;
+			m_Stats.ProgramBinds++;
 		}
-		else if (light.GetType() == LightType::Point)
+
+		// Texture units are global state -- they survive program switches
+		if (item.TextureSetID != boundTextureSet)
 		{
-			std::string base = "u_PointLights[" + std::to_string(pointCount) + "]";
-			shader.SetVec3(base + ".position", light.GetPosition());
-			shader.SetVec3(base + ".color", light.GetColor());
-			shader.SetFloat(base + ".intensity", light.GetIntensity());
-			pointCount++;
+			if (m_MaterialBinding == MaterialBinding::TextureArrays)
+				item.Source->GetMaterial()->BindTextureArrays();
+			else
+				item.Source->GetMaterial()->BindTextures();
+			boundTextureSet = item.TextureSetID;
+			m_Stats.TextureSetBinds++;
 		}
+
+		if (batch.VertexArray != boundVertexArray)
+		{
+			GLState::BindVertexArray(batch.VertexArray);
+			boundVertexArray = batch.VertexArray;
+			m_Stats.MeshBinds++;
+		}
+
+		size_t end = first + 1;
+		while (end < m_Batches.size() &&
+			m_Batches[end].First->Variant == item.Variant &&
+			m_Batches[end].First->TextureSetID == item.TextureSetID &&
+			m_Batches[end].VertexArray == batch.VertexArray)
+		{
+			end++;
+		}
+
+		m_Stats.DrawCalls += SubmitBatches(first, end - first);
+		m_Stats.DrawCommands += (uint32_t)(end - first);
+		for (size_t i = first; i < end; i++)
+		{
+			const DrawBatch& counted = m_Batches[i];
+			uint32_t lod = counted.First->LOD;
+			m_Stats.Instances += counted.Count;
+			m_Stats.Triangles += counted.Count * (counted.First->Source->GetMesh()->GetLOD(lod).IndexCount / 3);
+			m_Stats.LODInstances[lod] += counted.Count;
+		}
+
+		first = end;
+	}
+}
+
+// ------------------------------------------------------------
+// Scene geometry into the bound target, with the optional
+// depth pre-pass in front
+// ------------------------------------------------------------
+void Renderer::DrawGeometry()
+{
+	if (m_DepthPrepass)
+	{
+		GLState::SetColorWrite(false);
+		DrawDepthPrepass();
+
+		// Depth is final: shade only the surviving fragment of each pixel
+		GLState::SetColorWrite(true);
+		GLState::SetDepthWrite(false);
+		GLState::SetDepthFunc(GL_EQUAL);
 	}
 
-	shader.SetInt("u_PointLightCount", pointCount);
-	shader.SetInt("u_HasDirectionalLight", dirCount > 0 ? 1 : 0);
+	DrawQueue();
+
+	GLState::SetDepthFunc(GL_LESS);
+	GLState::SetDepthWrite(true);
 }
 
 // ------------------------------------------------------------
-// Draw a single entity
+// Deferred lighting into the bound output. The full-screen pass
+// also copies the G-buffer depth, so point light volumes are depth
+// tested against the scene: back faces drawn with GL_GEQUAL pass
+// only where a surface lies in front of the far side of the sphere,
+// which also covers a camera inside the volume.
 // ------------------------------------------------------------
-void Renderer::DrawEntity(const Entity& entity, Shader& shader)
+void Renderer::DrawDeferredLighting(const Camera& camera, float aspectRatio,
+	unsigned int albedo, unsigned int normal, unsigned int depth)
 {
-	// Material uploads PBR texture maps + shader uniforms
-	entity.GetMaterial()->Apply(shader);
+	int width = m_RenderWidth;
+	int height = m_RenderHeight;
+
+	GLState::BindTexture(GBufferAlbedoUnit, GL_TEXTURE_2D, albedo);
+	GLState::BindTexture(GBufferNormalUnit, GL_TEXTURE_2D, normal);
+	GLState::BindTexture(GBufferDepthUnit, GL_TEXTURE_2D, depth);
+
+	// Window coordinates -> NDC -> world
+	glm::mat4 windowToNDC = glm::translate(glm::mat4(1.0f), glm::vec3(-1.0f)) *
+		glm::scale(glm::mat4(1.0f), glm::vec3(2.0f / width, 2.0f / height, 2.0f));
+	glm::mat4 screenToWorld = glm::inverse(
+		camera.GetProjectionMatrix(aspectRatio) * camera.GetViewMatrix()) * windowToNDC;
+
+	// 1) Ambient + directional, one full-screen triangle writing depth
+	GLState::SetDepthTest(true);
+	GLState::SetDepthFunc(GL_ALWAYS);
+	GLState::SetDepthWrite(true);
+
+	m_DeferredDirectionalShader->Bind();
+	m_DeferredDirectionalShader->SetMat4("u_ScreenToWorld", screenToWorld);
+	GLState::BindVertexArray(m_FullscreenVAO);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	m_Stats.ProgramBinds++;
+
+	// 2) Point lights, one instanced sphere per light, added on top
+	uint32_t lightCount = m_LightClusters->GetLightCount();
+	if (lightCount > 0)
+	{
+		GLState::SetDepthWrite(false);
+		GLState::SetDepthFunc(GL_GEQUAL);
+		GLState::SetBlend(true);
+		GLState::SetBlendFunc(GL_ONE, GL_ONE);
+		GLState::SetFaceCulling(true);
+		GLState::SetCullFace(GL_FRONT);
+
+		m_LightVolumeShader->Bind();
+		m_LightVolumeShader->SetMat4("u_ScreenToWorld", screenToWorld);
+		m_LightVolumeMesh->Bind();
+		m_LightVolumeMesh->DrawInstanced(lightCount);
+		m_Stats.ProgramBinds++;
+
+		GLState::SetCullFace(GL_BACK);
+		GLState::SetFaceCulling(false);
+		GLState::SetBlend(false);
+	}
+
+	m_Stats.LightVolumes = lightCount;
+
+	GLState::SetDepthFunc(GL_LESS);
+	GLState::SetDepthWrite(true);
+}
+
+// ------------------------------------------------------------
+// Stretch the rendered region of 'source' over the bound output
+// ------------------------------------------------------------
+void Renderer::DrawUpscale(unsigned int source)
+{
+	float allocatedWidth = (float)m_Framebuffer->GetAllocatedWidth();
+	float allocatedHeight = (float)m_Framebuffer->GetAllocatedHeight();
+	float outputWidth = (float)m_Framebuffer->GetWidth();
+	float outputHeight = (float)m_Framebuffer->GetHeight();
+
+	GLState::SetDepthTest(false);
+	GLState::BindTexture(0, GL_TEXTURE_2D, source);
+
+	m_UpscaleShader->Bind();
+	m_UpscaleShader->SetVec2("u_UVScale", glm::vec2(
+		m_RenderWidth / outputWidth / allocatedWidth,
+		m_RenderHeight / outputHeight / allocatedHeight));
+	m_UpscaleShader->SetVec2("u_UVMax", glm::vec2(
+		(m_RenderWidth - 0.5f) / allocatedWidth,
+		(m_RenderHeight - 0.5f) / allocatedHeight));
+
+	GLState::BindVertexArray(m_FullscreenVAO);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	m_Stats.ProgramBinds++;
+
+	GLState::SetDepthTest(true);
+}
+
+// ------------------------------------------------------------
+// Passes for this frame. Geometry passes clear and draw the queue
+// built in Render(); the output framebuffer is imported, so the
+// pass writing it is always kept. Below full resolution the scene
+// goes to transient SceneColor/SceneDepth targets and an Upscale
+// pass fills the output.
+// ------------------------------------------------------------
+void Renderer::BuildFrameGraph(const Camera& camera, float aspectRatio)
+{
+	int width = m_RenderWidth;
+	int height = m_RenderHeight;
+	bool upscale = width != m_Framebuffer->GetWidth() || height != m_Framebuffer->GetHeight();
+
+	m_FrameGraph.Reset();
+	FrameGraphResource output = m_FrameGraph.ImportFramebuffer("Output", m_Framebuffer);
 
-	glm::mat4 model = entity.GetTransform().GetMatrix();
-	shader.SetMat4("u_Model", model);
+	// Transients match the output's storage, so the pool keeps handing back
+	// the same textures while the viewport stays in its bucket and the
+	// render scale changes
+	FrameGraphTextureDesc desc;
+	desc.Width = m_Framebuffer->GetAllocatedWidth();
+	desc.Height = m_Framebuffer->GetAllocatedHeight();
 
-	entity.GetMesh()->Bind();
-	entity.GetMesh()->Draw();
+	// Handles live in a member: execute callbacks run after this returns
+	FrameTargets& targets = m_Targets;
+	targets = FrameTargets();
+
+	// Target of the last scene pass
+	auto writeSceneColor = [&](FrameGraphBuilder& builder)
+	{
+		if (!upscale)
+		{
+			builder.Write(output);
+			return;
+		}
+
+		desc.Format = FramebufferTextureFormat::RGBA8;
+		targets.SceneColor = builder.Create("SceneColor", desc);
+		desc.Format = FramebufferTextureFormat::Depth24Stencil8;
+		builder.Create("SceneDepth", desc);
+	};
+
+	if (m_RenderPath == RenderPath::Forward)
+	{
+		m_FrameGraph.AddPass("Forward",
+			[&](FrameGraphBuilder& builder)
+			{
+				writeSceneColor(builder);
+			},
+			[this, width, height](const FrameGraphResources& resources)
+			{
+				resources.BindRenderTarget();
+				glViewport(0, 0, width, height);
+
+				glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+				glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+				DrawGeometry();
+			});
+	}
+	else
+	{
+		// G-buffer layout
+		//   Albedo  RGBA8    albedo, metalness
+		//   Normal  RGB10A2  octahedral normal, roughness
+		//   Depth   sampled by the lighting passes
+		m_FrameGraph.AddPass("GBuffer",
+			[&](FrameGraphBuilder& builder)
+			{
+				desc.Format = FramebufferTextureFormat::RGBA8;
+				targets.GBufferAlbedo = builder.Create("GBufferAlbedo", desc);
+				desc.Format = FramebufferTextureFormat::RGB10A2;
+				targets.GBufferNormal = builder.Create("GBufferNormal", desc);
+				desc.Format = FramebufferTextureFormat::Depth24Stencil8;
+				targets.GBufferDepth = builder.Create("GBufferDepth", desc);
+			},
+			[this, width, height](const FrameGraphResources& resources)
+			{
+				resources.BindRenderTarget();
+				glViewport(0, 0, width, height);
+
+				glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+				glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+				DrawGeometry();
+			});
+
+		m_FrameGraph.AddPass("DeferredLighting",
+			[&](FrameGraphBuilder& builder)
+			{
+				builder.Read(targets.GBufferAlbedo);
+				builder.Read(targets.GBufferNormal);
+				builder.Read(targets.GBufferDepth);
+				writeSceneColor(builder);
+			},
+			[this, &camera, aspectRatio, width, height](const FrameGraphResources& resources)
+			{
+				resources.BindRenderTarget();
+				glViewport(0, 0, width, height);
+
+				glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+				glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+				DrawDeferredLighting(camera, aspectRatio, resources.GetTexture(m_Targets.GBufferAlbedo),
+					resources.GetTexture(m_Targets.GBufferNormal), resources.GetTexture(m_Targets.GBufferDepth));
+			});
+	}
+
+	if (upscale)
+	{
+		m_FrameGraph.AddPass("Upscale",
+			[&](FrameGraphBuilder& builder)
+			{
+				builder.Read(targets.SceneColor);
+				builder.Write(output);
+			},
+			[this](const FrameGraphResources& resources)
+			{
+				resources.BindRenderTarget();
+				glViewport(0, 0, m_Framebuffer->GetWidth(), m_Framebuffer->GetHeight());
+
+				DrawUpscale(resources.GetTexture(m_Targets.SceneColor));
+			});
+	}
 }
 
 // ------------------------------------------------------------
@@ -118,29 +852,57 @@ void Renderer::Render(const Scene& scene)
 		return;
 	}
 
-	// Bind FBO
-	m_Framebuffer->Bind();
+	m_Stats = RenderStats();
+
+	GLState::ResetCounters();
+
+	GLState::SetDepthTest(true);
+	GLState::SetDepthWrite(true);
+	GLState::SetDepthFunc(GL_LESS);
+	GLState::SetBlend(false);
 
 	int fbWidth = m_Framebuffer->GetWidth();
 	int fbHeight = m_Framebuffer->GetHeight();
+	float aspectRatio = (float)fbWidth / (float)fbHeight;
 
-	glViewport(0, 0, fbWidth, fbHeight);
+	// Internal resolution for this frame (output size unless scaled down)
+	m_DynamicResolution.GetRenderSize(fbWidth, fbHeight, m_RenderWidth, m_RenderHeight);
 
-	glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	// Lights first: the cluster parameters in FrameData depend on the projection
+	SetupLights(scene.GetLights(), scene.GetCamera(), aspectRatio);
+	SetupCamera(scene.GetCamera(), aspectRatio, m_RenderWidth, m_RenderHeight);
 
-	Shader& shader = *m_DefaultShader;
-	shader.Bind();
+	BuildQueue(scene, aspectRatio);
+	PrepareBatches();
 
-	float aspectRatio = (float)fbWidth / (float)fbHeight;
+	BuildFrameGraph(scene.GetCamera(), aspectRatio);
+	m_FrameGraph.Compile();
+
+	m_GPUTimer->Begin();
+	m_FrameGraph.Execute();
+	m_GPUTimer->End();
+
+	// Results lag a few frames; the controller sees each one once
+	if (m_GPUTimer->Poll())
+		m_DynamicResolution.Update(m_GPUTimer->GetLastMs());
+
+	m_Stats.GpuFrameMs = m_GPUTimer->GetLastMs();
+	m_Stats.RenderScale = m_DynamicResolution.GetScale();
+	m_Stats.RenderWidth = m_RenderWidth;
+	m_Stats.RenderHeight = m_RenderHeight;
+
+	m_Stats.DepthPrepass = m_DepthPrepass;
+	m_Stats.Deferred = m_RenderPath == RenderPath::Deferred;
+	m_Stats.Graph = m_FrameGraph.GetStats();
 
-	SetupCamera(scene.GetCamera(), shader, aspectRatio);
-	SetupLights(scene.GetLights(), shader);
+	GLState::BindVertexArray(0);
+	GLState::UseProgram(0);
 
-	for (const auto& entity : scene.GetEntities())
-		DrawEntity(entity, shader);
+	// Free render targets left over from earlier viewport sizes
+	m_TargetPool.EndFrame();
 
-	shader.Unbind();
+	m_Stats.StateCallsIssued = GLState::GetCounters().Issued;
+	m_Stats.StateCallsSkipped = GLState::GetCounters().Skipped;
 
 	// Unbind FBO  back to screen (so ImGui can draw)
 	m_Framebuffer->Unbind();
@@ -1,10 +1,87 @@
 #pragma once
 
 #include "Scene/Scene.h"
-#include "Graphics/Shader.h"
+#include "Graphics/ShaderVariantCache.h"
+#include "Graphics/RenderQueue.h"
+#include "Graphics/InstanceBuffer.h"
+#include "Graphics/IndirectBuffer.h"
+#include "Graphics/RenderTargetPool.h"
+#include "Graphics/FrameGraph.h"
+#include "Graphics/DynamicResolution.h"
 
 // Forward declaration -- defined in Graphics/Framebuffer.h
 class Framebuffer;
+class Shader;
+class UniformBuffer;
+class InstanceBuffer;
+class LightClusters;
+class Mesh;
+class GPUTimer;
+class TextureBuffer;
+
+// How point lights reach the PBR shader
+enum class LightAssignment
+{
+	Clustered,   // per-fragment lists from the view-space cluster grid
+	PerObject    // up to MaxObjectLights per entity, in the instance stream
+};
+
+// Where surfaces are lit
+enum class RenderPath
+{
+	Forward,    // PBR shading per draw
+	Deferred    // G-buffer pass, then screen-space lighting passes
+};
+
+// How material maps and parameters reach the shaders
+enum class MaterialBinding
+{
+	PerMaterial,    // one variant per feature mask, maps bound as 2D textures
+	TextureArrays   // one variant, maps as array layers, parameters in a buffer
+};
+
+// Per-frame counters, reset at the start of Render()
+struct RenderStats
+{
+	uint32_t DrawCalls = 0;          // API calls (one multi-draw counts once)
+	uint32_t DrawCommands = 0;       // instanced batches submitted
+	uint32_t Instances = 0;
+	uint32_t Triangles = 0;          // shading pass, after LOD selection
+	uint32_t LODInstances[4] = {};   // instances per level (Mesh::MaxLODs)
+	uint32_t Culled = 0;
+	uint32_t ProgramBinds = 0;
+	uint32_t TextureSetBinds = 0;
+	uint32_t MeshBinds = 0;          // arena block (VAO) switches
+	uint32_t Materials = 0;          // texture-array mode: records in the material buffer
+	uint32_t TextureArrays = 0;
+
+	// Clustered lighting
+	uint32_t PointLights = 0;
+	uint32_t ClusterLightRefs = 0;   // light indices over all clusters
+	float    LightBinningMs = 0.0f;  // CPU time to bin and upload
+	uint32_t ObjectLightRefs = 0;    // per-object mode: light indices over all draws
+
+	// Depth pre-pass (0 draws when disabled)
+	bool     DepthPrepass = false;
+	uint32_t PrepassDrawCalls = 0;
+
+	// Deferred path (0 volumes when forward)
+	bool     Deferred = false;
+	uint32_t LightVolumes = 0;
+
+	// Dynamic resolution (GpuFrameMs lags a few frames behind)
+	float    GpuFrameMs = 0.0f;
+	float    RenderScale = 1.0f;
+	int      RenderWidth = 0;
+	int      RenderHeight = 0;
+
+	// Passes and transient memory of this frame's graph
+	FrameGraph::Stats Graph;
+
+	// GLState filtering (binds + fixed-function state)
+	uint32_t StateCallsIssued = 0;
+	uint32_t StateCallsSkipped = 0;
+};
 
 class Renderer
 {
@@ -19,6 +96,11 @@ public:
 	void SetFramebuffer(Framebuffer* framebuffer);
 	Framebuffer* GetFramebuffer() const { return m_Framebuffer; }
 
+	// Attachments of the G-buffer and (when created with it) the output
+	// framebuffer are recycled through this pool
+	RenderTargetPool& GetRenderTargetPool() { return m_TargetPool; }
+	const RenderTargetPool& GetRenderTargetPool() const { return m_TargetPool; }
+
 	// ------------------------------------------------------------
 	// Still kept for UI code that may call it.
 	// ------------------------------------------------------------
@@ -29,14 +111,185 @@ public:
 	// ------------------------------------------------------------
 	void Render(const Scene& scene);
 
+	const RenderStats& GetStats() const { return m_Stats; }
+
+	// ------------------------------------------------------------
+	// Depth pre-pass: lay down depth with a position-only shader,
+	// then shade with GL_EQUAL so each pixel runs PBR once
+	// ------------------------------------------------------------
+	void SetDepthPrepass(bool enabled) { m_DepthPrepass = enabled; }
+	bool IsDepthPrepassEnabled() const { return m_DepthPrepass; }
+
+	// ------------------------------------------------------------
+	// Point light path; PerObject picks the strongest lights whose
+	// radius reaches each entity's bounds
+	// ------------------------------------------------------------
+	static constexpr uint32_t MaxObjectLights = 8;   // MAX_OBJECT_LIGHTS in pbr.*
+
+	void SetLightAssignment(LightAssignment mode) { m_LightAssignment = mode; }
+	LightAssignment GetLightAssignment() const { return m_LightAssignment; }
+
+	// ------------------------------------------------------------
+	// Deferred: draws write the G-buffer, then a full-screen pass adds
+	// the directional light and one sphere volume per point light
+	// adds that light where it covers a surface
+	// ------------------------------------------------------------
+	static constexpr unsigned int GBufferAlbedoUnit = 8;   // after the light buffers (5..7)
+	static constexpr unsigned int GBufferNormalUnit = 9;
+	static constexpr unsigned int GBufferDepthUnit = 10;
+
+	void SetRenderPath(RenderPath path) { m_RenderPath = path; }
+	RenderPath GetRenderPath() const { return m_RenderPath; }
+
+	// ------------------------------------------------------------
+	// Internal render scale, driven by GPU frame time when enabled;
+	// the scaled image is upscaled into the output framebuffer
+	// ------------------------------------------------------------
+	DynamicResolution& GetDynamicResolution() { return m_DynamicResolution; }
+
+	// ------------------------------------------------------------
+	// Texture arrays: every material shares one program per pass;
+	// same-sized maps share an array, so batches break only on mesh
+	// ------------------------------------------------------------
+	void SetMaterialBinding(MaterialBinding mode) { m_MaterialBinding = mode; }
+	MaterialBinding GetMaterialBinding() const { return m_MaterialBinding; }
+
+	// ------------------------------------------------------------
+	// Multi-draw indirect: runs of batches sharing program, textures
+	// and arena block go out as one call. Without GL 4.3 (or the
+	// ARB extensions) the same runs are drawn batch by batch.
+	// ------------------------------------------------------------
+	void SetMultiDraw(bool enabled) { m_MultiDraw = enabled; }
+	bool IsMultiDrawEnabled() const { return m_MultiDraw; }
+	bool IsMultiDrawActive() const;
+
+	// ------------------------------------------------------------
+	// Mesh LODs: each entity draws the coarsest level whose error,
+	// projected at its distance, stays under ErrorPixels. Moving to
+	// a coarser level needs a margin (Hysteresis) to avoid popping
+	// back and forth at the threshold.
+	// ------------------------------------------------------------
+	struct LODSettings
+	{
+		bool  Enabled = true;
+		float ErrorPixels = 1.0f;
+		float Hysteresis = 0.25f;    // coarser only below (1 - h) * ErrorPixels
+	};
+
+	LODSettings& GetLODSettings() { return m_LODSettings; }
+
 private:
 	// Internal helpers
-	void SetupCamera(const Camera& camera, Shader& shader, float aspectRatio);
-	void SetupLights(const std::vector<Light>& lights, Shader& shader);
-	void DrawEntity(const Entity& entity, Shader& shader);
+	void SetupCamera(const Camera& camera, float aspectRatio, int viewportWidth, int viewportHeight);
+	void SetupLights(const std::vector<Light>& lights, const Camera& camera, float aspectRatio);
+	void BuildQueue(const Scene& scene, float aspectRatio);
+	uint32_t SelectLOD(const Mesh& mesh, const glm::mat4& model, const Camera& camera, uint32_t entityIndex);
+	void BuildLightBVH();
+	glm::uvec4 AssignObjectLights(const AABB& bounds);
+	void PrepareBatches();
+	uint32_t GetMaterialIndex(const Material* material);
+	uint32_t SubmitBatches(size_t first, size_t count);
+	void DrawDepthPrepass();
+	void DrawQueue();
+	void DrawGeometry();
+	void DrawDeferredLighting(const Camera& camera, float aspectRatio,
+		unsigned int albedo, unsigned int normal, unsigned int depth);
+	void DrawUpscale(unsigned int source);
+	void BuildFrameGraph(const Camera& camera, float aspectRatio);
 
 private:
-	Shader* m_DefaultShader = nullptr;
+	// Run of queue items sharing variant, textures and mesh
+	struct DrawBatch
+	{
+		const DrawItem* First;
+		size_t          FirstInstance;
+		unsigned int    Count;
+		unsigned int    VertexArray;   // arena block of the mesh
+	};
+
+	// PBR program specialized per material feature mask (compiled lazily)
+	ShaderVariantCache* m_ShaderVariants = nullptr;
+	ShaderVariantCache* m_ObjectLightVariants = nullptr;   // PER_OBJECT_LIGHTS
+
+	// TEXTURE_ARRAYS programs (only mask 0 is ever compiled) and the
+	// per-frame material records they read (see pbr.vert)
+	MaterialBinding                              m_MaterialBinding = MaterialBinding::PerMaterial;
+	ShaderVariantCache*                          m_ArrayVariants = nullptr;
+	ShaderVariantCache*                          m_ArrayObjectLightVariants = nullptr;
+	ShaderVariantCache*                          m_GBufferArrayVariants = nullptr;
+	TextureBuffer*                               m_MaterialBuffer = nullptr;
+	std::vector<glm::vec4>                       m_MaterialData;
+	std::unordered_map<const Material*, uint32_t> m_MaterialIndices;
+
+	// Sorted draw list rebuilt every frame
+	std::vector<uint32_t> m_VisibleEntities;
+	RenderQueue m_Queue;
+	RenderStats m_Stats;
+
+	// Per-instance stream: consecutive queue items that share variant,
+	// textures and mesh are drawn as one instanced batch
+	InstanceBuffer*           m_InstanceBuffer = nullptr;
+	std::vector<InstanceData> m_Instances;
+	std::vector<DrawBatch>    m_Batches;
+
+	// One indirect command per batch, same order as m_Batches
+	IndirectBuffer*                          m_IndirectBuffer = nullptr;
+	std::vector<DrawElementsIndirectCommand> m_Commands;
+	bool                                     m_MultiDraw = true;
+
+	// Level chosen for each entity last frame (indexed like Scene::GetEntities)
+	LODSettings          m_LODSettings;
+	std::vector<uint8_t> m_EntityLODs;
+	float                m_LODPixelScale = 0.0f;   // pixels per unit of error at distance 1
+
+	// Position-only program for the depth pre-pass
+	Shader* m_DepthShader = nullptr;
+	bool    m_DepthPrepass = false;
+
+	// Per-frame std140 blocks (FrameData / LightData), shared by all programs
+	UniformBuffer* m_FrameDataUBO = nullptr;
+	UniformBuffer* m_LightDataUBO = nullptr;
+
+	// Point lights binned per view-space cluster
+	LightClusters* m_LightClusters = nullptr;
+	LightAssignment m_LightAssignment = LightAssignment::Clustered;
+
+	// Per-object assignment: BVH over light spheres, one packed list per
+	// submitted item (indexed by DrawItem::TransformIndex)
+	BVH                                     m_LightBVH;
+	std::vector<AABB>                       m_LightBounds;
+	std::vector<uint32_t>                   m_LightCandidates;
+	std::vector<std::pair<float, uint32_t>> m_LightScores;   // (score, light index)
+	std::vector<glm::uvec4>                 m_ObjectLightLists;
+
+	// Render targets and the per-frame pass list drawing into them
+	RenderTargetPool m_TargetPool;
+	FrameGraph       m_FrameGraph{ m_TargetPool };
+
+	// Graph handles read by execute callbacks (layout: see BuildFrameGraph)
+	struct FrameTargets
+	{
+		FrameGraphResource GBufferAlbedo = InvalidFrameGraphResource;
+		FrameGraphResource GBufferNormal = InvalidFrameGraphResource;
+		FrameGraphResource GBufferDepth = InvalidFrameGraphResource;
+		FrameGraphResource SceneColor = InvalidFrameGraphResource;
+	};
+	FrameTargets m_Targets;
+
+	// Internal resolution
+	DynamicResolution m_DynamicResolution;
+	GPUTimer*         m_GPUTimer = nullptr;
+	Shader*           m_UpscaleShader = nullptr;
+	int               m_RenderWidth = 0;
+	int               m_RenderHeight = 0;
+
+	// Deferred path
+	RenderPath          m_RenderPath = RenderPath::Forward;
+	ShaderVariantCache* m_GBufferVariants = nullptr;
+	Shader*             m_DeferredDirectionalShader = nullptr;
+	Shader*             m_LightVolumeShader = nullptr;
+	Mesh*               m_LightVolumeMesh = nullptr;
+	unsigned int        m_FullscreenVAO = 0;   // attribute-less triangle
 
 	// NEW in Task10  all rendering happens into this FBO
 	Framebuffer* m_Framebuffer = nullptr;
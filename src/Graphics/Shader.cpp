@@ -1,9 +1,15 @@
 #include "Shader.h"
+#include "Graphics/UniformBuffer.h"
+#include "Graphics/ShaderCache.h"
+#include "Graphics/GLExtensions.h"
+#include "Graphics/GLState.h"
 #include "Utils/FileSystem.h"
 #include "Utils/Log.h"
 
 #include <glad/glad.h>
 #include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <set>
 
 static unsigned int CompileShader(unsigned int type, const std::string& source)
 {
@@ -23,17 +29,112 @@ static unsigned int CompileShader(unsigned int type, const std::string& source)
 	return shader;
 }
 
-Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath)
+// Replace each '#include "file"' line (path relative to the including file)
+// with that file's expanded source. A file is pasted at most once, so
+// shared headers need no guards.
+static std::string ExpandIncludes(const std::string& path, std::set<std::string>& included)
 {
-	std::string vertexSrc = FileSystem::ReadFile(vertexPath);
-	std::string fragmentSrc = FileSystem::ReadFile(fragmentPath);
+	if (!included.insert(path).second)
+		return "";
 
+	std::string source = FileSystem::ReadFile(path);
+	size_t slash = path.find_last_of("/\\");
+	std::string directory = slash == std::string::npos ? "" : path.substr(0, slash + 1);
+
+	std::string result;
+	size_t lineStart = 0;
+	while (lineStart < source.size())
+	{
+		size_t lineEnd = source.find('\n', lineStart);
+		if (lineEnd == std::string::npos)
+			lineEnd = source.size();
+
+		size_t first = source.find_first_not_of(" \t", lineStart);
+		size_t open = source.find('"', lineStart);
+		size_t close = open < lineEnd ? source.find('"', open + 1) : std::string::npos;
+		if (first < lineEnd && source.compare(first, 8, "#include") == 0 && close < lineEnd)
+			result += ExpandIncludes(directory + source.substr(open + 1, close - open - 1), included);
+		else
+			result.append(source, lineStart, lineEnd - lineStart);
+
+		result += '\n';
+		lineStart = lineEnd + 1;
+	}
+	return result;
+}
+
+static std::string ReadSource(const std::string& path)
+{
+	std::set<std::string> included;
+	return ExpandIncludes(path, included);
+}
+
+// Insert "#define X" lines right after the #version directive
+static std::string InjectDefines(const std::string& source, const std::vector<std::string>& defines)
+{
+	if (defines.empty())
+		return source;
+
+	std::string block;
+	for (const auto& define : defines)
+		block += "#define " + define + "\n";
+
+	size_t versionPos = source.find("#version");
+	if (versionPos == std::string::npos)
+		return block + source;
+
+	size_t lineEnd = source.find('\n', versionPos);
+	if (lineEnd == std::string::npos)
+		return source + "\n" + block;
+
+	return source.substr(0, lineEnd + 1) + block + source.substr(lineEnd + 1);
+}
+
+Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath,
+	const std::vector<std::string>& defines)
+{
+	// Cache key below hashes the preprocessed sources (includes expanded), so
+	// variants never collide and edits to a shared file invalidate the entry
+	std::string vertexSrc = InjectDefines(ReadSource(vertexPath), defines);
+	std::string fragmentSrc = InjectDefines(ReadSource(fragmentPath), defines);
+
+	m_RendererID = glCreateProgram();
+
+	// Fast path: program binary from a previous run
+	uint64_t cacheKey = ShaderCache::ComputeKey(vertexSrc, fragmentSrc);
+	if (ShaderCache::Load(cacheKey, m_RendererID))
+	{
+		Log::Info("Shader loaded from cache: " + vertexPath + " + " + fragmentPath);
+	}
+	else
+	{
+		// A rejected binary leaves the program unusable -- start over
+		glDeleteProgram(m_RendererID);
+		m_RendererID = glCreateProgram();
+
+		if (LinkFromSource(vertexSrc, fragmentSrc))
+			ShaderCache::Save(cacheKey, m_RendererID);
+	}
+
+	ReflectUniforms();
+	BindUniformBlocks();
+}
+
+// ------------------------------------------------------------
+// Compile both stages and link into m_RendererID
+// ------------------------------------------------------------
+bool Shader::LinkFromSource(const std::string& vertexSrc, const std::string& fragmentSrc)
+{
 	unsigned int vs = CompileShader(GL_VERTEX_SHADER, vertexSrc);
 	unsigned int fs = CompileShader(GL_FRAGMENT_SHADER, fragmentSrc);
 
-	m_RendererID = glCreateProgram();
 	glAttachShader(m_RendererID, vs);
 	glAttachShader(m_RendererID, fs);
+
+	// Ask the driver to keep a retrievable binary for ShaderCache
+	if (GLExtensions::HasProgramBinary())
+		GLExtensions::ProgramParameteri(m_RendererID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
 	glLinkProgram(m_RendererID);
 
 	int success;
@@ -45,49 +146,160 @@ Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath)
 		Log::Error(std::string("Shader Linking Failed: ") + infoLog);
 	}
 
+	glDetachShader(m_RendererID, vs);
+	glDetachShader(m_RendererID, fs);
 	glDeleteShader(vs);
 	glDeleteShader(fs);
+
+	return success != 0;
 }
 
 Shader::~Shader()
 {
+	GLState::OnProgramDeleted(m_RendererID);
 	glDeleteProgram(m_RendererID);
 }
 
 void Shader::Bind() const
 {
-	glUseProgram(m_RendererID);
+	GLState::UseProgram(m_RendererID);
 }
 
 void Shader::Unbind() const
 {
-	glUseProgram(0);
+	GLState::UseProgram(0);
 }
 
-int Shader::GetUniformLocation(const std::string& name) const
+// ------------------------------------------------------------
+// Build the flat uniform table once after linking
+// ------------------------------------------------------------
+void Shader::ReflectUniforms()
 {
-	int location = glGetUniformLocation(m_RendererID, name.c_str());
-	if (location == -1)
-		Log::Warn("Uniform '" + name + "' not found or unused.");
+	m_Uniforms.clear();
+
+	int count = 0;
+	glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORMS, &count);
+
+	char name[256];
+	for (int i = 0; i < count; i++)
+	{
+		int length = 0;
+		int size = 0;
+		GLenum type = 0;
+		glGetActiveUniform(m_RendererID, (GLuint)i, sizeof(name), &length, &size, &type, name);
+
+		// Members of uniform blocks have no location
+		int location = glGetUniformLocation(m_RendererID, name);
+		if (location == -1)
+			continue;
+
+		m_Uniforms.push_back({ UniformID::HashName(name), location, type, size });
+
+		// Arrays are reported as "name[0]" -- also register the bare name
+		if (length > 3 && std::string(name + length - 3) == "[0]")
+		{
+			name[length - 3] = '\0';
+			m_Uniforms.push_back({ UniformID::HashName(name), location, type, size });
+		}
+	}
+
+	std::sort(m_Uniforms.begin(), m_Uniforms.end(),
+		[](const UniformInfo& a, const UniformInfo& b) { return a.Hash < b.Hash; });
+}
+
+// ------------------------------------------------------------
+// Attach every active uniform block to its shared binding point
+// ------------------------------------------------------------
+void Shader::BindUniformBlocks()
+{
+	int count = 0;
+	glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+
+	char name[256];
+	for (int i = 0; i < count; i++)
+	{
+		glGetActiveUniformBlockName(m_RendererID, (GLuint)i, sizeof(name), nullptr, name);
+
+		int binding = UniformBuffer::GetBindingPoint(name);
+		if (binding < 0)
+		{
+			Log::Warn(std::string("Uniform block '") + name + "' has no binding point.");
+			continue;
+		}
+
+		glUniformBlockBinding(m_RendererID, (GLuint)i, (GLuint)binding);
+	}
+}
+
+int Shader::FindUniformLocation(UniformID id) const
+{
+	auto it = std::lower_bound(m_Uniforms.begin(), m_Uniforms.end(), id.Hash,
+		[](const UniformInfo& info, uint32_t hash) { return info.Hash < hash; });
+
+	if (it != m_Uniforms.end() && it->Hash == id.Hash)
+		return it->Location;
+	return -1;
+}
+
+// Report each missing name once instead of every frame
+int Shader::FindUniformLocationChecked(UniformID id) const
+{
+	int location = FindUniformLocation(id);
+	if (location == -1 &&
+		std::find(m_ReportedMissing.begin(), m_ReportedMissing.end(), id.Hash) == m_ReportedMissing.end())
+	{
+		m_ReportedMissing.push_back(id.Hash);
+		Log::Warn(std::string("Uniform '") + (id.Name ? id.Name : "?") + "' not found or unused.");
+	}
 	return location;
 }
 
-void Shader::SetMat4(const std::string& name, const glm::mat4& value) const
+void Shader::Set(UniformHandle<glm::mat4> handle, const glm::mat4& value) const
+{
+	glUniformMatrix4fv(handle.Location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void Shader::Set(UniformHandle<glm::vec2> handle, const glm::vec2& value) const
+{
+	glUniform2fv(handle.Location, 1, glm::value_ptr(value));
+}
+
+void Shader::Set(UniformHandle<glm::vec3> handle, const glm::vec3& value) const
+{
+	glUniform3fv(handle.Location, 1, glm::value_ptr(value));
+}
+
+void Shader::Set(UniformHandle<float> handle, float value) const
+{
+	glUniform1f(handle.Location, value);
+}
+
+void Shader::Set(UniformHandle<int> handle, int value) const
+{
+	glUniform1i(handle.Location, value);
+}
+
+void Shader::SetMat4(UniformID id, const glm::mat4& value) const
+{
+	Set(UniformHandle<glm::mat4>{ FindUniformLocationChecked(id) }, value);
+}
+
+void Shader::SetVec2(UniformID id, const glm::vec2& value) const
 {
-	glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, glm::value_ptr(value));
+	Set(UniformHandle<glm::vec2>{ FindUniformLocationChecked(id) }, value);
 }
 
-void Shader::SetVec3(const std::string& name, const glm::vec3& value) const
+void Shader::SetVec3(UniformID id, const glm::vec3& value) const
 {
-	glUniform3fv(GetUniformLocation(name), 1, glm::value_ptr(value));
+	Set(UniformHandle<glm::vec3>{ FindUniformLocationChecked(id) }, value);
 }
 
-void Shader::SetFloat(const std::string& name, float value) const
+void Shader::SetFloat(UniformID id, float value) const
 {
-	glUniform1f(GetUniformLocation(name), value);
+	Set(UniformHandle<float>{ FindUniformLocationChecked(id) }, value);
 }
 
-void Shader::SetInt(const std::string& name, int value) const
+void Shader::SetInt(UniformID id, int value) const
 {
-	glUniform1i(GetUniformLocation(name), value);
+	Set(UniformHandle<int>{ FindUniformLocationChecked(id) }, value);
 }
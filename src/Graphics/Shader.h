@@ -1,25 +1,101 @@
 #pragma once
 
 #include <string>
+#include <vector>
+#include <cstdint>
 #include <glm/glm.hpp>
 
+// ------------------------------------------------------------
+// Uniform name key -- FNV-1a hash, evaluated at compile time
+// when constructed from a literal in a constexpr context
+// ------------------------------------------------------------
+struct UniformID
+{
+	uint32_t    Hash = 0;
+	const char* Name = nullptr;   // diagnostics only, never owned
+
+	constexpr UniformID() = default;
+	constexpr UniformID(const char* name) : Hash(HashName(name)), Name(name) {}
+
+	// Runtime convenience (hashes at call time, Name must outlive the call)
+	UniformID(const std::string& name) : Hash(HashName(name.c_str())), Name(name.c_str()) {}
+
+	static constexpr uint32_t HashName(const char* s)
+	{
+		uint32_t hash = 2166136261u;
+		while (*s)
+		{
+			hash ^= static_cast<uint8_t>(*s++);
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+};
+
+// ------------------------------------------------------------
+// Pre-resolved uniform location; T selects the matching setter
+// ------------------------------------------------------------
+template<typename T>
+struct UniformHandle
+{
+	int Location = -1;
+
+	bool IsValid() const { return Location != -1; }
+};
+
 class Shader
 {
 public:
-	Shader(const std::string& vertexPath, const std::string& fragmentPath);
+	// 'defines' are injected as "#define NAME" after #version (shader variants);
+	// '#include "file"' lines are replaced by the file, relative to the shader
+	Shader(const std::string& vertexPath, const std::string& fragmentPath,
+		const std::vector<std::string>& defines = {});
 	~Shader();
 
 	void Bind() const;
 	void Unbind() const;
 
-	// Set uniform values
-	void SetMat4(const std::string& name, const glm::mat4& value) const;
-	void SetVec3(const std::string& name, const glm::vec3& value) const;
-	void SetFloat(const std::string& name, float value) const;
-	void SetInt(const std::string& name, int value) const;
+	// Resolve a typed handle from the reflected uniform table (no driver query).
+	// Uniforms the variant compiled out yield an invalid handle, which Set ignores.
+	template<typename T>
+	UniformHandle<T> GetUniform(UniformID id) const { return { FindUniformLocation(id) }; }
+
+	// Set uniform values through pre-resolved handles (hot path)
+	void Set(UniformHandle<glm::mat4> handle, const glm::mat4& value) const;
+	void Set(UniformHandle<glm::vec2> handle, const glm::vec2& value) const;
+	void Set(UniformHandle<glm::vec3> handle, const glm::vec3& value) const;
+	void Set(UniformHandle<float> handle, float value) const;
+	void Set(UniformHandle<int> handle, int value) const;
+
+	// Set uniform values by name (table lookup, no driver query; warns once if missing)
+	void SetMat4(UniformID id, const glm::mat4& value) const;
+	void SetVec2(UniformID id, const glm::vec2& value) const;
+	void SetVec3(UniformID id, const glm::vec3& value) const;
+	void SetFloat(UniformID id, float value) const;
+	void SetInt(UniformID id, int value) const;
+
+private:
+	// Active uniform reflected once after linking
+	struct UniformInfo
+	{
+		uint32_t     Hash;
+		int          Location;
+		unsigned int Type;     // GL type enum (GL_FLOAT_VEC3, GL_SAMPLER_2D, ...)
+		int          Count;    // array size, 1 for non-arrays
+	};
+
+	bool LinkFromSource(const std::string& vertexSrc, const std::string& fragmentSrc);
+	void ReflectUniforms();
+	void BindUniformBlocks();
+	int FindUniformLocation(UniformID id) const;
+	int FindUniformLocationChecked(UniformID id) const;
 
 private:
 	unsigned int m_RendererID;
 
-	int GetUniformLocation(const std::string& name) const;
+	// Sorted by hash for binary search
+	std::vector<UniformInfo> m_Uniforms;
+
+	// Names already reported missing, so each warning fires once
+	mutable std::vector<uint32_t> m_ReportedMissing;
 };
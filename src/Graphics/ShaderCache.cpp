@@ -0,0 +1,131 @@
+#include "ShaderCache.h"
+#include "Graphics/GLExtensions.h"
+#include "Utils/FileSystem.h"
+#include "Utils/Log.h"
+
+#include <vector>
+#include <cstring>
+#include <cstdio>
+
+const char* ShaderCache::s_Directory = "cache/shaders";
+
+namespace
+{
+	// File layout: header followed by the raw driver blob
+	struct CacheHeader
+	{
+		char     Magic[4];       // "GHPB"
+		uint32_t Version;
+		uint32_t BinaryFormat;
+		uint32_t Length;
+	};
+
+	constexpr uint32_t CacheVersion = 1;
+
+	// FNV-1a (64-bit), chained across several inputs
+	uint64_t HashBytes(uint64_t hash, const void* data, size_t size)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	uint64_t HashString(uint64_t hash, const char* str)
+	{
+		// Include the terminator so "ab"+"c" differs from "a"+"bc"
+		return str ? HashBytes(hash, str, std::strlen(str) + 1) : HashBytes(hash, "", 1);
+	}
+}
+
+// ------------------------------------------------------------
+// Key = sources + driver identity
+// ------------------------------------------------------------
+uint64_t ShaderCache::ComputeKey(const std::string& vertexSrc, const std::string& fragmentSrc)
+{
+	uint64_t hash = 14695981039346656037ull;
+	hash = HashString(hash, vertexSrc.c_str());
+	hash = HashString(hash, fragmentSrc.c_str());
+	hash = HashString(hash, (const char*)glGetString(GL_VENDOR));
+	hash = HashString(hash, (const char*)glGetString(GL_RENDERER));
+	hash = HashString(hash, (const char*)glGetString(GL_VERSION));
+	return hash;
+}
+
+std::string ShaderCache::GetEntryPath(uint64_t key)
+{
+	char name[32];
+	std::snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+	return std::string(s_Directory) + "/" + name;
+}
+
+// ------------------------------------------------------------
+// Try the cached binary (driver may reject it)
+// ------------------------------------------------------------
+bool ShaderCache::Load(uint64_t key, unsigned int program)
+{
+	if (!GLExtensions::HasProgramBinary())
+		return false;
+
+	std::vector<char> file;
+	if (!FileSystem::ReadBinaryFile(GetEntryPath(key), file))
+		return false;
+
+	CacheHeader header;
+	if (file.size() < sizeof(header))
+		return false;
+
+	std::memcpy(&header, file.data(), sizeof(header));
+	if (std::memcmp(header.Magic, "GHPB", 4) != 0 ||
+		header.Version != CacheVersion ||
+		header.Length != file.size() - sizeof(header))
+	{
+		Log::Warn("Shader cache entry is corrupt, recompiling: " + GetEntryPath(key));
+		return false;
+	}
+
+	GLExtensions::ProgramBinary(program, header.BinaryFormat,
+		file.data() + sizeof(header), (GLsizei)header.Length);
+
+	int success = 0;
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+	if (!success)
+	{
+		Log::Warn("Shader cache entry rejected by driver, recompiling: " + GetEntryPath(key));
+		return false;
+	}
+
+	return true;
+}
+
+// ------------------------------------------------------------
+// Write the linked program's binary
+// ------------------------------------------------------------
+void ShaderCache::Save(uint64_t key, unsigned int program)
+{
+	if (!GLExtensions::HasProgramBinary())
+		return;
+
+	int length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0)
+		return;
+
+	std::vector<char> file(sizeof(CacheHeader) + (size_t)length);
+
+	CacheHeader header;
+	std::memcpy(header.Magic, "GHPB", 4);
+	header.Version = CacheVersion;
+
+	GLenum format = 0;
+	GLExtensions::GetProgramBinary(program, length, nullptr, &format, file.data() + sizeof(header));
+	header.BinaryFormat = format;
+	header.Length = (uint32_t)length;
+	std::memcpy(file.data(), &header, sizeof(header));
+
+	if (FileSystem::CreateDirectories(s_Directory))
+		FileSystem::WriteBinaryFile(GetEntryPath(key), file.data(), file.size());
+}
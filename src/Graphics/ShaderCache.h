@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+// -----------------------------------------------------------------------------
+// ShaderCache -- on-disk program binaries (glGetProgramBinary / glProgramBinary)
+// Entries are keyed by the final GLSL sources plus the driver identity, so a
+// driver update or a source edit simply misses and recompiles.
+// -----------------------------------------------------------------------------
+
+class ShaderCache
+{
+public:
+	// Hash of sources + GL vendor/renderer/version strings
+	static uint64_t ComputeKey(const std::string& vertexSrc, const std::string& fragmentSrc);
+
+	// Load a cached binary into 'program'; false if missing or rejected
+	static bool Load(uint64_t key, unsigned int program);
+
+	// Store the binary of a successfully linked program
+	static void Save(uint64_t key, unsigned int program);
+
+private:
+	ShaderCache() = delete;
+
+	static std::string GetEntryPath(uint64_t key);
+
+private:
+	static const char* s_Directory;
+};
@@ -0,0 +1,44 @@
+#include "ShaderVariantCache.h"
+#include "Graphics/LightClusters.h"
+#include "Utils/Log.h"
+
+ShaderVariantCache::ShaderVariantCache(const std::string& vertexPath, const std::string& fragmentPath,
+	const std::vector<std::string>& defines)
+	: m_VertexPath(vertexPath), m_FragmentPath(fragmentPath), m_Defines(defines)
+{
+}
+
+ShaderVariantCache::~ShaderVariantCache()
+{
+	for (auto& entry : m_Variants)
+		delete entry.second.Program;
+	m_Variants.clear();
+}
+
+// ------------------------------------------------------------
+// Return the variant for a mask, compiling it the first time
+// ------------------------------------------------------------
+const ShaderVariant& ShaderVariantCache::Get(uint32_t featureMask)
+{
+	auto it = m_Variants.find(featureMask);
+	if (it != m_Variants.end())
+		return it->second;
+
+	ShaderVariant variant;
+	variant.FeatureMask = featureMask;
+	variant.Index = (uint32_t)m_Variants.size();
+	std::vector<std::string> defines = Material::GetFeatureDefines(featureMask);
+	if (featureMask & VariantFeature::PackedVertices)
+		defines.push_back("PACKED_VERTICES");
+	defines.insert(defines.end(), m_Defines.begin(), m_Defines.end());
+
+	variant.Program = new Shader(m_VertexPath, m_FragmentPath, defines);
+
+	// Sampler units never change -- assign them once per program
+	Material::BindSamplerUnits(*variant.Program);
+	LightClusters::BindSamplerUnits(*variant.Program);
+
+	Log::Info("Shader variant compiled (mask " + std::to_string(featureMask) + ")");
+
+	return m_Variants.emplace(featureMask, variant).first->second;
+}
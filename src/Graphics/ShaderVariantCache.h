@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+#include "Graphics/Shader.h"
+#include "Graphics/Material.h"
+
+// -----------------------------------------------------------------------------
+// ShaderVariantCache -- material shader specialized per MaterialFeature mask.
+// Variants are compiled on first use and memoized; sampler units are
+// assigned once at creation so nothing is set per draw.
+// -----------------------------------------------------------------------------
+
+// Variant bits above the MaterialFeature mask -- properties of the
+// geometry rather than the material
+namespace VariantFeature
+{
+	enum : uint32_t
+	{
+		PackedVertices = 1u << 16   // PACKED_VERTICES: octahedral normal/tangent
+	};
+}
+
+struct ShaderVariant
+{
+	Shader*  Program = nullptr;
+	uint32_t FeatureMask = 0;
+	uint32_t Index = 0;        // creation order, compact sort-key id
+};
+
+class ShaderVariantCache
+{
+public:
+	// 'defines' are added to every variant (e.g. a lighting path switch)
+	ShaderVariantCache(const std::string& vertexPath, const std::string& fragmentPath,
+		const std::vector<std::string>& defines = {});
+	~ShaderVariantCache();
+
+	// Compile-on-demand lookup (memoized per mask; MaterialFeature
+	// and VariantFeature bits)
+	const ShaderVariant& Get(uint32_t featureMask);
+
+	size_t GetVariantCount() const { return m_Variants.size(); }
+
+private:
+	std::string m_VertexPath;
+	std::string m_FragmentPath;
+	std::vector<std::string> m_Defines;
+
+	std::unordered_map<uint32_t, ShaderVariant> m_Variants;
+};
@@ -0,0 +1,517 @@
+#include "TangentGenerator.h"
+#include "Core/ThreadPool.h"
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TANGENT_GENERATOR_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	// Work is split into chunks of this many triangles / vertices
+	constexpr uint32_t GrainSize = 16384;
+
+	struct StreamReader
+	{
+		const TangentGenerator::Streams& S;
+
+		glm::vec3 Position(uint32_t v) const { return Load3(S.Positions, v); }
+		glm::vec3 Normal(uint32_t v) const { return Load3(S.Normals, v); }
+		glm::vec2 UV(uint32_t v) const
+		{
+			const float* p = reinterpret_cast<const float*>(reinterpret_cast<const char*>(S.UVs) + v * S.Stride);
+			return glm::vec2(p[0], p[1]);
+		}
+		float* Tangent(uint32_t v) const
+		{
+			return reinterpret_cast<float*>(reinterpret_cast<char*>(S.Tangents) + v * S.Stride);
+		}
+
+		glm::vec3 Load3(const float* base, uint32_t v) const
+		{
+			const float* p = reinterpret_cast<const float*>(reinterpret_cast<const char*>(base) + v * S.Stride);
+			return glm::vec3(p[0], p[1], p[2]);
+		}
+	};
+
+	glm::vec3 ProjectNormalized(const glm::vec3& v, const glm::vec3& n)
+	{
+		glm::vec3 p = v - n * glm::dot(n, v);
+		float lengthSq = glm::dot(p, p);
+		return lengthSq > 1e-20f ? p / std::sqrt(lengthSq) : glm::vec3(0.0f);
+	}
+
+	// Abramowitz & Stegun 4.4.45, |error| < 7e-5 rad -- plenty for a weight
+	float FastAcos(float x)
+	{
+		float a = glm::min(std::abs(x), 1.0f);
+		float r = std::sqrt(1.0f - a) * (1.5707288f + a * (-0.2121144f + a * (0.0742610f - 0.0187293f * a)));
+		return x < 0.0f ? 3.14159265f - r : r;
+	}
+
+	// Any unit vector perpendicular to n (no usable UV gradient)
+	glm::vec3 Perpendicular(const glm::vec3& n)
+	{
+		glm::vec3 axis = std::abs(n.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+		return glm::normalize(axis - n * glm::dot(n, axis));
+	}
+
+	// dP/du and dP/dv of a triangle (zero for degenerate UVs). The side
+	// of cross(dP/du, dP/dv) a vertex normal lies on is that corner's
+	// handedness -- dP/dv against cross(N, T) -- whatever the winding.
+	void FaceDerivatives(const StreamReader& in, const uint32_t* triangle, glm::vec3& dPdu, glm::vec3& dPdv)
+	{
+		glm::vec3 p0 = in.Position(triangle[0]);
+		glm::vec3 e1 = in.Position(triangle[1]) - p0, e2 = in.Position(triangle[2]) - p0;
+		glm::vec2 uv0 = in.UV(triangle[0]);
+		glm::vec2 d1 = in.UV(triangle[1]) - uv0, d2 = in.UV(triangle[2]) - uv0;
+
+		float det = d1.x * d2.y - d1.y * d2.x;
+		float inverse = det != 0.0f ? 1.0f / det : 0.0f;
+		dPdu = (e1 * d2.y - e2 * d1.y) * inverse;
+		dPdv = (e2 * d1.x - e1 * d2.x) * inverse;
+	}
+
+	// ------------------------------------------------------------
+	// One triangle's three corners: xyz = tangent * angle, w = +-angle
+	// by handedness (0 for degenerate UVs, which have none). Corner
+	// angles are taken in the triangle's plane; MikkTSpace projects
+	// the edges onto each vertex normal first, which only differs
+	// where the normal is far from the face's.
+	// ------------------------------------------------------------
+	void CornerTangents(const StreamReader& in, const uint32_t* triangle, glm::vec4* out)
+	{
+		glm::vec3 dPdu, dPdv;
+		FaceDerivatives(in, triangle, dPdu, dPdv);
+		glm::vec3 faceFrame = glm::cross(dPdu, dPdv);
+
+		glm::vec3 p[3] = { in.Position(triangle[0]), in.Position(triangle[1]), in.Position(triangle[2]) };
+
+		// Unit edges k -> k + 1
+		glm::vec3 edges[3] = { p[1] - p[0], p[2] - p[1], p[0] - p[2] };
+		for (glm::vec3& edge : edges)
+		{
+			float lengthSq = glm::dot(edge, edge);
+			edge = lengthSq > 1e-20f ? edge / std::sqrt(lengthSq) : glm::vec3(0.0f);
+		}
+
+		for (uint32_t k = 0; k < 3; k++)
+		{
+			glm::vec3 n = in.Normal(triangle[k]);
+			float angle = FastAcos(-glm::dot(edges[k], edges[(k + 2) % 3]));
+			float side = glm::dot(n, faceFrame);
+			float w = side < 0.0f ? -angle : (side > 0.0f ? angle : 0.0f);
+			out[k] = glm::vec4(ProjectNormalized(dPdu, n) * angle, w);
+		}
+	}
+
+#if TANGENT_GENERATOR_SSE
+	// Four triangles per lane set, same math as CornerTangents
+	struct Vec3x4
+	{
+		__m128 X, Y, Z;
+	};
+
+	Vec3x4 Sub(const Vec3x4& a, const Vec3x4& b) { return { _mm_sub_ps(a.X, b.X), _mm_sub_ps(a.Y, b.Y), _mm_sub_ps(a.Z, b.Z) }; }
+	Vec3x4 Mul(const Vec3x4& a, __m128 s) { return { _mm_mul_ps(a.X, s), _mm_mul_ps(a.Y, s), _mm_mul_ps(a.Z, s) }; }
+
+	__m128 Dot(const Vec3x4& a, const Vec3x4& b)
+	{
+		return _mm_add_ps(_mm_add_ps(_mm_mul_ps(a.X, b.X), _mm_mul_ps(a.Y, b.Y)), _mm_mul_ps(a.Z, b.Z));
+	}
+
+	Vec3x4 Cross(const Vec3x4& a, const Vec3x4& b)
+	{
+		return {
+			_mm_sub_ps(_mm_mul_ps(a.Y, b.Z), _mm_mul_ps(a.Z, b.Y)),
+			_mm_sub_ps(_mm_mul_ps(a.Z, b.X), _mm_mul_ps(a.X, b.Z)),
+			_mm_sub_ps(_mm_mul_ps(a.X, b.Y), _mm_mul_ps(a.Y, b.X)) };
+	}
+
+	// Zero where the length is (near) zero, like ProjectNormalized
+	Vec3x4 Normalize(const Vec3x4& v)
+	{
+		__m128 lengthSq = Dot(v, v);
+		__m128 valid = _mm_cmpgt_ps(lengthSq, _mm_set1_ps(1e-20f));
+		__m128 scale = _mm_and_ps(valid, _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(lengthSq)));
+		return Mul(v, scale);
+	}
+
+	__m128 FastAcos4(__m128 x)
+	{
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+		__m128 a = _mm_min_ps(_mm_andnot_ps(signMask, x), _mm_set1_ps(1.0f));
+		__m128 poly = _mm_add_ps(_mm_set1_ps(0.0742610f), _mm_mul_ps(a, _mm_set1_ps(-0.0187293f)));
+		poly = _mm_add_ps(_mm_set1_ps(-0.2121144f), _mm_mul_ps(a, poly));
+		poly = _mm_add_ps(_mm_set1_ps(1.5707288f), _mm_mul_ps(a, poly));
+		__m128 r = _mm_mul_ps(_mm_sqrt_ps(_mm_sub_ps(_mm_set1_ps(1.0f), a)), poly);
+
+		__m128 negative = _mm_cmplt_ps(x, _mm_setzero_ps());
+		return _mm_or_ps(_mm_and_ps(negative, _mm_sub_ps(_mm_set1_ps(3.14159265f), r)), _mm_andnot_ps(negative, r));
+	}
+
+	Vec3x4 Gather3(const StreamReader& in, const float* base, const uint32_t* triangles, uint32_t k)
+	{
+		glm::vec3 a = in.Load3(base, triangles[k]), b = in.Load3(base, triangles[3 + k]);
+		glm::vec3 c = in.Load3(base, triangles[6 + k]), d = in.Load3(base, triangles[9 + k]);
+		return { _mm_setr_ps(a.x, b.x, c.x, d.x), _mm_setr_ps(a.y, b.y, c.y, d.y), _mm_setr_ps(a.z, b.z, c.z, d.z) };
+	}
+
+	void CornerTangents4(const StreamReader& in, const uint32_t* triangles, glm::vec4* out)
+	{
+		Vec3x4 p[3];
+		__m128 u[3], v[3];
+		for (uint32_t k = 0; k < 3; k++)
+		{
+			p[k] = Gather3(in, in.S.Positions, triangles, k);
+			glm::vec2 a = in.UV(triangles[k]), b = in.UV(triangles[3 + k]);
+			glm::vec2 c = in.UV(triangles[6 + k]), d = in.UV(triangles[9 + k]);
+			u[k] = _mm_setr_ps(a.x, b.x, c.x, d.x);
+			v[k] = _mm_setr_ps(a.y, b.y, c.y, d.y);
+		}
+
+		Vec3x4 e1 = Sub(p[1], p[0]), e2 = Sub(p[2], p[0]);
+		__m128 d1u = _mm_sub_ps(u[1], u[0]), d1v = _mm_sub_ps(v[1], v[0]);
+		__m128 d2u = _mm_sub_ps(u[2], u[0]), d2v = _mm_sub_ps(v[2], v[0]);
+
+		__m128 det = _mm_sub_ps(_mm_mul_ps(d1u, d2v), _mm_mul_ps(d1v, d2u));
+		__m128 inverse = _mm_and_ps(_mm_cmpneq_ps(det, _mm_setzero_ps()), _mm_div_ps(_mm_set1_ps(1.0f), det));
+		Vec3x4 faceTangent = Mul(Sub(Mul(e1, d2v), Mul(e2, d1v)), inverse);
+		Vec3x4 faceBitangent = Mul(Sub(Mul(e2, d1u), Mul(e1, d2u)), inverse);
+		Vec3x4 faceFrame = Cross(faceTangent, faceBitangent);
+
+		Vec3x4 edges[3] = { Normalize(e1), Normalize(Sub(p[2], p[1])), Normalize(Sub(p[0], p[2])) };
+
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+		for (uint32_t k = 0; k < 3; k++)
+		{
+			Vec3x4 n = Gather3(in, in.S.Normals, triangles, k);
+			__m128 angle = FastAcos4(_mm_xor_ps(Dot(edges[k], edges[(k + 2) % 3]), signMask));
+
+			Vec3x4 tangent = Normalize(Sub(faceTangent, Mul(n, Dot(n, faceTangent))));
+			Vec3x4 weighted = Mul(tangent, angle);
+
+			__m128 side = Dot(n, faceFrame);
+			__m128 negative = _mm_cmplt_ps(side, _mm_setzero_ps());
+			__m128 w = _mm_and_ps(_mm_xor_ps(angle, _mm_and_ps(negative, signMask)),
+				_mm_cmpneq_ps(side, _mm_setzero_ps()));
+
+			// Lanes are triangles: transpose to one xyzw per corner
+			__m128 x = weighted.X, y = weighted.Y, z = weighted.Z;
+			_MM_TRANSPOSE4_PS(x, y, z, w);
+			_mm_storeu_ps(&out[k].x, x);
+			_mm_storeu_ps(&out[3 + k].x, y);
+			_mm_storeu_ps(&out[6 + k].x, z);
+			_mm_storeu_ps(&out[9 + k].x, w);
+		}
+	}
+#endif
+
+	// Gram-Schmidt against n; w = sign of the accumulated angle sum
+	void Orthonormalize(const glm::vec3& n, const glm::vec4& accumulated, float* out)
+	{
+		glm::vec3 t = ProjectNormalized(glm::vec3(accumulated), n);
+		if (t == glm::vec3(0.0f))
+			t = Perpendicular(n);
+
+		out[0] = t.x;
+		out[1] = t.y;
+		out[2] = t.z;
+		out[3] = accumulated.w < 0.0f ? -1.0f : 1.0f;
+	}
+
+	// Sums per vertex: xyzw of all corners (w = signed angle sum) plus the
+	// negative corners' angles alone, so a vertex whose corners disagree
+	// on handedness (a mirror seam) shows as both sides > 0
+	void Accumulate(glm::vec4* sums, float* negative, const uint32_t* triangle, const glm::vec4* corners,
+		uint32_t count)
+	{
+		for (uint32_t c = 0; c < count; c++)
+		{
+			sums[triangle[c]] += corners[c];
+			if (corners[c].w < 0.0f)
+				negative[triangle[c]] += corners[c].w;
+		}
+	}
+
+	// Seam vertices only: each side's sum, from a second look at the
+	// triangles using them
+	struct SeamSums
+	{
+		glm::vec4 Positive = glm::vec4(0.0f);
+		glm::vec4 Negative = glm::vec4(0.0f);
+	};
+
+	// Larger angle sum wins the vertex; the other side, if any, gets a
+	// copy (the SSE and scalar corner math can disagree on a corner
+	// lying exactly on the seam, so one side may turn out empty)
+	void ResolveSeam(const StreamReader& in, uint32_t v, const SeamSums& sum,
+		std::vector<TangentGenerator::Split>& splits)
+	{
+		const bool positive = sum.Positive.w >= -sum.Negative.w;
+		const glm::vec3 n = in.Normal(v);
+		Orthonormalize(n, positive ? sum.Positive : sum.Negative, in.Tangent(v));
+
+		if (sum.Positive.w > 0.0f && sum.Negative.w < 0.0f)
+		{
+			TangentGenerator::Split split;
+			split.Source = v;
+			Orthonormalize(n, positive ? sum.Negative : sum.Positive, split.Tangent);
+			splits.push_back(split);
+		}
+	}
+}
+
+// ------------------------------------------------------------
+// 1. each partition (a contiguous triangle range, one per thread)
+//    sums its corners. The first sums straight into the shared
+//    buffers; the others into private buffers covering only the
+//    vertex window they touch.
+// 2. per vertex chunk: any private windows are added in, then
+//    Gram-Schmidt against the normal + handedness, 4 at a time
+// 3. only if some vertex has corners of both handedness: those
+//    vertices' sides are summed apart and the vertex is split
+// ------------------------------------------------------------
+std::vector<TangentGenerator::Split> TangentGenerator::Generate(std::vector<uint32_t>& indices,
+	uint32_t vertexCount, const Streams& streams)
+{
+	const uint32_t triangleCount = (uint32_t)(indices.size() / 3);
+	if (vertexCount == 0)
+		return {};
+
+	const StreamReader in{ streams };
+	ThreadPool& pool = ThreadPool::Get();
+
+	struct Partition
+	{
+		uint32_t FirstTriangle = 0;
+		uint32_t EndTriangle = 0;
+		uint32_t FirstVertex = 0;
+		uint32_t VertexCount = 0;
+		std::vector<glm::vec4> Sums;   // FirstVertex..; empty for partition 0
+		std::vector<float> Negative;
+	};
+
+	uint32_t partitionCount = std::min(pool.GetWorkerCount() + 1, (triangleCount + GrainSize - 1) / GrainSize);
+	std::vector<Partition> partitions(std::max(partitionCount, 1u));
+	for (uint32_t i = 0; i < (uint32_t)partitions.size(); i++)
+	{
+		partitions[i].FirstTriangle = (uint32_t)((uint64_t)triangleCount * i / partitions.size());
+		partitions[i].EndTriangle = (uint32_t)((uint64_t)triangleCount * (i + 1) / partitions.size());
+	}
+
+	std::vector<glm::vec4> sums(vertexCount, glm::vec4(0.0f));
+	std::vector<float> negative(vertexCount, 0.0f);
+
+	pool.ParallelFor((uint32_t)partitions.size(), 1, [&](uint32_t begin, uint32_t end)
+	{
+		glm::vec4 corners[12];
+
+		for (uint32_t i = begin; i < end; i++)
+		{
+			Partition& partition = partitions[i];
+			const uint32_t* first = indices.data() + (size_t)partition.FirstTriangle * 3;
+			const uint32_t* last = indices.data() + (size_t)partition.EndTriangle * 3;
+			if (first == last)
+				continue;
+
+			glm::vec4* targetSums = sums.data();
+			float* targetNegative = negative.data();
+			if (i > 0)
+			{
+				auto window = std::minmax_element(first, last);
+				partition.FirstVertex = *window.first;
+				partition.VertexCount = *window.second - *window.first + 1;
+				partition.Sums.assign(partition.VertexCount, glm::vec4(0.0f));
+				partition.Negative.assign(partition.VertexCount, 0.0f);
+				targetSums = partition.Sums.data() - partition.FirstVertex;
+				targetNegative = partition.Negative.data() - partition.FirstVertex;
+			}
+
+			uint32_t t = partition.FirstTriangle;
+#if TANGENT_GENERATOR_SSE
+			for (; t + 4 <= partition.EndTriangle; t += 4)
+			{
+				const uint32_t* triangles = &indices[(size_t)t * 3];
+				CornerTangents4(in, triangles, corners);
+				Accumulate(targetSums, targetNegative, triangles, corners, 12);
+			}
+#endif
+			for (; t < partition.EndTriangle; t++)
+			{
+				const uint32_t* triangle = &indices[(size_t)t * 3];
+				CornerTangents(in, triangle, corners);
+				Accumulate(targetSums, targetNegative, triangle, corners, 3);
+			}
+		}
+	});
+
+	// Seam vertices per chunk, concatenated in vertex order afterwards
+	const uint32_t chunkCount = (vertexCount + GrainSize - 1) / GrainSize;
+	std::vector<std::vector<uint32_t>> chunkSeams(chunkCount);
+
+	pool.ParallelFor(vertexCount, GrainSize, [&](uint32_t begin, uint32_t end)
+	{
+		for (size_t p = 1; p < partitions.size(); p++)
+		{
+			const Partition& partition = partitions[p];
+			uint32_t from = std::max(begin, partition.FirstVertex);
+			uint32_t to = std::min(end, partition.FirstVertex + partition.VertexCount);
+			for (uint32_t v = from; v < to; v++)
+			{
+				sums[v] += partition.Sums[v - partition.FirstVertex];
+				negative[v] += partition.Negative[v - partition.FirstVertex];
+			}
+		}
+
+		std::vector<uint32_t>& seams = chunkSeams[begin / GrainSize];
+		uint32_t v = begin;
+
+#if TANGENT_GENERATOR_SSE
+		const __m128 epsilon = _mm_set1_ps(1e-20f);
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 minusOne = _mm_set1_ps(-1.0f);
+
+		for (; v + 4 <= end; v += 4)
+		{
+			// Lanes are vertices: transpose to SoA
+			__m128 tx = _mm_loadu_ps(&sums[v].x), ty = _mm_loadu_ps(&sums[v + 1].x);
+			__m128 tz = _mm_loadu_ps(&sums[v + 2].x), sum = _mm_loadu_ps(&sums[v + 3].x);
+			_MM_TRANSPOSE4_PS(tx, ty, tz, sum);
+
+			__m128 negativeSum = _mm_loadu_ps(&negative[v]);
+			int seam = _mm_movemask_ps(_mm_and_ps(_mm_cmpgt_ps(_mm_sub_ps(sum, negativeSum), zero),
+				_mm_cmplt_ps(negativeSum, zero)));
+
+			__m128 isNegative = _mm_cmplt_ps(sum, zero);
+			__m128 w = _mm_or_ps(_mm_and_ps(isNegative, minusOne), _mm_andnot_ps(isNegative, one));
+
+			glm::vec3 n0 = in.Normal(v), n1 = in.Normal(v + 1), n2 = in.Normal(v + 2), n3 = in.Normal(v + 3);
+			__m128 nx = _mm_setr_ps(n0.x, n1.x, n2.x, n3.x);
+			__m128 ny = _mm_setr_ps(n0.y, n1.y, n2.y, n3.y);
+			__m128 nz = _mm_setr_ps(n0.z, n1.z, n2.z, n3.z);
+
+			// t -= n * dot(n, t)
+			__m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, tx), _mm_mul_ps(ny, ty)), _mm_mul_ps(nz, tz));
+			tx = _mm_sub_ps(tx, _mm_mul_ps(nx, d));
+			ty = _mm_sub_ps(ty, _mm_mul_ps(ny, d));
+			tz = _mm_sub_ps(tz, _mm_mul_ps(nz, d));
+
+			__m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, tx), _mm_mul_ps(ty, ty)), _mm_mul_ps(tz, tz));
+			int valid = _mm_movemask_ps(_mm_cmpgt_ps(lengthSq, epsilon));
+
+			// Full-precision divide: rsqrt's 12 bits would show in the lighting
+			__m128 scale = _mm_div_ps(one, _mm_sqrt_ps(_mm_max_ps(lengthSq, epsilon)));
+			tx = _mm_mul_ps(tx, scale);
+			ty = _mm_mul_ps(ty, scale);
+			tz = _mm_mul_ps(tz, scale);
+
+			_MM_TRANSPOSE4_PS(tx, ty, tz, w);
+			_mm_storeu_ps(in.Tangent(v), tx);
+			_mm_storeu_ps(in.Tangent(v + 1), ty);
+			_mm_storeu_ps(in.Tangent(v + 2), tz);
+			_mm_storeu_ps(in.Tangent(v + 3), w);
+
+			// Lanes without a tangent (unreferenced or no UV gradient) take
+			// the scalar path; seams are finished in step 3
+			for (uint32_t lane = 0; lane < 4; lane++)
+			{
+				if (seam & (1 << lane))
+					seams.push_back(v + lane);
+				else if (!(valid & (1 << lane)))
+					Orthonormalize(in.Normal(v + lane), sums[v + lane], in.Tangent(v + lane));
+			}
+		}
+#endif
+
+		for (; v < end; v++)
+		{
+			if (sums[v].w - negative[v] > 0.0f && negative[v] < 0.0f)
+				seams.push_back(v);
+			else
+				Orthonormalize(in.Normal(v), sums[v], in.Tangent(v));
+		}
+	});
+
+	std::vector<uint32_t> seams;
+	for (const std::vector<uint32_t>& chunk : chunkSeams)
+		seams.insert(seams.end(), chunk.begin(), chunk.end());
+	if (seams.empty())
+		return {};
+
+	// 3. Rare (mirrored UVs only) and touches few triangles: one thread
+	const uint32_t none = UINT32_MAX;
+	std::vector<uint32_t> seamOf(vertexCount, none);
+	for (uint32_t i = 0; i < (uint32_t)seams.size(); i++)
+		seamOf[seams[i]] = i;
+
+	std::vector<SeamSums> seamSums(seams.size());
+	glm::vec4 corners[3];
+	for (size_t t = 0; t + 3 <= indices.size(); t += 3)
+	{
+		const uint32_t* triangle = &indices[t];
+		if (seamOf[triangle[0]] == none && seamOf[triangle[1]] == none && seamOf[triangle[2]] == none)
+			continue;
+
+		CornerTangents(in, triangle, corners);
+		for (uint32_t k = 0; k < 3; k++)
+		{
+			uint32_t seam = seamOf[triangle[k]];
+			if (seam != none)
+				(corners[k].w < 0.0f ? seamSums[seam].Negative : seamSums[seam].Positive) += corners[k];
+		}
+	}
+
+	std::vector<Split> splits;
+	for (size_t i = 0; i < seams.size(); i++)
+		ResolveSeam(in, seams[i], seamSums[i], splits);
+
+	RemapSplits(indices, vertexCount, streams, splits);
+	return splits;
+}
+
+// ------------------------------------------------------------
+// A corner moves to its vertex's copy when its triangle has the
+// copy's handedness at that vertex; corners without one (degenerate
+// UVs) stay on the original
+// ------------------------------------------------------------
+void TangentGenerator::RemapSplits(std::vector<uint32_t>& indices, uint32_t vertexCount, const Streams& streams,
+	const std::vector<Split>& splits)
+{
+	if (splits.empty())
+		return;
+
+	const uint32_t none = UINT32_MAX;
+	std::vector<uint32_t> copyOf(vertexCount, none);
+	for (uint32_t i = 0; i < (uint32_t)splits.size(); i++)
+		copyOf[splits[i].Source] = vertexCount + i;
+
+	const StreamReader in{ streams };
+	for (size_t t = 0; t + 3 <= indices.size(); t += 3)
+	{
+		uint32_t* triangle = &indices[t];
+		if (copyOf[triangle[0]] == none && copyOf[triangle[1]] == none && copyOf[triangle[2]] == none)
+			continue;
+
+		glm::vec3 dPdu, dPdv;
+		FaceDerivatives(in, triangle, dPdu, dPdv);
+		const glm::vec3 faceFrame = glm::cross(dPdu, dPdv);
+
+		for (uint32_t k = 0; k < 3; k++)
+		{
+			uint32_t copy = copyOf[triangle[k]];
+			if (copy == none)
+				continue;
+
+			float side = glm::dot(in.Normal(triangle[k]), faceFrame);
+			float copySign = splits[copy - vertexCount].Tangent[3];
+			if ((side < 0.0f && copySign < 0.0f) || (side > 0.0f && copySign > 0.0f))
+				triangle[k] = copy;
+		}
+	}
+}
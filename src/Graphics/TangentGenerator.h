@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// TangentGenerator -- per-vertex tangent frames modelled on MikkTSpace:
+//   - each corner's tangent is the triangle's UV-space tangent projected onto
+//     the vertex normal's plane and normalized
+//   - corners are weighted by their angle, so the result does not depend on
+//     how a surface is triangulated
+//   - w is the bitangent sign (+1 or -1, dP/dv against cross(N, T)), so
+//     mirrored UVs shade correctly with B = cross(N, T) * w
+//   - a vertex shared by corners of opposite handedness (a mirror seam) is
+//     split: it keeps the side with the larger angle sum and the other
+//     side's corners are moved to a copy
+// Angles are measured in the triangle's plane rather than between edges
+// projected onto the vertex normal, so frames are close to MikkTSpace's but
+// not bit-identical; bake normal maps against these, not a MikkTSpace baker.
+//
+// Each ThreadPool thread takes a contiguous range of triangles; the first
+// sums its corners straight into the per-vertex sums, the others into a
+// private buffer covering only the vertices their range uses (small once
+// Mesh::Optimize has put vertices in first-use order). Vertex chunks then
+// add up those buffers and orthonormalize in parallel. Corner math and
+// orthonormalization run four at a time with SSE where available.
+// -----------------------------------------------------------------------------
+class TangentGenerator
+{
+public:
+	// Interleaved (or separate) attribute streams, 'Stride' bytes apart.
+	// Tangents are written as float4 (xyz, w = handedness).
+	struct Streams
+	{
+		const float* Positions = nullptr;   // float3
+		const float* Normals = nullptr;     // float3, unit length
+		const float* UVs = nullptr;         // float2
+		float*       Tangents = nullptr;    // float4
+		size_t       Stride = 0;
+	};
+
+	// A vertex copy made on a mirror seam: the caller appends a copy of
+	// vertex 'Source' with this tangent at index vertexCount + i
+	struct Split
+	{
+		uint32_t Source;
+		float    Tangent[4];
+	};
+
+	// Writes every vertex's tangent and redirects the minority corners of
+	// split vertices in 'indices' to the copies, which it returns
+	static std::vector<Split> Generate(std::vector<uint32_t>& indices, uint32_t vertexCount, const Streams& streams);
+
+	// Redirects another index list over the same vertices (e.g. a LOD) to
+	// the copies made by Generate
+	static void RemapSplits(std::vector<uint32_t>& indices, uint32_t vertexCount, const Streams& streams,
+		const std::vector<Split>& splits);
+
+private:
+	TangentGenerator() = delete;
+};
@@ -1,4 +1,5 @@
 #include "Texture.h"
+#include "Graphics/GLState.h"
 #include "Utils/Log.h"
 
 #include <glad/glad.h>
@@ -26,6 +27,21 @@ Texture::Texture(const std::string& filePath)
 		return;
 	}
 
+	Upload(data);
+	stbi_image_free(data);
+
+	Log::Info("Texture loaded (" + std::to_string(m_Channels)
+		+ " channels): " + filePath);
+}
+
+Texture::Texture(const std::string& name, const unsigned char* pixels, int width, int height, int channels)
+	: m_Width(width), m_Height(height), m_Channels(channels), m_FilePath(name)
+{
+	Upload(pixels);
+}
+
+void Texture::Upload(const unsigned char* data)
+{
 	// ------------------------------------------------------------
 	// Determine OpenGL texture format based on channel count
 	// ------------------------------------------------------------
@@ -53,7 +69,7 @@ Texture::Texture(const std::string& filePath)
 	}
 
 	glGenTextures(1, &m_RendererID);
-	glBindTexture(GL_TEXTURE_2D, m_RendererID);
+	GLState::BindTexture(0, GL_TEXTURE_2D, m_RendererID);
 
 	// Filtering & wrapping
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
@@ -61,7 +77,8 @@ Texture::Texture(const std::string& filePath)
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 
-	// Upload texture with correct format
+	// Upload texture with correct format (rows are tightly packed)
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 	glTexImage2D(
 		GL_TEXTURE_2D,
 		0,
@@ -73,6 +90,7 @@ Texture::Texture(const std::string& filePath)
 		GL_UNSIGNED_BYTE,
 		data
 	);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 
 	// ------------------------------------------------------------
 	// Swizzle mask for single-channel textures (roughness, metalness...)
@@ -85,27 +103,34 @@ Texture::Texture(const std::string& filePath)
 
 	// Prevent crashes on grayscale textures
 	glGenerateMipmap(GL_TEXTURE_2D);
+}
 
-	stbi_image_free(data);
+void Texture::Adopt(unsigned int rendererID, int width, int height, int channels)
+{
+	GLState::OnTextureDeleted(m_RendererID);
+	glDeleteTextures(1, &m_RendererID);
 
-	Log::Info("Texture loaded (" + std::to_string(m_Channels)
-		+ " channels): " + filePath);
+	m_RendererID = rendererID;
+	m_Width = width;
+	m_Height = height;
+	m_Channels = channels;
+	m_Loading = false;
 }
 
 Texture::~Texture()
 {
+	GLState::OnTextureDeleted(m_RendererID);
 	glDeleteTextures(1, &m_RendererID);
 }
 
 void Texture::Bind(unsigned int slot) const
 {
-	glActiveTexture(GL_TEXTURE0 + slot);
-	glBindTexture(GL_TEXTURE_2D, m_RendererID);
+	GLState::BindTexture(slot, GL_TEXTURE_2D, m_RendererID);
 }
 
-void Texture::Unbind() const
+void Texture::Unbind(unsigned int slot) const
 {
-	glBindTexture(GL_TEXTURE_2D, 0);
+	GLState::BindTexture(slot, GL_TEXTURE_2D, 0);
 }
 
 int Texture::GetWidth() const { return m_Width; }
@@ -5,14 +5,36 @@ class Texture
 {
 public:
 	Texture(const std::string& filePath);
+
+	// Upload already decoded 8-bit pixels (rows bottom to top as GL expects,
+	// 1, 3 or 4 channels); 'name' only identifies the texture
+	Texture(const std::string& name, const unsigned char* pixels, int width, int height, int channels);
+
 	~Texture();
 
 	void Bind(unsigned int slot = 0) const;
-	void Unbind() const;
+	void Unbind(unsigned int slot = 0) const;
 
 	int GetWidth() const;
 	int GetHeight() const;
+	int GetChannels() const { return m_Channels; }
 	const std::string& GetPath() const { return m_FilePath; }
+	unsigned int GetRendererID() const { return m_RendererID; }
+
+	// True while an async load (TextureLibrary::GetOrLoadAsync) has no
+	// pixels yet and draws as its placeholder
+	bool IsLoading() const { return m_Loading; }
+
+private:
+	friend class TextureLibrary;
+
+	// Empty shell for an async load; the library fills it in
+	Texture() = default;
+
+	void Upload(const unsigned char* pixels);
+
+	// Take over a fully uploaded GL texture, deleting the current one
+	void Adopt(unsigned int rendererID, int width, int height, int channels);
 
 private:
 	unsigned int m_RendererID = 0;   // OpenGL texture ID
@@ -20,4 +42,5 @@ private:
 	int m_Height = 0;
 	int m_Channels = 0;
 	std::string m_FilePath;
+	bool m_Loading = false;
 };
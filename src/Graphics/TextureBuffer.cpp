@@ -0,0 +1,52 @@
+#include "TextureBuffer.h"
+#include "Graphics/GLState.h"
+
+#include <glad/glad.h>
+
+namespace
+{
+	// Never leave a TBO without storage; fetches from it must stay defined
+	constexpr size_t MinCapacity = 256;
+}
+
+TextureBuffer::TextureBuffer(unsigned int internalFormat)
+{
+	glGenBuffers(1, &m_BufferID);
+	glBindBuffer(GL_TEXTURE_BUFFER, m_BufferID);
+	glBufferData(GL_TEXTURE_BUFFER, MinCapacity, nullptr, GL_STREAM_DRAW);
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+	m_Capacity = MinCapacity;
+
+	// The texture references the buffer object, not its storage, so
+	// reallocating with glBufferData keeps the attachment valid
+	glGenTextures(1, &m_TextureID);
+	GLState::BindTexture(0, GL_TEXTURE_BUFFER, m_TextureID);
+	glTexBuffer(GL_TEXTURE_BUFFER, internalFormat, m_BufferID);
+}
+
+TextureBuffer::~TextureBuffer()
+{
+	GLState::OnTextureDeleted(m_TextureID);
+	glDeleteTextures(1, &m_TextureID);
+	glDeleteBuffers(1, &m_BufferID);
+}
+
+// ------------------------------------------------------------
+// Upload -- orphan, then fill the used prefix
+// ------------------------------------------------------------
+void TextureBuffer::SetData(const void* data, size_t size)
+{
+	if (size > m_Capacity)
+		m_Capacity = size + size / 2;
+
+	glBindBuffer(GL_TEXTURE_BUFFER, m_BufferID);
+	glBufferData(GL_TEXTURE_BUFFER, m_Capacity, nullptr, GL_STREAM_DRAW);
+	if (size > 0)
+		glBufferSubData(GL_TEXTURE_BUFFER, 0, size, data);
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void TextureBuffer::Bind(unsigned int unit) const
+{
+	GLState::BindTexture(unit, GL_TEXTURE_BUFFER, m_TextureID);
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+
+// -----------------------------------------------------------------------------
+// TextureBuffer (TBO) -- a buffer object read in shaders through a
+// samplerBuffer / usamplerBuffer with texelFetch. Used for per-frame
+// arrays too large or too variable for a std140 block.
+// -----------------------------------------------------------------------------
+class TextureBuffer
+{
+public:
+	// 'internalFormat' is the texel format, e.g. GL_RGBA32F or GL_R16UI
+	explicit TextureBuffer(unsigned int internalFormat);
+	~TextureBuffer();
+
+	// Replace the contents; storage grows as needed and is orphaned each call
+	void SetData(const void* data, size_t size);
+
+	void Bind(unsigned int unit) const;
+
+private:
+	unsigned int m_BufferID = 0;
+	unsigned int m_TextureID = 0;
+	size_t       m_Capacity = 0;
+};
@@ -1,8 +1,74 @@
 #include "TextureLibrary.h"
+#include "Core/ThreadPool.h"
+#include "Graphics/GLState.h"
+#include "Utils/Log.h"
+
+#include <glad/glad.h>
+#include <stb_image.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <iostream>
 
+namespace
+{
+	// GL 3.3 guarantees at least 256 layers. An array never grows past
+	// MaxArrayBytes either, so a regrow re-copies a bounded amount and
+	// one array stays a reasonable single allocation.
+	constexpr int    MaxArrayLayers = 256;
+	constexpr int    MinArrayLayers = 4;
+	constexpr size_t MaxArrayBytes = 256u << 20;
+
+	// Async loads: rows per glTexSubImage2D call are sized to about this
+	// many bytes, and at most (workers + MaxQueuedImages) decoded images
+	// are held in memory at once (a 4K RGBA chain is ~90 MB)
+	constexpr size_t UploadSliceBytes = 1 << 20;
+	constexpr size_t MaxQueuedImages = 2;
+
+	// Full chain down to 1x1, as glGenerateMipmap and Decode build it
+	int GetLevelCount(int width, int height)
+	{
+		int levels = 1;
+		while (width > 1 || height > 1)
+		{
+			width = std::max(width / 2, 1);
+			height = std::max(height / 2, 1);
+			levels++;
+		}
+		return levels;
+	}
+
+	// Storage of one texture with its full mip chain; RGB8 counts as 4
+	// bytes per texel, as drivers commonly store it
+	size_t GetTextureBytes(int width, int height, int channels)
+	{
+		const size_t texelBytes = channels == 1 ? 1 : 4;
+		size_t bytes = 0;
+		for (int level = 0; level < GetLevelCount(width, height); level++)
+			bytes += (size_t)std::max(width >> level, 1) * std::max(height >> level, 1) * texelBytes;
+		return bytes;
+	}
+
+	void GetChannelFormat(int channels, GLenum& format, GLenum& internalFormat)
+	{
+		switch (channels)
+		{
+		case 1:  format = GL_RED;  internalFormat = GL_R8;    break;
+		case 4:  format = GL_RGBA; internalFormat = GL_RGBA8; break;
+		default: format = GL_RGB;  internalFormat = GL_RGB8;  break;
+		}
+	}
+}
+
 // Allocate static container
 std::unordered_map<std::string, Texture*> TextureLibrary::s_TextureCache;
+std::vector<TextureLibrary::TextureArray> TextureLibrary::s_Arrays;
+std::unordered_map<const Texture*, TextureArrayLayer> TextureLibrary::s_ArrayLayers;
+TextureLibrary::ArrayStats TextureLibrary::s_ArrayStats;
+std::vector<TextureLibrary::PendingDecode> TextureLibrary::s_Decodes;
+std::deque<TextureLibrary::PendingUpload> TextureLibrary::s_Uploads;
+Texture* TextureLibrary::s_PlaceholderTextures[3] = {};
+unsigned int TextureLibrary::s_CopyFramebuffer = 0;
 
 // ------------------------------------------------------------
 // GetOrLoad: return existing texture or load a new one
@@ -32,6 +98,14 @@ Texture* TextureLibrary::GetOrLoad(const std::string& path)
 	return tex;
 }
 
+Texture* TextureLibrary::Add(const std::string& key, Texture* texture)
+{
+	auto result = s_TextureCache.emplace(key, texture);
+	if (!result.second && result.first->second != texture)
+		delete texture;
+	return result.first->second;
+}
+
 // ------------------------------------------------------------
 // Clear all cached textures (called during engine shutdown)
 // ------------------------------------------------------------
@@ -42,4 +116,451 @@ void TextureLibrary::Clear()
 		delete entry.second;
 	}
 	s_TextureCache.clear();
+
+	for (TextureArray& array : s_Arrays)
+	{
+		GLState::OnTextureDeleted(array.RendererID);
+		glDeleteTextures(1, &array.RendererID);
+	}
+	s_Arrays.clear();
+	s_ArrayLayers.clear();
+	s_ArrayStats = {};
+
+	GLState::OnFramebufferDeleted(s_CopyFramebuffer);
+	glDeleteFramebuffers(1, &s_CopyFramebuffer);
+	s_CopyFramebuffer = 0;
+
+	// Decodes still running finish into futures nobody reads
+	s_Decodes.clear();
+	for (PendingUpload& upload : s_Uploads)
+	{
+		GLState::OnTextureDeleted(upload.RendererID);
+		glDeleteTextures(1, &upload.RendererID);
+	}
+	s_Uploads.clear();
+
+	for (Texture*& placeholder : s_PlaceholderTextures)
+	{
+		delete placeholder;
+		placeholder = nullptr;
+	}
+}
+
+// ------------------------------------------------------------
+// Async loading
+// ------------------------------------------------------------
+Texture* TextureLibrary::GetOrLoadAsync(const std::string& path)
+{
+	auto it = s_TextureCache.find(path);
+	if (it != s_TextureCache.end())
+		return it->second;
+
+	Texture* texture = new Texture();
+	texture->m_FilePath = path;
+	texture->m_Width = 1;
+	texture->m_Height = 1;
+	texture->m_Channels = 4;
+	texture->m_Loading = true;
+
+	s_TextureCache[path] = texture;
+	s_Decodes.push_back({ texture, {} });
+	StartDecodes();
+	return texture;
+}
+
+// Hand queued files to the workers in request order, keeping the
+// number of decoded images waiting for upload bounded
+void TextureLibrary::StartDecodes()
+{
+	ThreadPool& pool = ThreadPool::Get();
+	if (pool.GetWorkerCount() == 0)
+		return;   // Update() decodes inline
+
+	size_t inFlight = s_Uploads.size();
+	for (const PendingDecode& decode : s_Decodes)
+		inFlight += decode.Result.valid() ? 1 : 0;
+
+	const size_t limit = pool.GetWorkerCount() + MaxQueuedImages;
+	for (PendingDecode& decode : s_Decodes)
+	{
+		if (inFlight >= limit)
+			break;
+		if (decode.Result.valid())
+			continue;
+
+		std::string path = decode.Target->GetPath();
+		decode.Result = pool.Submit([path]() { return Decode(path); });
+		inFlight++;
+	}
+}
+
+void TextureLibrary::Update(float budgetMs, bool textureArrays)
+{
+	if (s_Decodes.empty() && s_Uploads.empty())
+		return;
+
+	using Clock = std::chrono::high_resolution_clock;
+	const Clock::time_point start = Clock::now();
+
+	// Finished decodes join the upload queue. Without workers, decode
+	// one file per frame here once the queue has room.
+	bool decodeInline = ThreadPool::Get().GetWorkerCount() == 0 && s_Uploads.size() < MaxQueuedImages;
+	for (size_t i = 0; i < s_Decodes.size();)
+	{
+		PendingDecode& decode = s_Decodes[i];
+		DecodedImage image;
+		if (decode.Result.valid() && decode.Result.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+		{
+			image = decode.Result.get();
+		}
+		else if (decodeInline && !decode.Result.valid())
+		{
+			image = Decode(decode.Target->GetPath());
+			decodeInline = false;
+		}
+		else
+		{
+			i++;
+			continue;
+		}
+
+		Texture* target = decode.Target;
+		s_Decodes.erase(s_Decodes.begin() + i);
+
+		if (image.Pixels.empty())
+		{
+			// Same as a failed GetOrLoad: no GL texture, material fallbacks
+			Log::Error("Failed to load texture: " + target->GetPath());
+			target->m_Loading = false;
+			continue;
+		}
+		s_Uploads.push_back({ target, std::move(image) });
+	}
+
+	// Upload slices (and array copies) until the budget is spent, at
+	// least one per frame
+	bool uploaded = false;
+	while (!s_Uploads.empty() &&
+		(!uploaded || std::chrono::duration<float, std::milli>(Clock::now() - start).count() < budgetMs))
+	{
+		uploaded = true;
+		PendingUpload& upload = s_Uploads.front();
+		if (!UploadSlice(upload))
+			continue;
+
+		Texture* target = upload.Target;
+		target->Adopt(upload.RendererID, upload.Image.Width, upload.Image.Height, upload.Image.Channels);
+		s_Uploads.pop_front();
+
+		if (textureArrays)
+			GetArrayLayer(target);
+
+		Log::Info("Texture loaded (" + std::to_string(target->GetChannels())
+			+ " channels): " + target->GetPath());
+	}
+
+	StartDecodes();
+}
+
+// Worker thread: pixels plus a box-filtered mip chain, so the render
+// thread only copies memory (no glGenerateMipmap stall)
+TextureLibrary::DecodedImage TextureLibrary::Decode(const std::string& path)
+{
+	DecodedImage image;
+
+	int width, height, channels;
+	if (!stbi_info(path.c_str(), &width, &height, &channels))
+		return image;
+
+	// Grey + alpha has no matching GL format here -- expand it to RGBA
+	const int desiredChannels = channels == 2 ? 4 : 0;
+
+	stbi_set_flip_vertically_on_load_thread(1);
+	unsigned char* pixels = stbi_load(path.c_str(), &width, &height, &channels, desiredChannels);
+	if (!pixels)
+		return image;
+	if (desiredChannels != 0)
+		channels = desiredChannels;
+
+	image.Width = width;
+	image.Height = height;
+	image.Channels = channels;
+
+	size_t size = 0;
+	for (int w = width, h = height;; w = std::max(w / 2, 1), h = std::max(h / 2, 1))
+	{
+		image.LevelOffsets.push_back(size);
+		size += (size_t)w * h * channels;
+		if (w == 1 && h == 1)
+			break;
+	}
+
+	image.Pixels.resize(size);
+	std::memcpy(image.Pixels.data(), pixels, (size_t)width * height * channels);
+	stbi_image_free(pixels);
+
+	// 2x2 average of the level above; odd edges repeat the last texel
+	int w = width, h = height;
+	for (size_t level = 1; level < image.LevelOffsets.size(); level++)
+	{
+		const unsigned char* src = image.Pixels.data() + image.LevelOffsets[level - 1];
+		unsigned char* dst = image.Pixels.data() + image.LevelOffsets[level];
+		const int levelWidth = std::max(w / 2, 1);
+		const int levelHeight = std::max(h / 2, 1);
+
+		for (int y = 0; y < levelHeight; y++)
+		{
+			const unsigned char* row0 = src + (size_t)std::min(y * 2, h - 1) * w * channels;
+			const unsigned char* row1 = src + (size_t)std::min(y * 2 + 1, h - 1) * w * channels;
+			for (int x = 0; x < levelWidth; x++)
+			{
+				const int x0 = std::min(x * 2, w - 1) * channels;
+				const int x1 = std::min(x * 2 + 1, w - 1) * channels;
+				for (int c = 0; c < channels; c++)
+				{
+					int sum = row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c];
+					*dst++ = (unsigned char)((sum + 2) / 4);
+				}
+			}
+		}
+		w = levelWidth;
+		h = levelHeight;
+	}
+	return image;
+}
+
+// Render thread: the first call creates the texture and its storage,
+// every call then copies about UploadSliceBytes of rows
+bool TextureLibrary::UploadSlice(PendingUpload& upload)
+{
+	const DecodedImage& image = upload.Image;
+	const int levels = (int)image.LevelOffsets.size();
+
+	GLenum format, internalFormat;
+	GetChannelFormat(image.Channels, format, internalFormat);
+
+	if (upload.RendererID == 0)
+	{
+		glGenTextures(1, &upload.RendererID);
+		GLState::BindTexture(0, GL_TEXTURE_2D, upload.RendererID);
+
+		// Same sampling as Texture
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+
+		if (image.Channels == 1)
+		{
+			GLint swizzleMask[] = { GL_RED, GL_RED, GL_RED, GL_ONE };
+			glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzleMask);
+		}
+
+		for (int level = 0; level < levels; level++)
+		{
+			glTexImage2D(GL_TEXTURE_2D, level, internalFormat,
+				std::max(image.Width >> level, 1), std::max(image.Height >> level, 1),
+				0, format, GL_UNSIGNED_BYTE, nullptr);
+		}
+	}
+	else
+	{
+		GLState::BindTexture(0, GL_TEXTURE_2D, upload.RendererID);
+	}
+
+	const int width = std::max(image.Width >> upload.Level, 1);
+	const int height = std::max(image.Height >> upload.Level, 1);
+	const size_t rowBytes = (size_t)width * image.Channels;
+	const int rows = std::min(height - upload.Row, (int)std::max<size_t>(UploadSliceBytes / rowBytes, 1));
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexSubImage2D(GL_TEXTURE_2D, upload.Level, 0, upload.Row, width, rows, format, GL_UNSIGNED_BYTE,
+		image.Pixels.data() + image.LevelOffsets[upload.Level] + upload.Row * rowBytes);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	upload.Row += rows;
+	if (upload.Row == height)
+	{
+		upload.Level++;
+		upload.Row = 0;
+	}
+	return upload.Level == levels;
+}
+
+const Texture* TextureLibrary::GetDrawable(const Texture* texture, TexturePlaceholder placeholder)
+{
+	return texture && texture->IsLoading() ? GetPlaceholder(placeholder) : texture;
+}
+
+Texture* TextureLibrary::GetPlaceholder(TexturePlaceholder placeholder)
+{
+	static const unsigned char Pixels[3][4] = {
+		{ 128, 128, 128, 255 },   // Gray
+		{   0,   0,   0, 255 },   // Black
+		{ 128, 128, 255, 255 },   // FlatNormal
+	};
+	static const char* Names[3] = { "placeholder:gray", "placeholder:black", "placeholder:normal" };
+
+	const int index = (int)placeholder;
+	if (!s_PlaceholderTextures[index])
+		s_PlaceholderTextures[index] = new Texture(Names[index], Pixels[index], 1, 1, 4);
+	return s_PlaceholderTextures[index];
+}
+
+// ------------------------------------------------------------
+// Texture arrays
+// ------------------------------------------------------------
+TextureArrayLayer TextureLibrary::GetArrayLayer(const Texture* texture, TexturePlaceholder placeholder)
+{
+	texture = GetDrawable(texture, placeholder);
+	if (!texture || texture->GetRendererID() == 0)
+		return {};
+
+	auto it = s_ArrayLayers.find(texture);
+	if (it != s_ArrayLayers.end())
+		return it->second;
+
+	// First array with the same shape and room left under its cap
+	TextureArray* target = nullptr;
+	for (TextureArray& array : s_Arrays)
+	{
+		if (array.Width == texture->GetWidth() && array.Height == texture->GetHeight() &&
+			array.Channels == texture->GetChannels() && (int)array.Layers.size() < array.MaxCapacity)
+		{
+			target = &array;
+			break;
+		}
+	}
+
+	if (!target)
+	{
+		s_Arrays.emplace_back();
+		target = &s_Arrays.back();
+		target->Width = texture->GetWidth();
+		target->Height = texture->GetHeight();
+		target->Channels = texture->GetChannels();
+		target->LayerBytes = GetTextureBytes(target->Width, target->Height, target->Channels);
+		target->MaxCapacity = (int)std::min<size_t>(std::max<size_t>(MaxArrayBytes / target->LayerBytes, 1),
+			MaxArrayLayers);
+		glGenTextures(1, &target->RendererID);
+		s_ArrayStats.Arrays++;
+	}
+
+	int layer = (int)target->Layers.size();
+	target->Layers.push_back(texture);
+
+	if (layer >= target->Capacity)
+	{
+		// Re-specifying storage drops the contents -- copy every layer again
+		AllocateArray(*target, std::min(std::max(target->Capacity * 2, MinArrayLayers), target->MaxCapacity));
+		for (int i = 0; i < (int)target->Layers.size(); i++)
+			CopyLayer(*target, i);
+	}
+	else
+	{
+		CopyLayer(*target, layer);
+	}
+
+	s_ArrayStats.Layers++;
+	s_ArrayStats.DuplicateBytes += target->LayerBytes;
+
+	TextureArrayLayer result{ target->RendererID, layer };
+	s_ArrayLayers[texture] = result;
+	return result;
+}
+
+void TextureLibrary::AllocateArray(TextureArray& array, int capacity)
+{
+	GLenum format, internalFormat;
+	GetChannelFormat(array.Channels, format, internalFormat);
+
+	// Every level is allocated; CopyLayer fills them from the texture
+	const int levels = GetLevelCount(array.Width, array.Height);
+	GLState::BindTexture(0, GL_TEXTURE_2D_ARRAY, array.RendererID);
+	for (int level = 0; level < levels; level++)
+	{
+		glTexImage3D(GL_TEXTURE_2D_ARRAY, level, internalFormat,
+			std::max(array.Width >> level, 1), std::max(array.Height >> level, 1), capacity,
+			0, format, GL_UNSIGNED_BYTE, nullptr);
+	}
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, levels - 1);
+
+	// Same sampling as Texture
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+	if (array.Channels == 1)
+	{
+		GLint swizzleMask[] = { GL_RED, GL_RED, GL_RED, GL_ONE };
+		glTexParameteriv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_SWIZZLE_RGBA, swizzleMask);
+	}
+
+	s_ArrayStats.Bytes += (size_t)(capacity - array.Capacity) * array.LayerBytes;
+	array.Capacity = capacity;
+
+	Log::Info("Texture array " + std::to_string(array.Width) + "x" + std::to_string(array.Height) +
+		" (" + std::to_string(array.Channels) + " channels): " + std::to_string(capacity) + " layers");
+}
+
+// Each mip level of the standalone texture is attached to a read
+// framebuffer and copied into the layer on the GPU (no CPU stall)
+void TextureLibrary::CopyLayer(const TextureArray& array, int layer)
+{
+	const unsigned int source = array.Layers[layer]->GetRendererID();
+	const int levels = GetLevelCount(array.Width, array.Height);
+
+	if (s_CopyFramebuffer == 0)
+		glGenFramebuffers(1, &s_CopyFramebuffer);
+	GLState::BindFramebuffer(s_CopyFramebuffer);
+	GLState::BindTexture(0, GL_TEXTURE_2D_ARRAY, array.RendererID);
+
+	bool copied = true;
+	for (int level = 0; level < levels && copied; level++)
+	{
+		glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, source, level);
+		copied = glCheckFramebufferStatus(GL_READ_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+		if (copied)
+		{
+			glCopyTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, layer, 0, 0,
+				std::max(array.Width >> level, 1), std::max(array.Height >> level, 1));
+		}
+	}
+
+	glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+	GLState::BindFramebuffer(0);
+
+	// Drivers need not render to RGB8; read those back instead
+	if (!copied)
+		ReadBackLayer(array, layer);
+}
+
+void TextureLibrary::ReadBackLayer(const TextureArray& array, int layer)
+{
+	GLenum format, internalFormat;
+	GetChannelFormat(array.Channels, format, internalFormat);
+
+	std::vector<unsigned char> pixels((size_t)array.Width * array.Height * std::max(array.Channels, 1));
+
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	const int levels = GetLevelCount(array.Width, array.Height);
+	for (int level = 0; level < levels; level++)
+	{
+		const int width = std::max(array.Width >> level, 1);
+		const int height = std::max(array.Height >> level, 1);
+
+		GLState::BindTexture(0, GL_TEXTURE_2D, array.Layers[layer]->GetRendererID());
+		glGetTexImage(GL_TEXTURE_2D, level, format, GL_UNSIGNED_BYTE, pixels.data());
+
+		GLState::BindTexture(0, GL_TEXTURE_2D_ARRAY, array.RendererID);
+		glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, layer, width, height, 1,
+			format, GL_UNSIGNED_BYTE, pixels.data());
+	}
+
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 }
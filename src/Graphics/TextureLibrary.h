@@ -1,8 +1,29 @@
 #pragma once
+#include <cstdint>
+#include <deque>
+#include <future>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include "Texture.h"
 
+// Where a texture lives inside the shared texture arrays
+struct TextureArrayLayer
+{
+	unsigned int ArrayID = 0;   // GL_TEXTURE_2D_ARRAY, 0 = none
+	int          Layer = -1;
+};
+
+// 1x1 stand-in drawn while an async texture loads, chosen by the material
+// slot sampling it so it is neutral there (flat normal, no metalness, no
+// parallax offset) -- the same file may fill different slots
+enum class TexturePlaceholder : uint8_t
+{
+	Gray,          // 0.5 -- albedo, roughness, displacement
+	Black,         // metalness
+	FlatNormal     // (0.5, 0.5, 1)
+};
+
 class TextureLibrary
 {
 public:
@@ -10,14 +31,129 @@ public:
 	// Ensures the same path is only loaded once
 	static Texture* GetOrLoad(const std::string& path);
 
+	// Take ownership of a texture created elsewhere (e.g. decoded from a
+	// model file) so GetOrLoad(key) returns it and Clear() frees it.
+	// If 'key' is already cached, 'texture' is deleted and the cached
+	// one returned.
+	static Texture* Add(const std::string& key, Texture* texture);
+
 	// Optional: manually clear all cached textures (shutdown)
 	static void Clear();
 
+	// ------------------------------------------------------------
+	// Async loading -- returns at once with a texture that draws as a
+	// shared 1x1 placeholder (see GetDrawable). The file is decoded and
+	// its mip chain built on the ThreadPool; Update() then uploads it on
+	// the render thread a slice at a time and swaps it in. The Texture*
+	// never changes, so materials can hold it immediately. Cached like
+	// GetOrLoad.
+	// ------------------------------------------------------------
+	static Texture* GetOrLoadAsync(const std::string& path);
+
+	// Render thread, once per frame: upload decoded images for about
+	// 'budgetMs' (at least one slice, so loads always progress). With
+	// textureArrays, a finished texture is also copied into its array
+	// layer here, inside the same budget, rather than on first draw.
+	static void Update(float budgetMs, bool textureArrays);
+
+	// What to sample for 'texture' in a slot wanting 'placeholder':
+	// the placeholder while the texture loads, else the texture
+	static const Texture* GetDrawable(const Texture* texture, TexturePlaceholder placeholder);
+
+	// Textures still decoding or uploading
+	static size_t GetPendingCount() { return s_Decodes.size() + s_Uploads.size(); }
+
+	// ------------------------------------------------------------
+	// Texture arrays -- textures with the same size and channel count
+	// are copied into one GL_TEXTURE_2D_ARRAY on first request, so
+	// materials using them can share a single binding. The copy runs on
+	// the GPU and takes every mip level from the texture, so nothing is
+	// read back or regenerated. An array grows up to a byte cap; past it
+	// the next texture of that shape starts a new array. The array name
+	// stays valid when it grows; layers never move.
+	//
+	// The source Texture keeps its own storage, so every layer is held
+	// twice in VRAM: the material binding can be switched back to
+	// per-material textures at any time (see ArrayStats).
+	// ------------------------------------------------------------
+	static TextureArrayLayer GetArrayLayer(const Texture* texture,
+		TexturePlaceholder placeholder = TexturePlaceholder::Gray);
+
+	static size_t GetArrayCount() { return s_Arrays.size(); }
+
+	struct ArrayStats
+	{
+		uint32_t Arrays = 0;
+		uint32_t Layers = 0;
+		size_t   Bytes = 0;           // storage of all arrays (all mips, every allocated layer)
+		size_t   DuplicateBytes = 0;  // of that, layers whose source Texture is also resident
+	};
+
+	static const ArrayStats& GetArrayStats() { return s_ArrayStats; }
+
 private:
 	// Prevent instantiation  this is a pure static resource system
 	TextureLibrary() = delete;
 
 private:
+	struct TextureArray
+	{
+		int Width = 0;
+		int Height = 0;
+		int Channels = 0;
+		unsigned int RendererID = 0;
+		int Capacity = 0;
+		int MaxCapacity = 0;      // layers that fit the byte cap
+		size_t LayerBytes = 0;    // all mip levels of one layer
+		std::vector<const Texture*> Layers;
+	};
+
+	static void AllocateArray(TextureArray& array, int capacity);
+	static void CopyLayer(const TextureArray& array, int layer);
+	static void ReadBackLayer(const TextureArray& array, int layer);
+
+	// Pixels of every mip level, level 0 first, rows bottom-up and
+	// tightly packed
+	struct DecodedImage
+	{
+		int Width = 0;
+		int Height = 0;
+		int Channels = 0;
+		std::vector<unsigned char> Pixels;
+		std::vector<size_t>        LevelOffsets;
+	};
+
+	struct PendingDecode
+	{
+		Texture*                  Target;
+		std::future<DecodedImage> Result;   // invalid: no workers, decode in Update()
+	};
+
+	struct PendingUpload
+	{
+		Texture*     Target;
+		DecodedImage Image;
+		unsigned int RendererID = 0;        // filled off to the side, then adopted
+		int          Level = 0;
+		int          Row = 0;
+	};
+
+	static void StartDecodes();
+	static DecodedImage Decode(const std::string& path);
+	static bool UploadSlice(PendingUpload& upload);   // true once complete
+	static Texture* GetPlaceholder(TexturePlaceholder placeholder);
+
 	// Cache: path  Texture*
 	static std::unordered_map<std::string, Texture*> s_TextureCache;
+
+	static std::vector<TextureArray>                                s_Arrays;
+	static std::unordered_map<const Texture*, TextureArrayLayer>    s_ArrayLayers;
+	static ArrayStats                                               s_ArrayStats;
+
+	static std::vector<PendingDecode> s_Decodes;
+	static std::deque<PendingUpload>  s_Uploads;
+
+	static Texture* s_PlaceholderTextures[3];
+
+	static unsigned int s_CopyFramebuffer;   // read side of CopyLayer
 };
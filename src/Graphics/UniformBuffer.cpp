@@ -0,0 +1,44 @@
+#include "UniformBuffer.h"
+
+#include <glad/glad.h>
+
+// ------------------------------------------------------------
+// Create storage and bind it to its block binding point
+// ------------------------------------------------------------
+UniformBuffer::UniformBuffer(unsigned int size, UniformBlockBinding binding)
+	: m_Size(size), m_Binding(static_cast<unsigned int>(binding))
+{
+	glGenBuffers(1, &m_RendererID);
+	glBindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
+	glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	glBindBufferBase(GL_UNIFORM_BUFFER, m_Binding, m_RendererID);
+}
+
+UniformBuffer::~UniformBuffer()
+{
+	glDeleteBuffers(1, &m_RendererID);
+}
+
+// ------------------------------------------------------------
+// Update block contents in place
+// ------------------------------------------------------------
+void UniformBuffer::SetData(const void* data, unsigned int size, unsigned int offset)
+{
+	glBindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
+	glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+// ------------------------------------------------------------
+// Block name -> binding point (shared by every program)
+// ------------------------------------------------------------
+int UniformBuffer::GetBindingPoint(const std::string& blockName)
+{
+	if (blockName == "FrameData")
+		return static_cast<int>(UniformBlockBinding::FrameData);
+	if (blockName == "LightData")
+		return static_cast<int>(UniformBlockBinding::LightData);
+	return -1;
+}
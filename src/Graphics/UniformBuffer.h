@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+
+// -----------------------------------------------------------------------------
+// UniformBuffer (UBO) -- persistent std140 block storage shared by all programs
+// -----------------------------------------------------------------------------
+
+// Fixed binding points; Shader binds its active blocks to these by name on link
+enum class UniformBlockBinding : unsigned int
+{
+	FrameData = 0,
+	LightData = 1
+};
+
+class UniformBuffer
+{
+public:
+	// Allocate 'size' bytes once and attach them to the binding point
+	UniformBuffer(unsigned int size, UniformBlockBinding binding);
+	~UniformBuffer();
+
+	// Overwrite (part of) the block -- storage is reused every frame
+	void SetData(const void* data, unsigned int size, unsigned int offset = 0);
+
+	unsigned int GetSize() const { return m_Size; }
+
+	// Binding point for a GLSL block name, -1 if the block is unknown
+	static int GetBindingPoint(const std::string& blockName);
+
+private:
+	unsigned int m_RendererID = 0;
+	unsigned int m_Size = 0;
+	unsigned int m_Binding = 0;
+};
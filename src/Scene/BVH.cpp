@@ -0,0 +1,405 @@
+#include "BVH.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+	constexpr uint32_t BinCount = 16;
+	constexpr uint32_t MaxLeafSize = 4;
+
+	// Past this depth splits fall back to the object median, which bounds the
+	// total depth (and so the fixed traversal stacks) for any input size
+	constexpr uint32_t MaxSAHDepth = 32;
+	constexpr uint32_t StackSize = 64;
+
+	// Relative costs for the surface area heuristic
+	constexpr float TraversalCost = 1.0f;
+	constexpr float IntersectCost = 1.0f;
+
+	struct Bin
+	{
+		AABB     Bounds = AABB::Empty();
+		uint32_t Count = 0;
+	};
+
+	// Slab test; returns entry distance or +inf on miss
+	float IntersectRayBox(const glm::vec3& origin, const glm::vec3& invDir,
+		const glm::vec3& boxMin, const glm::vec3& boxMax, float maxDistance)
+	{
+		glm::vec3 t0 = (boxMin - origin) * invDir;
+		glm::vec3 t1 = (boxMax - origin) * invDir;
+		glm::vec3 tNear = glm::min(t0, t1);
+		glm::vec3 tFar = glm::max(t0, t1);
+
+		float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+		float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxDistance));
+
+		return enter <= exit ? enter : std::numeric_limits<float>::infinity();
+	}
+
+	bool IntersectSphereBox(const BoundingSphere& sphere, float radiusSq,
+		const glm::vec3& boxMin, const glm::vec3& boxMax)
+	{
+		glm::vec3 d = glm::clamp(sphere.Center, boxMin, boxMax) - sphere.Center;
+		return glm::dot(d, d) <= radiusSq;
+	}
+}
+
+// ------------------------------------------------------------
+// Build
+// ------------------------------------------------------------
+void BVH::Clear()
+{
+	m_Nodes.clear();
+	m_Indices.clear();
+	m_Bounds.clear();
+	m_Cost = m_BuildCost = 0.0f;
+}
+
+void BVH::Build(const std::vector<AABB>& bounds)
+{
+	Clear();
+	if (bounds.empty())
+		return;
+
+	uint32_t count = (uint32_t)bounds.size();
+
+	std::vector<glm::vec3> centroids(count);
+	m_Indices.resize(count);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		centroids[i] = bounds[i].GetCenter();
+		m_Indices[i] = i;
+	}
+
+	m_Nodes.reserve(2 * count / MaxLeafSize + 1);
+	BuildRecursive(0, count, 0, bounds, centroids);
+
+	m_Bounds.resize(count);
+	for (uint32_t i = 0; i < count; i++)
+		m_Bounds[i] = bounds[m_Indices[i]];
+
+	m_Cost = m_BuildCost = ComputeCost();
+}
+
+uint32_t BVH::BuildRecursive(uint32_t first, uint32_t count, uint32_t depth,
+	const std::vector<AABB>& bounds, const std::vector<glm::vec3>& centroids)
+{
+	uint32_t nodeIndex = (uint32_t)m_Nodes.size();
+	m_Nodes.push_back({});
+
+	AABB nodeBounds = AABB::Empty();
+	AABB centroidBounds = AABB::Empty();
+	for (uint32_t i = first; i < first + count; i++)
+	{
+		nodeBounds.Expand(bounds[m_Indices[i]]);
+		centroidBounds.Expand(centroids[m_Indices[i]]);
+	}
+	SetNodeBounds(m_Nodes[nodeIndex], nodeBounds);
+
+	if (count <= MaxLeafSize)
+	{
+		m_Nodes[nodeIndex].LeftFirst = first;
+		m_Nodes[nodeIndex].Count = count;
+		return nodeIndex;
+	}
+
+	// Split along the widest centroid axis
+	glm::vec3 extent = centroidBounds.Max - centroidBounds.Min;
+	int axis = 0;
+	if (extent.y > extent[axis]) axis = 1;
+	if (extent.z > extent[axis]) axis = 2;
+
+	uint32_t mid = first;
+
+	if (extent[axis] > 0.0f && depth < MaxSAHDepth)
+	{
+		// Bin centroids and sweep to evaluate the SAH at every bin boundary
+		Bin bins[BinCount];
+		float scale = BinCount / extent[axis];
+		float origin = centroidBounds.Min[axis];
+
+		auto BinOf = [&](uint32_t primitive)
+		{
+			uint32_t b = (uint32_t)((centroids[primitive][axis] - origin) * scale);
+			return std::min(b, BinCount - 1);
+		};
+
+		for (uint32_t i = first; i < first + count; i++)
+		{
+			Bin& bin = bins[BinOf(m_Indices[i])];
+			bin.Count++;
+			bin.Bounds.Expand(bounds[m_Indices[i]]);
+		}
+
+		float leftArea[BinCount - 1];
+		uint32_t leftCount[BinCount - 1];
+		AABB accum = AABB::Empty();
+		uint32_t accumCount = 0;
+		for (uint32_t i = 0; i < BinCount - 1; i++)
+		{
+			accumCount += bins[i].Count;
+			if (bins[i].Count) accum.Expand(bins[i].Bounds);
+			leftCount[i] = accumCount;
+			leftArea[i] = accumCount ? accum.GetSurfaceArea() : 0.0f;
+		}
+
+		float bestCost = std::numeric_limits<float>::max();
+		uint32_t bestSplit = 1;
+		accum = AABB::Empty();
+		accumCount = 0;
+		for (uint32_t i = BinCount - 1; i > 0; i--)
+		{
+			accumCount += bins[i].Count;
+			if (bins[i].Count) accum.Expand(bins[i].Bounds);
+
+			float rightArea = accumCount ? accum.GetSurfaceArea() : 0.0f;
+			float cost = leftArea[i - 1] * leftCount[i - 1] + rightArea * accumCount;
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestSplit = i;
+			}
+		}
+
+		// Small nodes stay leaves when splitting would not pay off
+		float parentArea = std::max(nodeBounds.GetSurfaceArea(), 1e-12f);
+		float splitCost = TraversalCost + IntersectCost * bestCost / parentArea;
+		if (splitCost >= IntersectCost * count && count <= 4 * MaxLeafSize)
+		{
+			m_Nodes[nodeIndex].LeftFirst = first;
+			m_Nodes[nodeIndex].Count = count;
+			return nodeIndex;
+		}
+
+		auto split = std::partition(m_Indices.begin() + first, m_Indices.begin() + first + count,
+			[&](uint32_t primitive) { return BinOf(primitive) < bestSplit; });
+		mid = (uint32_t)(split - m_Indices.begin());
+	}
+
+	// Coincident centroids, a one-sided split or too deep: object median
+	if (mid == first || mid == first + count)
+	{
+		mid = first + count / 2;
+		std::nth_element(m_Indices.begin() + first, m_Indices.begin() + mid,
+			m_Indices.begin() + first + count,
+			[&](uint32_t a, uint32_t b) { return centroids[a][axis] < centroids[b][axis]; });
+	}
+
+	BuildRecursive(first, mid - first, depth + 1, bounds, centroids);
+	uint32_t right = BuildRecursive(mid, first + count - mid, depth + 1, bounds, centroids);
+
+	m_Nodes[nodeIndex].LeftFirst = right;
+	m_Nodes[nodeIndex].Count = 0;
+	return nodeIndex;
+}
+
+// ------------------------------------------------------------
+// Refit -- children always follow their parent in the array,
+// so one reverse pass updates every node after its children
+// ------------------------------------------------------------
+void BVH::Refit(const std::vector<AABB>& bounds)
+{
+	for (size_t i = 0; i < m_Indices.size(); i++)
+		m_Bounds[i] = bounds[m_Indices[i]];
+
+	for (size_t n = m_Nodes.size(); n-- > 0; )
+	{
+		Node& node = m_Nodes[n];
+		AABB box = AABB::Empty();
+
+		if (node.IsLeaf())
+		{
+			for (uint32_t i = node.LeftFirst; i < node.LeftFirst + node.Count; i++)
+				box.Expand(m_Bounds[i]);
+		}
+		else
+		{
+			box = GetNodeBounds(m_Nodes[n + 1]);
+			box.Expand(GetNodeBounds(m_Nodes[node.LeftFirst]));
+		}
+
+		SetNodeBounds(node, box);
+	}
+
+	m_Cost = ComputeCost();
+}
+
+float BVH::ComputeCost() const
+{
+	if (m_Nodes.empty())
+		return 0.0f;
+
+	float cost = 0.0f;
+	for (const Node& node : m_Nodes)
+	{
+		float area = GetNodeBounds(node).GetSurfaceArea();
+		cost += node.IsLeaf() ? area * IntersectCost * node.Count : area * TraversalCost;
+	}
+
+	return cost / std::max(GetNodeBounds(m_Nodes[0]).GetSurfaceArea(), 1e-12f);
+}
+
+// ------------------------------------------------------------
+// Queries -- explicit fixed-size stack, no recursion
+// ------------------------------------------------------------
+void BVH::QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& out) const
+{
+	if (m_Nodes.empty())
+		return;
+
+	// Plane mask per stack entry: once a node is fully inside a plane,
+	// its descendants skip that plane, and a zero mask accepts the subtree
+	struct Entry { uint32_t Node; uint32_t Mask; };
+	Entry stack[StackSize];
+	int top = 0;
+	stack[top++] = { 0, (1u << Frustum::Count) - 1 };
+
+	while (top > 0)
+	{
+		Entry entry = stack[--top];
+		const Node& node = m_Nodes[entry.Node];
+
+		uint32_t mask = entry.Mask;
+		if (mask && !frustum.Intersects(GetNodeBounds(node), mask))
+			continue;
+
+		if (!node.IsLeaf())
+		{
+			stack[top++] = { node.LeftFirst, mask };
+			stack[top++] = { entry.Node + 1, mask };
+			continue;
+		}
+
+		for (uint32_t i = node.LeftFirst; i < node.LeftFirst + node.Count; i++)
+		{
+			uint32_t primitiveMask = mask;
+			if (!primitiveMask || frustum.Intersects(m_Bounds[i], primitiveMask))
+				out.push_back(m_Indices[i]);
+		}
+	}
+}
+
+void BVH::QuerySphere(const BoundingSphere& sphere, std::vector<uint32_t>& out) const
+{
+	if (m_Nodes.empty())
+		return;
+
+	float radiusSq = sphere.Radius * sphere.Radius;
+
+	uint32_t stack[StackSize];
+	int top = 0;
+	stack[top++] = 0;
+
+	while (top > 0)
+	{
+		uint32_t index = stack[--top];
+		const Node& node = m_Nodes[index];
+
+		if (!IntersectSphereBox(sphere, radiusSq, node.Min, node.Max))
+			continue;
+
+		if (!node.IsLeaf())
+		{
+			stack[top++] = node.LeftFirst;
+			stack[top++] = index + 1;
+			continue;
+		}
+
+		for (uint32_t i = node.LeftFirst; i < node.LeftFirst + node.Count; i++)
+		{
+			if (IntersectSphereBox(sphere, radiusSq, m_Bounds[i].Min, m_Bounds[i].Max))
+				out.push_back(m_Indices[i]);
+		}
+	}
+}
+
+void BVH::QueryAABB(const AABB& box, std::vector<uint32_t>& out) const
+{
+	if (m_Nodes.empty())
+		return;
+
+	uint32_t stack[StackSize];
+	int top = 0;
+	stack[top++] = 0;
+
+	while (top > 0)
+	{
+		uint32_t index = stack[--top];
+		const Node& node = m_Nodes[index];
+
+		if (!GetNodeBounds(node).Intersects(box))
+			continue;
+
+		if (!node.IsLeaf())
+		{
+			stack[top++] = node.LeftFirst;
+			stack[top++] = index + 1;
+			continue;
+		}
+
+		for (uint32_t i = node.LeftFirst; i < node.LeftFirst + node.Count; i++)
+		{
+			if (m_Bounds[i].Intersects(box))
+				out.push_back(m_Indices[i]);
+		}
+	}
+}
+
+bool BVH::Raycast(const Ray& ray, float maxDistance, RayHit& hit) const
+{
+	if (m_Nodes.empty())
+		return false;
+
+	const float inf = std::numeric_limits<float>::infinity();
+	glm::vec3 invDir = 1.0f / ray.Direction;   // inf for zero components is intended
+
+	float best = maxDistance;
+	bool found = false;
+
+	if (IntersectRayBox(ray.Origin, invDir, m_Nodes[0].Min, m_Nodes[0].Max, best) == inf)
+		return false;
+
+	uint32_t stack[StackSize];
+	int top = 0;
+	stack[top++] = 0;
+
+	while (top > 0)
+	{
+		uint32_t index = stack[--top];
+		const Node& node = m_Nodes[index];
+
+		if (node.IsLeaf())
+		{
+			for (uint32_t i = node.LeftFirst; i < node.LeftFirst + node.Count; i++)
+			{
+				float t = IntersectRayBox(ray.Origin, invDir, m_Bounds[i].Min, m_Bounds[i].Max, best);
+				if (t != inf && (!found || t < best))
+				{
+					best = t;
+					hit.Index = m_Indices[i];
+					hit.Distance = t;
+					found = true;
+				}
+			}
+			continue;
+		}
+
+		// Push the nearer child last so it is visited first and 'best' shrinks early
+		uint32_t left = index + 1;
+		uint32_t right = node.LeftFirst;
+		float tLeft = IntersectRayBox(ray.Origin, invDir, m_Nodes[left].Min, m_Nodes[left].Max, best);
+		float tRight = IntersectRayBox(ray.Origin, invDir, m_Nodes[right].Min, m_Nodes[right].Max, best);
+
+		if (tLeft > tRight)
+		{
+			std::swap(left, right);
+			std::swap(tLeft, tRight);
+		}
+		if (tRight != inf) stack[top++] = right;
+		if (tLeft != inf)  stack[top++] = left;
+	}
+
+	return found;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+#include "Graphics/Bounds.h"
+
+// -----------------------------------------------------------------------------
+// Bounding volume hierarchy over world-space AABBs
+// Primitives are identified by their index in the bounds array passed to Build.
+// Nodes are stored depth-first in one flat array: an interior node's left child
+// is the next node, its right child is stored explicitly.
+// -----------------------------------------------------------------------------
+class BVH
+{
+public:
+	struct Node
+	{
+		glm::vec3 Min;
+		uint32_t  LeftFirst;   // interior: right child index, leaf: first index into m_Indices
+		glm::vec3 Max;
+		uint32_t  Count;       // 0 for interior nodes
+
+		bool IsLeaf() const { return Count != 0; }
+	};
+
+	struct RayHit
+	{
+		uint32_t Index    = 0;
+		float    Distance = 0.0f;
+	};
+
+	// Binned SAH build (O(n log n))
+	void Build(const std::vector<AABB>& bounds);
+
+	// Recompute node bounds bottom-up for moved primitives; topology is kept.
+	// 'bounds' must have the same size as at Build time.
+	void Refit(const std::vector<AABB>& bounds);
+
+	void Clear();
+
+	// Queries append primitive indices to 'out' (not cleared)
+	void QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& out) const;
+	void QuerySphere(const BoundingSphere& sphere, std::vector<uint32_t>& out) const;
+	void QueryAABB(const AABB& box, std::vector<uint32_t>& out) const;
+
+	// Nearest primitive box hit along the ray within maxDistance
+	bool Raycast(const Ray& ray, float maxDistance, RayHit& hit) const;
+
+	bool IsEmpty() const { return m_Nodes.empty(); }
+	uint32_t GetPrimitiveCount() const { return (uint32_t)m_Indices.size(); }
+	const std::vector<Node>& GetNodes() const { return m_Nodes; }
+
+	// SAH cost of the current tree, relative to the root area. Refitting
+	// after large motion degrades it; compare against GetBuildCost() to
+	// decide when to rebuild.
+	float GetCost() const { return m_Cost; }
+	float GetBuildCost() const { return m_BuildCost; }
+
+private:
+	uint32_t BuildRecursive(uint32_t first, uint32_t count, uint32_t depth,
+		const std::vector<AABB>& bounds, const std::vector<glm::vec3>& centroids);
+	float ComputeCost() const;
+
+	void SetNodeBounds(Node& node, const AABB& box) { node.Min = box.Min; node.Max = box.Max; }
+	static AABB GetNodeBounds(const Node& node) { return { node.Min, node.Max }; }
+
+private:
+	std::vector<Node>     m_Nodes;
+	std::vector<uint32_t> m_Indices;   // primitive ids, leaves reference contiguous ranges
+	std::vector<AABB>     m_Bounds;    // primitive boxes in m_Indices order, for leaf tests
+
+	float m_Cost = 0.0f;
+	float m_BuildCost = 0.0f;
+};
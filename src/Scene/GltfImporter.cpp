@@ -0,0 +1,1144 @@
+#include "GltfImporter.h"
+#include "Scene/Scene.h"
+#include "Core/ThreadPool.h"
+#include "Graphics/Material.h"
+#include "Graphics/Mesh.h"
+#include "Graphics/MeshFile.h"
+#include "Graphics/Texture.h"
+#include "Graphics/TextureLibrary.h"
+#include "Utils/Json.h"
+#include "Utils/Log.h"
+#include "Utils/MappedFile.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <stb_image.h>
+
+#include <algorithm>
+#include <future>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+	using Clock = std::chrono::high_resolution_clock;
+
+	double ElapsedMs(Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	// .glb container
+	constexpr uint32_t GlbMagic = 0x46546C67;       // "glTF"
+	constexpr uint32_t GlbChunkJson = 0x4E4F534A;   // "JSON"
+	constexpr uint32_t GlbChunkBin = 0x004E4942;    // "BIN\0"
+
+	// accessor.componentType
+	constexpr uint32_t ComponentByte = 5120;
+	constexpr uint32_t ComponentUnsignedByte = 5121;
+	constexpr uint32_t ComponentShort = 5122;
+	constexpr uint32_t ComponentUnsignedShort = 5123;
+	constexpr uint32_t ComponentUnsignedInt = 5125;
+	constexpr uint32_t ComponentFloat = 5126;
+
+	constexpr uint32_t ModeTriangles = 4;
+
+	struct ByteRange
+	{
+		const uint8_t* Data = nullptr;
+		size_t         Size = 0;
+	};
+
+	// Everything the decode jobs read; not modified after ReadDocument
+	struct Document
+	{
+		std::string Path;
+		std::string Directory;                        // "" or ends in '/'
+		MappedFile  File;
+		JsonValue   Json;
+		ByteRange   GlbBinary;
+
+		std::vector<ByteRange>            Buffers;
+		std::vector<MappedFile>           BufferFiles;   // external .bin files
+		std::vector<std::vector<uint8_t>> BufferData;    // data: URIs
+
+		MeshFile::Source Source;   // the file and its external buffers (mesh cache)
+	};
+
+	struct Accessor
+	{
+		const uint8_t* Data = nullptr;
+		uint32_t       Count = 0;
+		uint32_t       Components = 0;
+		uint32_t       ComponentType = 0;
+		size_t         Stride = 0;
+		bool           Normalized = false;
+	};
+
+	enum class ImageUsage : uint8_t
+	{
+		Color,               // RGB(A) albedo
+		Normal,              // RGB tangent-space normal
+		MetallicRoughness    // G = roughness, B = metalness, split in two
+	};
+
+	struct ImageJob
+	{
+		uint32_t   Image = 0;
+		ImageUsage Usage = ImageUsage::Color;
+
+		int            Width = 0;
+		int            Height = 0;
+		int            Channels = 0;
+		unsigned char* Pixels = nullptr;             // stb_image allocation
+		std::vector<unsigned char> Roughness;        // MetallicRoughness only
+		std::vector<unsigned char> Metalness;
+
+		Texture* Textures[2] = { nullptr, nullptr }; // [1] = metalness
+	};
+
+	struct PrimitiveJob
+	{
+		const JsonValue* Primitive = nullptr;
+		std::string      CachePath;               // MeshFile cache entry
+		bool             Cached = false;          // entry is fresh: load it, skip the decode
+		Mesh*            Result = nullptr;
+		std::future<Mesh*> Decoded;               // invalid: cached, or no workers (decoded on the GL thread)
+	};
+
+	// --------------------------------------------------------
+	// URIs
+	// --------------------------------------------------------
+	int HexValue(char c)
+	{
+		if (c >= '0' && c <= '9') return c - '0';
+		if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+		if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+		return -1;
+	}
+
+	// Relative file URIs may be percent-encoded ("my%20model.bin")
+	std::string DecodeUri(const std::string& uri)
+	{
+		std::string result;
+		result.reserve(uri.size());
+		for (size_t i = 0; i < uri.size(); i++)
+		{
+			if (uri[i] == '%' && i + 2 < uri.size() && HexValue(uri[i + 1]) >= 0 && HexValue(uri[i + 2]) >= 0)
+			{
+				result += (char)(HexValue(uri[i + 1]) * 16 + HexValue(uri[i + 2]));
+				i += 2;
+			}
+			else
+			{
+				result += uri[i];
+			}
+		}
+		return result;
+	}
+
+	bool DecodeBase64(const char* text, size_t length, std::vector<uint8_t>& out)
+	{
+		out.clear();
+		out.reserve(length / 4 * 3);
+
+		uint32_t bits = 0;
+		int bitCount = 0;
+		for (size_t i = 0; i < length; i++)
+		{
+			char c = text[i];
+			int value;
+			if (c >= 'A' && c <= 'Z')      value = c - 'A';
+			else if (c >= 'a' && c <= 'z') value = c - 'a' + 26;
+			else if (c >= '0' && c <= '9') value = c - '0' + 52;
+			else if (c == '+' || c == '-') value = 62;
+			else if (c == '/' || c == '_') value = 63;
+			else if (c == '=')             break;
+			else return false;
+
+			bits = (bits << 6) | (uint32_t)value;
+			bitCount += 6;
+			if (bitCount >= 8)
+			{
+				bitCount -= 8;
+				out.push_back((uint8_t)(bits >> bitCount));
+			}
+		}
+		return true;
+	}
+
+	// "data:[<mime>];base64,<payload>"
+	bool IsDataUri(const std::string& uri)
+	{
+		return uri.compare(0, 5, "data:") == 0;
+	}
+
+	bool DecodeDataUri(const std::string& uri, std::vector<uint8_t>& out)
+	{
+		size_t comma = uri.find(',');
+		if (comma == std::string::npos || uri.rfind(";base64", comma) == std::string::npos)
+			return false;
+		return DecodeBase64(uri.data() + comma + 1, uri.size() - comma - 1, out);
+	}
+
+	// --------------------------------------------------------
+	// Read stage: file, JSON, buffers
+	// --------------------------------------------------------
+	bool ReadDocument(const std::string& path, Document& doc)
+	{
+		doc.Path = path;
+		size_t slash = path.find_last_of("/\\");
+		doc.Directory = slash == std::string::npos ? "" : path.substr(0, slash + 1);
+		doc.Source = MeshFile::GetSource(path);
+
+		if (!doc.File.Open(path) || doc.File.GetSize() < 4)
+		{
+			Log::Error("Failed to open glTF file: " + path);
+			return false;
+		}
+
+		const uint8_t* bytes = static_cast<const uint8_t*>(doc.File.GetData());
+		const size_t size = doc.File.GetSize();
+		const char* jsonText = reinterpret_cast<const char*>(bytes);
+		size_t jsonLength = size;
+
+		uint32_t magic;
+		std::memcpy(&magic, bytes, 4);
+		if (magic == GlbMagic)
+		{
+			// 12-byte header, then chunks of { length, type, data (4-byte padded) }
+			uint32_t header[3];
+			if (size < sizeof(header))
+			{
+				Log::Error("glb file is truncated: " + path);
+				return false;
+			}
+			std::memcpy(header, bytes, sizeof(header));
+			if (header[1] != 2)
+			{
+				Log::Error("Unsupported glb version: " + path);
+				return false;
+			}
+
+			jsonText = nullptr;
+			size_t offset = sizeof(header);
+			const size_t end = std::min<size_t>(size, header[2]);
+			while (offset + 8 <= end)
+			{
+				uint32_t chunk[2];
+				std::memcpy(chunk, bytes + offset, sizeof(chunk));
+				offset += sizeof(chunk);
+				if (chunk[0] > end - offset)
+					break;
+
+				if (chunk[1] == GlbChunkJson && !jsonText)
+				{
+					jsonText = reinterpret_cast<const char*>(bytes + offset);
+					jsonLength = chunk[0];
+				}
+				else if (chunk[1] == GlbChunkBin && !doc.GlbBinary.Data)
+				{
+					doc.GlbBinary = { bytes + offset, chunk[0] };
+				}
+				offset += (chunk[0] + 3) & ~3u;
+			}
+
+			if (!jsonText)
+			{
+				Log::Error("glb file has no JSON chunk: " + path);
+				return false;
+			}
+		}
+
+		std::string error;
+		if (!JsonValue::Parse(jsonText, jsonLength, doc.Json, error))
+		{
+			Log::Error("Failed to parse glTF " + path + ": " + error);
+			return false;
+		}
+
+		const std::string& version = doc.Json["asset"]["version"].GetString();
+		if (version.empty() || version[0] != '2')
+		{
+			Log::Error("Not a glTF 2.0 file: " + path);
+			return false;
+		}
+
+		// Buffers: GLB binary chunk, data URI or external file (mapped)
+		const JsonValue& buffers = doc.Json["buffers"];
+		doc.Buffers.resize(buffers.Size());
+		doc.BufferFiles.reserve(buffers.Size());
+		doc.BufferData.reserve(buffers.Size());
+		for (size_t i = 0; i < buffers.Size(); i++)
+		{
+			const JsonValue& buffer = buffers.At(i);
+			const std::string& uri = buffer["uri"].GetString();
+			ByteRange range;
+
+			if (uri.empty())
+			{
+				range = doc.GlbBinary;
+			}
+			else if (IsDataUri(uri))
+			{
+				doc.BufferData.emplace_back();
+				if (DecodeDataUri(uri, doc.BufferData.back()))
+					range = { doc.BufferData.back().data(), doc.BufferData.back().size() };
+			}
+			else
+			{
+				const std::string bufferPath = doc.Directory + DecodeUri(uri);
+				doc.Source.Add(bufferPath);
+				doc.BufferFiles.emplace_back();
+				if (doc.BufferFiles.back().Open(bufferPath))
+				{
+					range = { static_cast<const uint8_t*>(doc.BufferFiles.back().GetData()),
+						doc.BufferFiles.back().GetSize() };
+				}
+			}
+
+			// byteLength may be smaller than the data (GLB padding), never larger
+			size_t byteLength = (size_t)buffer["byteLength"].GetNumber(0.0);
+			if (!range.Data || range.Size < byteLength)
+			{
+				Log::Error("glTF buffer " + std::to_string(i) + " is missing or truncated: " + path);
+				return false;
+			}
+			doc.Buffers[i] = { range.Data, byteLength };
+		}
+
+		return true;
+	}
+
+	// --------------------------------------------------------
+	// Accessors
+	// --------------------------------------------------------
+	bool GetBufferView(const Document& doc, uint32_t index, ByteRange& out, size_t* stride = nullptr)
+	{
+		const JsonValue& view = doc.Json["bufferViews"].At(index);
+		uint32_t buffer = view["buffer"].GetUint(UINT32_MAX);
+		if (!view.IsObject() || buffer >= doc.Buffers.size())
+			return false;
+
+		uint64_t offset = (uint64_t)view["byteOffset"].GetNumber(0.0);
+		uint64_t length = (uint64_t)view["byteLength"].GetNumber(0.0);
+		if (offset > doc.Buffers[buffer].Size || length > doc.Buffers[buffer].Size - offset)
+			return false;
+
+		out = { doc.Buffers[buffer].Data + offset, (size_t)length };
+		if (stride)
+			*stride = view["byteStride"].GetUint(0);
+		return true;
+	}
+
+	uint32_t GetComponentCount(const std::string& type)
+	{
+		if (type == "SCALAR") return 1;
+		if (type == "VEC2")   return 2;
+		if (type == "VEC3")   return 3;
+		if (type == "VEC4")   return 4;
+		if (type == "MAT4")   return 16;
+		return 0;
+	}
+
+	uint32_t GetComponentSize(uint32_t componentType)
+	{
+		switch (componentType)
+		{
+		case ComponentByte:
+		case ComponentUnsignedByte:  return 1;
+		case ComponentShort:
+		case ComponentUnsignedShort: return 2;
+		case ComponentUnsignedInt:
+		case ComponentFloat:         return 4;
+		default:                     return 0;
+		}
+	}
+
+	// Resolve and bounds-check an accessor (index is a JSON number)
+	bool GetAccessor(const Document& doc, const JsonValue& index, Accessor& out)
+	{
+		const JsonValue& accessor = doc.Json["accessors"].At(index.GetUint(UINT32_MAX));
+		if (!accessor.IsObject() || accessor.Has("sparse"))
+			return false;
+
+		out.Count = accessor["count"].GetUint(0);
+		out.Components = GetComponentCount(accessor["type"].GetString());
+		out.ComponentType = accessor["componentType"].GetUint(0);
+		out.Normalized = accessor["normalized"].GetBool(false);
+
+		const uint32_t elementSize = out.Components * GetComponentSize(out.ComponentType);
+		ByteRange view;
+		size_t stride = 0;
+		if (out.Count == 0 || elementSize == 0 ||
+			!GetBufferView(doc, accessor["bufferView"].GetUint(UINT32_MAX), view, &stride))
+			return false;
+
+		out.Stride = stride != 0 ? stride : elementSize;
+		uint64_t offset = (uint64_t)accessor["byteOffset"].GetNumber(0.0);
+		uint64_t span = (uint64_t)out.Stride * (out.Count - 1) + elementSize;
+		if (offset > view.Size || span > view.Size - offset)
+			return false;
+
+		out.Data = view.Data + offset;
+		return true;
+	}
+
+	float ReadComponent(const uint8_t* p, uint32_t componentType, bool normalized)
+	{
+		switch (componentType)
+		{
+		case ComponentFloat:
+		{
+			float value;
+			std::memcpy(&value, p, sizeof(value));
+			return value;
+		}
+		case ComponentUnsignedByte:
+			return normalized ? *p / 255.0f : (float)*p;
+		case ComponentByte:
+		{
+			int8_t value = (int8_t)*p;
+			return normalized ? std::max(value / 127.0f, -1.0f) : (float)value;
+		}
+		case ComponentUnsignedShort:
+		{
+			uint16_t value;
+			std::memcpy(&value, p, sizeof(value));
+			return normalized ? value / 65535.0f : (float)value;
+		}
+		case ComponentShort:
+		{
+			int16_t value;
+			std::memcpy(&value, p, sizeof(value));
+			return normalized ? std::max(value / 32767.0f, -1.0f) : (float)value;
+		}
+		case ComponentUnsignedInt:
+		{
+			uint32_t value;
+			std::memcpy(&value, p, sizeof(value));
+			return (float)value;
+		}
+		default:
+			return 0.0f;
+		}
+	}
+
+	// First 'count' components of element i
+	void ReadFloats(const Accessor& accessor, uint32_t i, float* out, uint32_t count)
+	{
+		const uint8_t* element = accessor.Data + (size_t)i * accessor.Stride;
+		if (accessor.ComponentType == ComponentFloat)
+		{
+			std::memcpy(out, element, count * sizeof(float));
+			return;
+		}
+
+		const uint32_t size = GetComponentSize(accessor.ComponentType);
+		for (uint32_t c = 0; c < count; c++)
+			out[c] = ReadComponent(element + c * size, accessor.ComponentType, accessor.Normalized);
+	}
+
+	// UNSIGNED_BYTE, UNSIGNED_SHORT or UNSIGNED_INT (checked by the caller)
+	uint32_t ReadIndex(const Accessor& accessor, uint32_t i)
+	{
+		const uint8_t* element = accessor.Data + (size_t)i * accessor.Stride;
+		switch (accessor.ComponentType)
+		{
+		case ComponentUnsignedByte:
+			return *element;
+		case ComponentUnsignedShort:
+		{
+			uint16_t value;
+			std::memcpy(&value, element, sizeof(value));
+			return value;
+		}
+		case ComponentUnsignedInt:
+		{
+			uint32_t value;
+			std::memcpy(&value, element, sizeof(value));
+			return value;
+		}
+		default:
+			return UINT32_MAX;
+		}
+	}
+
+	// --------------------------------------------------------
+	// Decode stage (worker threads)
+	// --------------------------------------------------------
+	Mesh* DecodePrimitive(const Document& doc, const JsonValue& primitive, VertexFormat format)
+	{
+		const JsonValue& attributes = primitive["attributes"];
+
+		Accessor positions, normals, uvs;
+		if (!GetAccessor(doc, attributes["POSITION"], positions) || positions.Components != 3)
+			return nullptr;
+
+		const uint32_t vertexCount = positions.Count;
+		bool hasNormals = GetAccessor(doc, attributes["NORMAL"], normals) &&
+			normals.Components == 3 && normals.Count == vertexCount;
+		bool hasUVs = GetAccessor(doc, attributes["TEXCOORD_0"], uvs) &&
+			uvs.Components == 2 && uvs.Count == vertexCount;
+
+		// glTF UVs start at the top of the image; images are decoded
+		// bottom-up like every other texture, so V is flipped to match
+		std::vector<Mesh::Vertex> vertices(vertexCount);
+		for (uint32_t i = 0; i < vertexCount; i++)
+		{
+			Mesh::Vertex& v = vertices[i];
+			ReadFloats(positions, i, &v.Position.x, 3);
+			if (hasNormals)
+				ReadFloats(normals, i, &v.Normal.x, 3);
+			else
+				v.Normal = glm::vec3(0.0f);
+			if (hasUVs)
+			{
+				ReadFloats(uvs, i, &v.UV.x, 2);
+				v.UV.y = 1.0f - v.UV.y;
+			}
+			else
+			{
+				v.UV = glm::vec2(0.0f);
+			}
+			v.Tangent = glm::vec4(0.0f);
+		}
+
+		std::vector<uint32_t> indices;
+		if (primitive.Has("indices"))
+		{
+			Accessor indexAccessor;
+			// The only index types glTF allows (ReadIndex reads nothing else)
+			if (!GetAccessor(doc, primitive["indices"], indexAccessor) || indexAccessor.Components != 1 ||
+				(indexAccessor.ComponentType != ComponentUnsignedByte &&
+				 indexAccessor.ComponentType != ComponentUnsignedShort &&
+				 indexAccessor.ComponentType != ComponentUnsignedInt))
+				return nullptr;
+
+			indices.resize(indexAccessor.Count);
+			for (uint32_t i = 0; i < indexAccessor.Count; i++)
+			{
+				indices[i] = ReadIndex(indexAccessor, i);
+				if (indices[i] >= vertexCount)
+					return nullptr;
+			}
+		}
+		else
+		{
+			indices.resize(vertexCount);
+			for (uint32_t i = 0; i < vertexCount; i++)
+				indices[i] = i;
+		}
+
+		indices.resize(indices.size() / 3 * 3);
+		if (indices.empty())
+			return nullptr;
+
+		// Smooth normals from face normals (cross product length = 2x area)
+		if (!hasNormals)
+		{
+			for (size_t i = 0; i < indices.size(); i += 3)
+			{
+				const glm::vec3& p0 = vertices[indices[i]].Position;
+				glm::vec3 n = glm::cross(vertices[indices[i + 1]].Position - p0, vertices[indices[i + 2]].Position - p0);
+				vertices[indices[i]].Normal += n;
+				vertices[indices[i + 1]].Normal += n;
+				vertices[indices[i + 2]].Normal += n;
+			}
+
+			for (Mesh::Vertex& v : vertices)
+			{
+				float length = glm::length(v.Normal);
+				v.Normal = length > 0.0f ? v.Normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+			}
+		}
+
+		// CPU processing only; the GL thread uploads
+		return new Mesh(vertices, indices, format, false);
+	}
+
+	PrimitiveJob MakePrimitiveJob(const Document& doc, size_t mesh, size_t primitive, VertexFormat format)
+	{
+		PrimitiveJob job;
+		job.Primitive = &doc.Json["meshes"].At(mesh)["primitives"].At(primitive);
+		job.CachePath = MeshFile::GetCachePath(doc.Path + "#mesh" + std::to_string(mesh) +
+			"/primitive" + std::to_string(primitive), format);
+		job.Cached = MeshFile::IsCacheFresh(job.CachePath, doc.Source);
+		return job;
+	}
+
+	// Decode one primitive and write its cache entry (any thread)
+	Mesh* DecodeAndCache(const Document& doc, const JsonValue& primitive, const std::string& cachePath,
+		VertexFormat format, bool writeCache)
+	{
+		Mesh* mesh = DecodePrimitive(doc, primitive, format);
+		if (mesh && writeCache)
+			MeshFile::Write(cachePath, *mesh, doc.Source);
+		return mesh;
+	}
+
+	// Decode every primitive without a fresh cache entry and write one
+	// for it (Convert; Import uploads each one as it finishes instead)
+	void DecodePrimitives(const Document& doc, std::vector<PrimitiveJob>& jobs, VertexFormat format)
+	{
+		bool writeCache = MeshFile::CreateCacheDirectory();
+		ThreadPool::Get().ParallelFor((uint32_t)jobs.size(), 1, [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t i = begin; i < end; i++)
+			{
+				PrimitiveJob& job = jobs[i];
+				if (!job.Cached)
+					job.Result = DecodeAndCache(doc, *job.Primitive, job.CachePath, format, writeCache);
+			}
+		});
+	}
+
+	bool DecodeImage(const Document& doc, ImageJob& job)
+	{
+		const JsonValue& image = doc.Json["images"].At(job.Image);
+		const std::string& uri = image["uri"].GetString();
+
+		MappedFile file;
+		std::vector<uint8_t> storage;
+		ByteRange source;
+
+		if (image.Has("bufferView"))
+		{
+			if (!GetBufferView(doc, image["bufferView"].GetUint(UINT32_MAX), source))
+				return false;
+		}
+		else if (IsDataUri(uri))
+		{
+			if (!DecodeDataUri(uri, storage))
+				return false;
+			source = { storage.data(), storage.size() };
+		}
+		else if (!uri.empty())
+		{
+			if (!file.Open(doc.Directory + DecodeUri(uri)))
+				return false;
+			source = { static_cast<const uint8_t*>(file.GetData()), file.GetSize() };
+		}
+
+		if (!source.Data || source.Size > (size_t)INT32_MAX)
+			return false;
+
+		int width, height, channels;
+		if (!stbi_info_from_memory(source.Data, (int)source.Size, &width, &height, &channels))
+			return false;
+
+		// Bottom-up like Texture(path); the flag is per thread
+		stbi_set_flip_vertically_on_load_thread(1);
+
+		int wanted = 3;
+		if (job.Usage == ImageUsage::Color && (channels == 2 || channels == 4))
+			wanted = 4;
+
+		unsigned char* pixels = stbi_load_from_memory(source.Data, (int)source.Size,
+			&width, &height, &channels, wanted);
+		if (!pixels)
+			return false;
+
+		job.Width = width;
+		job.Height = height;
+		job.Channels = wanted;
+
+		if (job.Usage != ImageUsage::MetallicRoughness)
+		{
+			job.Pixels = pixels;
+			return true;
+		}
+
+		// The Material samples roughness and metalness maps' red channel
+		const size_t pixelCount = (size_t)width * height;
+		job.Roughness.resize(pixelCount);
+		job.Metalness.resize(pixelCount);
+		for (size_t i = 0; i < pixelCount; i++)
+		{
+			job.Roughness[i] = pixels[i * 3 + 1];
+			job.Metalness[i] = pixels[i * 3 + 2];
+		}
+		job.Channels = 1;
+		stbi_image_free(pixels);
+		return true;
+	}
+
+	// --------------------------------------------------------
+	// Scene stage
+	// --------------------------------------------------------
+	glm::mat4 GetLocalMatrix(const JsonValue& node)
+	{
+		const JsonValue& matrix = node["matrix"];
+		if (matrix.Size() == 16)
+		{
+			// Column-major like glm
+			glm::mat4 result;
+			for (int i = 0; i < 16; i++)
+				result[i / 4][i % 4] = matrix.At(i).GetFloat();
+			return result;
+		}
+
+		const JsonValue& t = node["translation"];
+		const JsonValue& r = node["rotation"];
+		const JsonValue& s = node["scale"];
+
+		glm::vec3 translation(t.At(0).GetFloat(), t.At(1).GetFloat(), t.At(2).GetFloat());
+		glm::quat rotation(r.At(3).GetFloat(1.0f), r.At(0).GetFloat(), r.At(1).GetFloat(), r.At(2).GetFloat());
+		glm::vec3 scale(s.At(0).GetFloat(1.0f), s.At(1).GetFloat(1.0f), s.At(2).GetFloat(1.0f));
+
+		return glm::translate(glm::mat4(1.0f), translation) * glm::mat4_cast(rotation) *
+			glm::scale(glm::mat4(1.0f), scale);
+	}
+
+	std::string GetTextureKey(const std::string& path, uint32_t image, const char* suffix)
+	{
+		return path + "#image" + std::to_string(image) + suffix;
+	}
+}
+
+// ------------------------------------------------------------
+// Read -> Decode (ThreadPool) -> Upload (GL thread) -> Scene
+// ------------------------------------------------------------
+bool GltfImporter::Import(const std::string& path, Scene& scene, VertexFormat format, Stats* stats)
+{
+	Stats result;
+	const auto importStart = Clock::now();
+
+	// ---- Read ---------------------------------------------
+	auto stageStart = Clock::now();
+	Document doc;
+	if (!ReadDocument(path, doc))
+		return false;
+
+	for (const ByteRange& buffer : doc.Buffers)
+		result.BufferBytes += buffer.Size;
+	result.ReadMs = ElapsedMs(stageStart);
+
+	const JsonValue& json = doc.Json;
+	const JsonValue& textures = json["textures"];
+	const JsonValue& images = json["images"];
+	const JsonValue& materials = json["materials"];
+	const JsonValue& meshes = json["meshes"];
+
+	// ---- Plan ---------------------------------------------
+	// Walk the node hierarchy first: only the meshes it reaches (and
+	// the materials and images they use) are decoded and uploaded.
+	// Roots: the default scene, else the first, else every parentless node
+	const JsonValue& nodes = json["nodes"];
+	const JsonValue& scenes = json["scenes"];
+	std::vector<uint32_t> roots;
+	const JsonValue& rootList = scenes.At(json["scene"].GetUint(0))["nodes"];
+	if (rootList.IsArray())
+	{
+		for (const JsonValue& root : rootList.GetElements())
+			roots.push_back(root.GetUint(UINT32_MAX));
+	}
+	else
+	{
+		std::vector<bool> isChild(nodes.Size(), false);
+		for (const JsonValue& node : nodes.GetElements())
+		{
+			for (const JsonValue& child : node["children"].GetElements())
+			{
+				uint32_t index = child.GetUint(UINT32_MAX);
+				if (index < isChild.size())
+					isChild[index] = true;
+			}
+		}
+		for (uint32_t i = 0; i < (uint32_t)nodes.Size(); i++)
+		{
+			if (!isChild[i])
+				roots.push_back(i);
+		}
+	}
+
+	// Depth-first with world matrices; a node is visited at most once,
+	// which also guards against cyclic (invalid) hierarchies
+	struct MeshInstance
+	{
+		uint32_t  Mesh;
+		glm::mat4 World;
+	};
+
+	std::vector<MeshInstance> instances;
+	std::vector<bool> meshUsed(meshes.Size(), false);
+	std::vector<bool> visited(nodes.Size(), false);
+	std::vector<std::pair<uint32_t, glm::mat4>> stack;
+	for (auto it = roots.rbegin(); it != roots.rend(); ++it)
+		stack.emplace_back(*it, glm::mat4(1.0f));
+
+	while (!stack.empty())
+	{
+		uint32_t index = stack.back().first;
+		glm::mat4 parent = stack.back().second;
+		stack.pop_back();
+
+		if (index >= nodes.Size() || visited[index])
+			continue;
+		visited[index] = true;
+
+		const JsonValue& node = nodes.At(index);
+		glm::mat4 world = parent * GetLocalMatrix(node);
+
+		uint32_t mesh = node["mesh"].GetUint(UINT32_MAX);
+		if (mesh < meshes.Size())
+		{
+			instances.push_back({ mesh, world });
+			meshUsed[mesh] = true;
+		}
+
+		const std::vector<JsonValue>& children = node["children"].GetElements();
+		for (auto it = children.rbegin(); it != children.rend(); ++it)
+			stack.emplace_back(it->GetUint(UINT32_MAX), world);
+	}
+
+	// One job per primitive of a reached mesh
+	std::vector<PrimitiveJob> primitiveJobs;
+	std::vector<uint32_t> meshFirstJob(meshes.Size() + 1, 0);
+	std::vector<bool> materialUsed(materials.Size(), false);
+	uint32_t skippedPrimitives = 0;
+	for (size_t m = 0; m < meshes.Size(); m++)
+	{
+		meshFirstJob[m] = (uint32_t)primitiveJobs.size();
+		if (!meshUsed[m])
+			continue;
+
+		const JsonValue& primitives = meshes.At(m)["primitives"];
+		for (size_t p = 0; p < primitives.Size(); p++)
+		{
+			// Points and lines have no place in the PBR pass; strips and
+			// fans are rare enough in exported files to skip
+			if (primitives.At(p)["mode"].GetUint(ModeTriangles) != ModeTriangles)
+			{
+				skippedPrimitives++;
+				continue;
+			}
+
+			primitiveJobs.push_back(MakePrimitiveJob(doc, m, p, format));
+
+			uint32_t material = primitives.At(p)["material"].GetUint(UINT32_MAX);
+			if (material < materials.Size())
+				materialUsed[material] = true;
+		}
+	}
+	meshFirstJob[meshes.Size()] = (uint32_t)primitiveJobs.size();
+
+	// One job per (image, usage) of a used material
+	std::vector<ImageJob> imageJobs;
+	std::unordered_map<uint64_t, uint32_t> imageJobIndex;
+
+	auto requestImage = [&](const JsonValue& textureInfo, ImageUsage usage) -> int
+	{
+		if (!textureInfo.IsObject())
+			return -1;
+
+		uint32_t image = textures.At(textureInfo["index"].GetUint(UINT32_MAX))["source"].GetUint(UINT32_MAX);
+		if (image >= images.Size())
+			return -1;
+
+		uint64_t key = ((uint64_t)image << 8) | (uint64_t)usage;
+		auto it = imageJobIndex.find(key);
+		if (it != imageJobIndex.end())
+			return (int)it->second;
+
+		ImageJob job;
+		job.Image = image;
+		job.Usage = usage;
+		imageJobs.push_back(std::move(job));
+		imageJobIndex[key] = (uint32_t)imageJobs.size() - 1;
+		return (int)imageJobs.size() - 1;
+	};
+
+	struct MaterialPlan
+	{
+		int Albedo = -1;
+		int Normal = -1;
+		int MetallicRoughness = -1;
+	};
+
+	std::vector<MaterialPlan> materialPlans(materials.Size());
+	for (size_t i = 0; i < materials.Size(); i++)
+	{
+		if (!materialUsed[i])
+			continue;
+
+		const JsonValue& material = materials.At(i);
+		const JsonValue& pbr = material["pbrMetallicRoughness"];
+		materialPlans[i].Albedo = requestImage(pbr["baseColorTexture"], ImageUsage::Color);
+		materialPlans[i].MetallicRoughness = requestImage(pbr["metallicRoughnessTexture"], ImageUsage::MetallicRoughness);
+		materialPlans[i].Normal = requestImage(material["normalTexture"], ImageUsage::Normal);
+	}
+
+	// ---- Decode + upload: primitives ----------------------
+	// Decodes run on the workers while the GL thread maps cached entries,
+	// then uploads each decoded mesh as soon as it is ready. DecodeMs is
+	// the GL thread's time decoding or waiting, UploadMs its mapping and
+	// upload time. Without workers everything runs here in order.
+	const bool hasWorkers = ThreadPool::Get().GetWorkerCount() > 0;
+	const bool writeCache = MeshFile::CreateCacheDirectory();
+	for (PrimitiveJob& job : primitiveJobs)
+	{
+		if (job.Cached || !hasWorkers)
+			continue;
+
+		const JsonValue* primitive = job.Primitive;
+		const std::string cachePath = job.CachePath;
+		job.Decoded = ThreadPool::Get().Submit([&doc, primitive, cachePath, format, writeCache]()
+		{
+			return DecodeAndCache(doc, *primitive, cachePath, format, writeCache);
+		});
+	}
+
+	auto uploadPrimitive = [&](PrimitiveJob& job)
+	{
+		if (!job.Result)
+		{
+			skippedPrimitives++;
+			return;
+		}
+		job.Result->UploadToGPU();
+		result.Meshes++;
+		result.Triangles += job.Result->GetLOD(0).IndexCount / 3;
+	};
+
+	std::vector<PrimitiveJob*> pendingPrimitives;
+	for (PrimitiveJob& job : primitiveJobs)
+	{
+		stageStart = Clock::now();
+		if (job.Decoded.valid())
+		{
+			pendingPrimitives.push_back(&job);
+			continue;
+		}
+
+		if (job.Cached)
+		{
+			job.Result = MeshFile::Load(job.CachePath);
+			if (job.Result)
+			{
+				result.CachedMeshes++;
+				uploadPrimitive(job);
+				result.UploadMs += ElapsedMs(stageStart);
+				continue;
+			}
+			Log::Warn("Mesh cache entry rejected, decoding the primitive: " + job.CachePath);
+		}
+
+		job.Result = DecodeAndCache(doc, *job.Primitive, job.CachePath, format, writeCache);
+		result.DecodeMs += ElapsedMs(stageStart);
+
+		stageStart = Clock::now();
+		uploadPrimitive(job);
+		result.UploadMs += ElapsedMs(stageStart);
+	}
+
+	// Completion order; block on the oldest decode only when none is ready
+	while (!pendingPrimitives.empty())
+	{
+		stageStart = Clock::now();
+		auto ready = std::find_if(pendingPrimitives.begin(), pendingPrimitives.end(), [](PrimitiveJob* job)
+		{
+			return job->Decoded.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+		});
+		if (ready == pendingPrimitives.end())
+			ready = pendingPrimitives.begin();
+
+		PrimitiveJob& job = **ready;
+		pendingPrimitives.erase(ready);
+		job.Result = job.Decoded.get();
+		result.DecodeMs += ElapsedMs(stageStart);
+
+		stageStart = Clock::now();
+		uploadPrimitive(job);
+		result.UploadMs += ElapsedMs(stageStart);
+	}
+
+	// ---- Decode + upload: images --------------------------
+	// Images go in windows of one per thread: the next window decodes on
+	// the workers while the GL thread uploads and frees the current one,
+	// so at most two windows of decoded pixels are held however many
+	// images the file has
+	const uint32_t imageCount = (uint32_t)imageJobs.size();
+	const uint32_t imageWindow = ThreadPool::Get().GetWorkerCount() + 1;
+	uint32_t failedImages = 0;
+
+	std::vector<std::future<bool>> imageDecodes(imageCount);   // invalid: decode on the GL thread
+	auto submitImages = [&](uint32_t first)
+	{
+		for (uint32_t i = first; hasWorkers && i < std::min(first + imageWindow, imageCount); i++)
+		{
+			ImageJob* job = &imageJobs[i];
+			imageDecodes[i] = ThreadPool::Get().Submit([&doc, job]() { return DecodeImage(doc, *job); });
+		}
+	};
+	submitImages(0);
+
+	for (uint32_t first = 0; first < imageCount; first += imageWindow)
+	{
+		const uint32_t count = std::min(imageWindow, imageCount - first);
+
+		stageStart = Clock::now();
+		for (uint32_t i = first; i < first + count; i++)
+		{
+			bool decoded = imageDecodes[i].valid() ? imageDecodes[i].get() : DecodeImage(doc, imageJobs[i]);
+			if (!decoded)
+				failedImages++;
+		}
+		result.DecodeMs += ElapsedMs(stageStart);
+
+		submitImages(first + imageWindow);
+
+		stageStart = Clock::now();
+		for (uint32_t i = first; i < first + count; i++)
+		{
+			ImageJob& job = imageJobs[i];
+			if (job.Pixels)
+			{
+				const char* suffix = job.Usage == ImageUsage::Normal ? "/normal" : "";
+				std::string key = GetTextureKey(path, job.Image, suffix);
+				job.Textures[0] = TextureLibrary::Add(key,
+					new Texture(key, job.Pixels, job.Width, job.Height, job.Channels));
+				stbi_image_free(job.Pixels);
+				job.Pixels = nullptr;
+				result.Textures++;
+			}
+			else if (!job.Roughness.empty())
+			{
+				std::string roughnessKey = GetTextureKey(path, job.Image, "/roughness");
+				std::string metalnessKey = GetTextureKey(path, job.Image, "/metalness");
+				job.Textures[0] = TextureLibrary::Add(roughnessKey,
+					new Texture(roughnessKey, job.Roughness.data(), job.Width, job.Height, 1));
+				job.Textures[1] = TextureLibrary::Add(metalnessKey,
+					new Texture(metalnessKey, job.Metalness.data(), job.Width, job.Height, 1));
+				std::vector<unsigned char>().swap(job.Roughness);
+				std::vector<unsigned char>().swap(job.Metalness);
+				result.Textures += 2;
+			}
+		}
+		result.UploadMs += ElapsedMs(stageStart);
+	}
+
+	// ---- Scene --------------------------------------------
+	stageStart = Clock::now();
+
+	std::vector<Material*> sceneMaterials(materials.Size(), nullptr);
+	for (size_t i = 0; i < materials.Size(); i++)
+	{
+		if (!materialUsed[i])
+			continue;
+
+		const JsonValue& pbr = materials.At(i)["pbrMetallicRoughness"];
+		const JsonValue& baseColor = pbr["baseColorFactor"];
+		const MaterialPlan& plan = materialPlans[i];
+
+		Material* material = new Material();
+		material->SetDiffuseColor({ baseColor.At(0).GetFloat(1.0f), baseColor.At(1).GetFloat(1.0f),
+			baseColor.At(2).GetFloat(1.0f) });
+		material->SetRoughness(pbr["roughnessFactor"].GetFloat(1.0f));
+		material->SetMetalness(pbr["metallicFactor"].GetFloat(1.0f));
+
+		if (plan.Albedo >= 0)
+			material->SetDiffuseTexture(imageJobs[plan.Albedo].Textures[0]);
+		if (plan.Normal >= 0)
+			material->SetNormalMap(imageJobs[plan.Normal].Textures[0]);
+		if (plan.MetallicRoughness >= 0)
+		{
+			material->SetRoughnessMap(imageJobs[plan.MetallicRoughness].Textures[0]);
+			material->SetMetalnessMap(imageJobs[plan.MetallicRoughness].Textures[1]);
+		}
+
+		sceneMaterials[i] = material;
+		result.Materials++;
+	}
+	Material defaultMaterial;
+
+	for (const MeshInstance& instance : instances)
+	{
+		for (uint32_t j = meshFirstJob[instance.Mesh]; j < meshFirstJob[instance.Mesh + 1]; j++)
+		{
+			const PrimitiveJob& job = primitiveJobs[j];
+			if (!job.Result)
+				continue;
+
+			uint32_t materialIndex = (*job.Primitive)["material"].GetUint(UINT32_MAX);
+			Material* material = materialIndex < sceneMaterials.size() ? sceneMaterials[materialIndex] : &defaultMaterial;
+
+			Entity& entity = scene.CreateEntity(job.Result, material);
+			entity.GetTransform().SetMatrix(instance.World);
+			result.Entities++;
+		}
+	}
+
+	// Entities hold clones (see Scene::CreateEntity)
+	for (Material* material : sceneMaterials)
+		delete material;
+
+	result.SceneMs = ElapsedMs(stageStart);
+	result.TotalMs = ElapsedMs(importStart);
+
+	if (skippedPrimitives > 0 || failedImages > 0)
+	{
+		char message[160];
+		std::snprintf(message, sizeof(message), "glTF: skipped %u primitives (invalid or not triangles), %u images failed to decode",
+			skippedPrimitives, failedImages);
+		Log::Warn(message);
+	}
+
+	char message[320];
+	std::snprintf(message, sizeof(message),
+		"glTF imported: %u meshes (%u cached), %zu triangles, %u materials, %u textures, %u entities, %.1f MB | "
+		"read %.1f ms, decode %.1f ms (%u threads), upload %.1f ms, scene %.1f ms, total %.1f ms",
+		result.Meshes, result.CachedMeshes, result.Triangles, result.Materials, result.Textures, result.Entities,
+		result.BufferBytes / (1024.0 * 1024.0), result.ReadMs, result.DecodeMs,
+		ThreadPool::Get().GetWorkerCount() + 1, result.UploadMs, result.SceneMs, result.TotalMs);
+	Log::Info(message + std::string(": ") + path);
+
+	if (stats)
+		*stats = result;
+	return result.Entities > 0;
+}
+
+// ------------------------------------------------------------
+// Read -> Decode, writing each primitive's cache entry
+// ------------------------------------------------------------
+bool GltfImporter::Convert(const std::string& path, VertexFormat format)
+{
+	Document doc;
+	if (!ReadDocument(path, doc))
+		return false;
+
+	const JsonValue& meshes = doc.Json["meshes"];
+	std::vector<PrimitiveJob> jobs;
+	for (size_t m = 0; m < meshes.Size(); m++)
+	{
+		const JsonValue& primitives = meshes.At(m)["primitives"];
+		for (size_t p = 0; p < primitives.Size(); p++)
+		{
+			if (primitives.At(p)["mode"].GetUint(ModeTriangles) == ModeTriangles)
+				jobs.push_back(MakePrimitiveJob(doc, m, p, format));
+		}
+	}
+
+	DecodePrimitives(doc, jobs, format);
+
+	uint32_t written = 0, cached = 0, failed = 0;
+	for (PrimitiveJob& job : jobs)
+	{
+		if (job.Cached)
+			cached++;
+		else if (job.Result)
+			written++;
+		else
+			failed++;
+		delete job.Result;
+	}
+
+	char message[160];
+	std::snprintf(message, sizeof(message), "glTF converted: %u meshes written, %u up to date, %u failed",
+		written, cached, failed);
+	Log::Info(message + std::string(": ") + path);
+	return failed == 0;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "Graphics/GeometryArena.h"
+
+class Scene;
+
+// -----------------------------------------------------------------------------
+// GltfImporter -- glTF 2.0 (.gltf + .bin / data URIs, or binary .glb) into
+// Mesh, Material and Entity objects of a Scene.
+//
+// Stages:
+//   Read    map the file and external buffers (MappedFile), parse the JSON
+//   Plan    walk the node hierarchy; only the meshes it reaches, and the
+//           materials and images those use, are imported
+//   Decode  on the ThreadPool: every primitive's accessors into a Mesh (CPU
+//           side: optimization, LODs, tangents) and every image into pixels
+//   Upload  GL thread: meshes into the geometry arena, each as soon as its
+//           decode finishes, then images into textures. Images go in
+//           windows of one per thread, the next window decoding while the
+//           current one uploads, so only two windows of decoded pixels are
+//           ever held in memory
+//   Scene   create one entity per primitive of every reached node
+//
+// Each primitive becomes its own Mesh and is shared by every node that uses
+// it. Decoded primitives are written to the MeshFile cache; on later imports
+// fresh entries are mapped and uploaded instead of decoded. The Scene has no
+// parent links, so node hierarchies are flattened: each entity's Transform
+// holds the node's world matrix as is (Transform::SetMatrix), including any
+// shear from non-uniformly scaled parents.
+// Metallic-roughness maps are split into the Material's separate roughness
+// (G) and metalness (B) maps; occlusion, emissive, skins, animations, cameras
+// and sparse accessors are not imported.
+// -----------------------------------------------------------------------------
+class GltfImporter
+{
+public:
+	struct Stats
+	{
+		double ReadMs = 0.0;
+		double DecodeMs = 0.0;
+		double UploadMs = 0.0;
+		double SceneMs = 0.0;
+		double TotalMs = 0.0;
+
+		uint32_t Meshes = 0;        // one per triangle primitive
+		uint32_t CachedMeshes = 0;  // of those, mapped from the mesh cache
+		uint32_t Materials = 0;
+		uint32_t Textures = 0;
+		uint32_t Entities = 0;
+		size_t   BufferBytes = 0;   // binary data referenced by the file
+		size_t   Triangles = 0;
+	};
+
+	// Add the file's default scene (or all root nodes) to 'scene'; false if
+	// the file cannot be read or contains nothing to draw. Needs the GL
+	// context on the calling thread.
+	static bool Import(const std::string& path, Scene& scene,
+		VertexFormat format = VertexFormat::Float, Stats* stats = nullptr);
+
+	// Write the mesh cache entries of every triangle primitive in the file
+	// (stale or missing ones only); no GL context needed
+	static bool Convert(const std::string& path, VertexFormat format = VertexFormat::Float);
+
+private:
+	GltfImporter() = delete;
+};
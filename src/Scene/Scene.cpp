@@ -27,6 +27,53 @@ const std::vector<Entity>& Scene::GetEntities() const
 	return m_Entities;
 }
 
+//---------------------------------------------------------
+// Spatial index
+//---------------------------------------------------------
+void Scene::UpdateBounds()
+{
+	// Rebuild once the SAH cost has drifted this far above the built tree
+	const float rebuildThreshold = 1.5f;
+
+	bool rebuild = m_EntityBounds.size() != m_Entities.size();
+	bool moved = false;
+
+	m_EntityBounds.resize(m_Entities.size());
+	m_BoundsVersions.resize(m_Entities.size(), ~0u);
+
+	for (size_t i = 0; i < m_Entities.size(); i++)
+	{
+		const Transform& transform = m_Entities[i].GetTransform();
+		if (!rebuild && m_BoundsVersions[i] == transform.GetVersion())
+			continue;
+
+		m_EntityBounds[i] = m_Entities[i].GetMesh()->GetBounds().Transformed(transform.GetMatrix());
+		m_BoundsVersions[i] = transform.GetVersion();
+		moved = true;
+	}
+
+	if (rebuild)
+	{
+		m_BVH.Build(m_EntityBounds);
+	}
+	else if (moved)
+	{
+		m_BVH.Refit(m_EntityBounds);
+		if (m_BVH.GetCost() > m_BVH.GetBuildCost() * rebuildThreshold)
+			m_BVH.Build(m_EntityBounds);
+	}
+}
+
+const BVH& Scene::GetBVH() const
+{
+	return m_BVH;
+}
+
+const std::vector<AABB>& Scene::GetEntityBounds() const
+{
+	return m_EntityBounds;
+}
+
 //---------------------------------------------------------
 // Light management
 //---------------------------------------------------------
@@ -2,6 +2,7 @@
 #include <vector>
 
 #include "Entity.h"
+#include "BVH.h"
 #include "Graphics/Camera.h"
 #include "Graphics/Light.h"
 
@@ -20,6 +21,13 @@ public:
 	std::vector<Light>& GetLights();
 	const std::vector<Light>& GetLights() const;
 
+	// Spatial index over entity world bounds (BVH primitive i == entity i).
+	// Call once per frame after transforms change: refits moved entities,
+	// rebuilds when entities were added or refitting degraded the tree.
+	void UpdateBounds();
+	const BVH& GetBVH() const;
+	const std::vector<AABB>& GetEntityBounds() const;
+
 	// Camera
 	Camera& GetCamera();
 	const Camera& GetCamera() const;
@@ -28,4 +36,8 @@ private:
 	Camera              m_Camera;
 	std::vector<Light>  m_Lights;
 	std::vector<Entity> m_Entities;
+
+	BVH                   m_BVH;
+	std::vector<AABB>     m_EntityBounds;
+	std::vector<uint32_t> m_BoundsVersions;   // transform version the bounds were computed at
 };
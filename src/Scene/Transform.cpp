@@ -1,6 +1,7 @@
 #include "Transform.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/constants.hpp>
+#include <cmath>
 
 Transform::Transform()
 	: m_Position(0.0f),
@@ -15,16 +16,64 @@ Transform::Transform()
 void Transform::SetPosition(const glm::vec3& pos)
 {
 	m_Position = pos;
+	m_HasMatrix = false;
+	m_Version++;
 }
 
 void Transform::SetRotation(const glm::vec3& rotEulerDeg)
 {
 	m_Rotation = rotEulerDeg;
+	m_HasMatrix = false;
+	m_Version++;
 }
 
 void Transform::SetScale(const glm::vec3& scale)
 {
 	m_Scale = scale;
+	m_HasMatrix = false;
+	m_Version++;
+}
+
+//---------------------------------------------------------
+// Keep the matrix; decompose it with the inverse of the
+// TRS path in GetMatrix(): R = Rx(pitch) * Ry(yaw) * Rz(roll)
+//---------------------------------------------------------
+void Transform::SetMatrix(const glm::mat4& matrix)
+{
+	glm::vec3 scale(glm::length(glm::vec3(matrix[0])),
+		glm::length(glm::vec3(matrix[1])),
+		glm::length(glm::vec3(matrix[2])));
+
+	// A mirroring matrix keeps its flip in the scale
+	if (glm::determinant(glm::mat3(matrix)) < 0.0f)
+		scale.x = -scale.x;
+
+	glm::mat3 r(glm::vec3(matrix[0]) / (scale.x != 0.0f ? scale.x : 1.0f),
+		glm::vec3(matrix[1]) / (scale.y != 0.0f ? scale.y : 1.0f),
+		glm::vec3(matrix[2]) / (scale.z != 0.0f ? scale.z : 1.0f));
+
+	// r[column][row]: r[2][0] = sin(yaw), r[0][0] / r[1][0] = cos(yaw) * (cos, -sin)(roll)
+	float cosYaw = glm::sqrt(r[0][0] * r[0][0] + r[1][0] * r[1][0]);
+	glm::vec3 angles;
+	angles.y = std::atan2(r[2][0], cosYaw);
+	if (cosYaw > 1e-6f)
+	{
+		angles.x = std::atan2(-r[2][1], r[2][2]);
+		angles.z = std::atan2(-r[1][0], r[0][0]);
+	}
+	else
+	{
+		// Gimbal lock: only pitch + roll is defined, put it all in pitch
+		angles.x = std::atan2(r[1][2], r[1][1]);
+		angles.z = 0.0f;
+	}
+
+	m_Position = glm::vec3(matrix[3]);
+	m_Rotation = glm::degrees(angles);
+	m_Scale = scale;
+	m_Matrix = matrix;
+	m_HasMatrix = true;
+	m_Version++;
 }
 
 //---------------------------------------------------------
@@ -50,6 +99,9 @@ const glm::vec3& Transform::GetScale() const
 //---------------------------------------------------------
 glm::mat4 Transform::GetMatrix() const
 {
+	if (m_HasMatrix)
+		return m_Matrix;
+
 	glm::mat4 model(1.0f);
 
 	// translation
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <glm/glm.hpp>
 
 class Transform
@@ -11,14 +12,27 @@ public:
 	void SetRotation(const glm::vec3& rotEulerDeg);
 	void SetScale(const glm::vec3& scale);
 
+	// Use 'matrix' as is (e.g. a flattened scene-graph world matrix, which
+	// may contain shear): GetMatrix() returns it unchanged. Position,
+	// rotation and scale are its decomposition, for display; setting any
+	// of them rebuilds the matrix from the three and drops the shear.
+	void SetMatrix(const glm::mat4& matrix);
+	bool HasExplicitMatrix() const { return m_HasMatrix; }
+
 	const glm::vec3& GetPosition() const;
 	const glm::vec3& GetRotation() const;
 	const glm::vec3& GetScale()     const;
 
+	// Bumped by every setter so caches can detect changes cheaply
+	uint32_t GetVersion() const { return m_Version; }
+
 	glm::mat4 GetMatrix() const;    //  world transform matrix
 
 private:
 	glm::vec3 m_Position;
 	glm::vec3 m_Rotation;   // Euler angles in degrees
 	glm::vec3 m_Scale;
+	glm::mat4 m_Matrix = glm::mat4(1.0f);   // returned by GetMatrix() while m_HasMatrix
+	bool      m_HasMatrix = false;
+	uint32_t  m_Version = 0;
 };
@@ -103,6 +103,10 @@ void InspectorPanel::DrawLightProperties(std::vector<Light>& lights)
 					glm::vec3 pos = light.GetPosition();
 					if (ImGui::DragFloat3("Position", &pos.x, 0.1f))
 						light.SetPosition(pos);
+
+					float radius = light.GetRadius();
+					if (ImGui::DragFloat("Radius", &radius, 0.1f, 0.1f, 100.0f))
+						light.SetRadius(radius);
 				}
 
 				ImGui::TreePop();
@@ -143,6 +147,9 @@ void InspectorPanel::DrawEntityProperties(std::vector<Entity>& entities)
 				if (ImGui::DragFloat3("Scale", &scl.x, 0.1f))
 					e.GetTransform().SetScale(scl);
 
+				if (e.GetTransform().HasExplicitMatrix())
+					ImGui::TextDisabled("Imported matrix (editing drops any shear)");
+
 				//------------------------------------------------------
 				// Material
 				//------------------------------------------------------
@@ -229,7 +236,9 @@ void InspectorPanel::DrawEntityProperties(std::vector<Entity>& entities)
 								{
 									std::string fullPath =
 										"./assets/textures/" + fileList[idx];
-									setter(TextureLibrary::GetOrLoad(fullPath));
+									// Decoded in the background; the slot shows
+									// a neutral placeholder until it is uploaded
+									setter(TextureLibrary::GetOrLoadAsync(fullPath));
 								}
 							}
 						};
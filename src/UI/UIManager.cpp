@@ -6,6 +6,9 @@
 #include "Core/Window.h"
 #include "Graphics/Renderer.h"
 #include "Graphics/Framebuffer.h"
+#include "Graphics/GLState.h"
+#include "Graphics/GeometryArena.h"
+#include "Graphics/TextureLibrary.h"
 #include "Utils/Log.h"
 
 // ------------------------------------------------------------
@@ -85,7 +88,7 @@ void UIManager::DrawViewport(Renderer& renderer)
 	int newW = (int)viewportSize.x;
 	int newH = (int)viewportSize.y;
 
-	// Resize framebuffer only if size changed
+	// Cheap when the size stays inside the framebuffer's allocated bucket
 	if (newW > 0 && newH > 0 &&
 		(newW != m_ViewportWidth || newH != m_ViewportHeight))
 	{
@@ -99,13 +102,17 @@ void UIManager::DrawViewport(Renderer& renderer)
 	// Display the framebuffer texture
 	if (renderer.GetFramebuffer())
 	{
-		ImTextureID texID = (ImTextureID)(intptr_t)
-			renderer.GetFramebuffer()->GetColorAttachmentID();
+		Framebuffer* framebuffer = renderer.GetFramebuffer();
+		ImTextureID texID = (ImTextureID)(intptr_t)framebuffer->GetColorAttachmentID();
+
+		// Only the lower-left GetWidth() x GetHeight() texels hold the image
+		float u = framebuffer->GetUVScaleX();
+		float v = framebuffer->GetUVScaleY();
 
 		ImGui::Image(
 			texID,
 			viewportSize,
-			ImVec2(0, 1), ImVec2(1, 0) // ֱת
+			ImVec2(0, v), ImVec2(u, 0) // ֱת
 		);
 	}
 	else
@@ -114,6 +121,104 @@ void UIManager::DrawViewport(Renderer& renderer)
 	}
 }
 
+// ------------------------------------------------------------
+// Renderer options + statistics of the last frame
+// ------------------------------------------------------------
+void UIManager::DrawRendererStats(Renderer& renderer)
+{
+	const RenderStats& stats = renderer.GetStats();
+
+	bool depthPrepass = renderer.IsDepthPrepassEnabled();
+	if (ImGui::Checkbox("Depth pre-pass", &depthPrepass))
+		renderer.SetDepthPrepass(depthPrepass);
+
+	const char* lightModes[] = { "Clustered", "Per object" };
+	int lightMode = (int)renderer.GetLightAssignment();
+	if (ImGui::Combo("Point lights", &lightMode, lightModes, IM_ARRAYSIZE(lightModes)))
+		renderer.SetLightAssignment((LightAssignment)lightMode);
+
+	const char* renderPaths[] = { "Forward", "Deferred" };
+	int renderPath = (int)renderer.GetRenderPath();
+	if (ImGui::Combo("Render path", &renderPath, renderPaths, IM_ARRAYSIZE(renderPaths)))
+		renderer.SetRenderPath((RenderPath)renderPath);
+
+	const char* materialModes[] = { "Per material", "Texture arrays" };
+	int materialMode = (int)renderer.GetMaterialBinding();
+	if (ImGui::Combo("Materials", &materialMode, materialModes, IM_ARRAYSIZE(materialModes)))
+		renderer.SetMaterialBinding((MaterialBinding)materialMode);
+
+	bool multiDraw = renderer.IsMultiDrawEnabled();
+	if (ImGui::Checkbox("Multi-draw indirect", &multiDraw))
+		renderer.SetMultiDraw(multiDraw);
+	if (multiDraw && !renderer.IsMultiDrawActive())
+	{
+		ImGui::SameLine();
+		ImGui::TextDisabled("(unsupported, per-batch fallback)");
+	}
+
+	DynamicResolution::Settings& resolution = renderer.GetDynamicResolution().GetSettings();
+	ImGui::Checkbox("Dynamic resolution", &resolution.Enabled);
+	if (resolution.Enabled)
+	{
+		ImGui::SliderFloat("Target GPU ms", &resolution.TargetMs, 4.0f, 50.0f, "%.1f");
+		ImGui::DragFloatRange2("Scale range", &resolution.MinScale, &resolution.MaxScale,
+			0.01f, 0.25f, 1.0f, "%.2f");
+	}
+
+	Renderer::LODSettings& lods = renderer.GetLODSettings();
+	ImGui::Checkbox("Mesh LODs", &lods.Enabled);
+	if (lods.Enabled)
+		ImGui::SliderFloat("LOD error (px)", &lods.ErrorPixels, 0.25f, 8.0f, "%.2f");
+
+	ImGui::Separator();
+
+	ImGui::Text("GPU frame:         %.2f ms (avg %.2f)",
+		stats.GpuFrameMs, renderer.GetDynamicResolution().GetSmoothedMs());
+	ImGui::Text("Render size:       %dx%d (scale %.2f)", stats.RenderWidth, stats.RenderHeight, stats.RenderScale);
+	ImGui::Text("Draw calls:        %u (%u commands)", stats.DrawCalls, stats.DrawCommands);
+	if (stats.DepthPrepass)
+		ImGui::Text("Pre-pass draws:    %u", stats.PrepassDrawCalls);
+	ImGui::Text("Instances:         %u", stats.Instances);
+	ImGui::Text("Triangles:         %u (LOD %u / %u / %u / %u)", stats.Triangles,
+		stats.LODInstances[0], stats.LODInstances[1], stats.LODInstances[2], stats.LODInstances[3]);
+	ImGui::Text("Culled entities:   %u", stats.Culled);
+	ImGui::Text("Program binds:     %u", stats.ProgramBinds);
+	ImGui::Text("Texture set binds: %u", stats.TextureSetBinds);
+	ImGui::Text("VAO binds:         %u", stats.MeshBinds);
+	if (renderer.GetMaterialBinding() == MaterialBinding::TextureArrays)
+	{
+		const TextureLibrary::ArrayStats& arrays = TextureLibrary::GetArrayStats();
+		ImGui::Text("Materials:         %u (%u texture arrays)", stats.Materials, stats.TextureArrays);
+		ImGui::Text("Array memory:      %u layers, %.1f MB (%.1f MB duplicated)", arrays.Layers,
+			arrays.Bytes / (1024.0 * 1024.0), arrays.DuplicateBytes / (1024.0 * 1024.0));
+	}
+	if (TextureLibrary::GetPendingCount() > 0)
+		ImGui::Text("Textures loading:  %zu", TextureLibrary::GetPendingCount());
+	ImGui::Text("GL state calls:    %u issued, %u skipped",
+		stats.StateCallsIssued, stats.StateCallsSkipped);
+	ImGui::Text("Point lights:      %u (%u cluster refs)", stats.PointLights, stats.ClusterLightRefs);
+	ImGui::Text("Light binning:     %.3f ms", stats.LightBinningMs);
+	if (renderer.GetLightAssignment() == LightAssignment::PerObject)
+		ImGui::Text("Object light refs: %u", stats.ObjectLightRefs);
+	if (stats.Deferred)
+		ImGui::Text("Light volumes:     %u", stats.LightVolumes);
+
+	ImGui::Text("Frame graph:       %u passes (%u culled), %u transients -> %u textures",
+		stats.Graph.Passes, stats.Graph.CulledPasses, stats.Graph.TransientTextures, stats.Graph.PhysicalTextures);
+	ImGui::Text("Transient memory:  %.1f MB (%.1f MB unaliased)",
+		stats.Graph.PeakTransientBytes / (1024.0 * 1024.0), stats.Graph.TransientBytes / (1024.0 * 1024.0));
+
+	const GeometryArena::Stats& geometry = GeometryArena::GetStats();
+	ImGui::Text("Geometry arena:    %u blocks, %u meshes, %.2f / %.1f MB",
+		geometry.Blocks, geometry.Allocations,
+		geometry.UsedBytes / (1024.0 * 1024.0), geometry.Bytes / (1024.0 * 1024.0));
+
+	const RenderTargetPool::Stats& targets = renderer.GetRenderTargetPool().GetStats();
+	ImGui::Text("Render targets:    %u (%u free), %.1f MB",
+		targets.LiveTargets, targets.FreeTargets, targets.Bytes / (1024.0 * 1024.0));
+	ImGui::Text("Target allocs:     %u created, %u reused", targets.Created, targets.Reused);
+}
+
 // ------------------------------------------------------------
 // Render UI Panels (Inspector + Viewport)
 // ʹͨ Dock Ĵڣ DockBuilder
@@ -153,6 +258,10 @@ void UIManager::Render(Scene& scene, Renderer& renderer)
 	DrawViewport(renderer);
 	ImGui::End();
 
+	ImGui::Begin("Renderer Stats");
+	DrawRendererStats(renderer);
+	ImGui::End();
+
 	//  ImGui 
 	ImGui::Render();
 }
@@ -163,4 +272,7 @@ void UIManager::Render(Scene& scene, Renderer& renderer)
 void UIManager::EndFrame()
 {
 	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+	// ImGui binds its own program / textures / VAO behind GLState's back
+	GLState::Invalidate();
 }
@@ -29,6 +29,9 @@ private:
 	// Draws the real-time render viewport using the framebuffer's color texture
 	void DrawViewport(Renderer& renderer);
 
+	// Per-frame renderer counters (draw calls, state changes)
+	void DrawRendererStats(Renderer& renderer);
+
 private:
 	InspectorPanel m_InspectorPanel;
 	Window* m_Window = nullptr;
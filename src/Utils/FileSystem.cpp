@@ -6,6 +6,7 @@
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <cctype>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -34,6 +35,84 @@ std::string FileSystem::ReadFile(const std::string& filePath)
 	return buffer.str();
 }
 
+// ------------------------------------------------------------
+// Read entire file as raw bytes
+// ------------------------------------------------------------
+bool FileSystem::ReadBinaryFile(const std::string& filePath, std::vector<char>& outData)
+{
+	std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+	if (!file.is_open())
+		return false;
+
+	std::streamsize size = file.tellg();
+	file.seekg(0, std::ios::beg);
+
+	outData.resize((size_t)size);
+	return size == 0 || file.read(outData.data(), size).good();
+}
+
+// ------------------------------------------------------------
+// Write raw bytes (truncates existing file)
+// ------------------------------------------------------------
+bool FileSystem::WriteBinaryFile(const std::string& filePath, const void* data, size_t size)
+{
+	std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		Log::Error("Failed to write file: " + filePath);
+		return false;
+	}
+
+	file.write((const char*)data, (std::streamsize)size);
+	return file.good();
+}
+
+// ------------------------------------------------------------
+// Last write time and size (cache staleness checks)
+// ------------------------------------------------------------
+int64_t FileSystem::GetModificationTime(const std::string& filePath)
+{
+#ifdef _WIN32
+	WIN32_FILE_ATTRIBUTE_DATA data;
+	if (!GetFileAttributesExA(filePath.c_str(), GetFileExInfoStandard, &data))
+		return 0;
+
+	// 100 ns intervals since 1601 -> nanoseconds since 1970 (fits int64)
+	ULARGE_INTEGER time;
+	time.LowPart = data.ftLastWriteTime.dwLowDateTime;
+	time.HighPart = data.ftLastWriteTime.dwHighDateTime;
+	return ((int64_t)time.QuadPart - 116444736000000000ll) * 100;
+#else
+	struct stat s;
+	if (stat(filePath.c_str(), &s) != 0)
+		return 0;
+#ifdef __APPLE__
+	return (int64_t)s.st_mtimespec.tv_sec * 1000000000 + s.st_mtimespec.tv_nsec;
+#else
+	return (int64_t)s.st_mtim.tv_sec * 1000000000 + s.st_mtim.tv_nsec;
+#endif
+#endif
+}
+
+uint64_t FileSystem::GetFileSize(const std::string& filePath)
+{
+#ifdef _WIN32
+	WIN32_FILE_ATTRIBUTE_DATA data;
+	if (!GetFileAttributesExA(filePath.c_str(), GetFileExInfoStandard, &data))
+		return 0;
+
+	ULARGE_INTEGER size;
+	size.LowPart = data.nFileSizeLow;
+	size.HighPart = data.nFileSizeHigh;
+	return size.QuadPart;
+#else
+	struct stat s;
+	if (stat(filePath.c_str(), &s) != 0)
+		return 0;
+	return (uint64_t)s.st_size;
+#endif
+}
+
 // ------------------------------------------------------------
 // Normalize directory path (ensure trailing slash)
 // ------------------------------------------------------------
@@ -68,6 +147,49 @@ static bool DirectoryExists(const std::string& path)
 #endif
 }
 
+// ------------------------------------------------------------
+// Create directory chain, one path component at a time
+// ------------------------------------------------------------
+std::string FileSystem::GetExtension(const std::string& filePath)
+{
+	size_t dot = filePath.find_last_of('.');
+	size_t slash = filePath.find_last_of("/\\");
+	if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+		return "";
+
+	std::string extension = filePath.substr(dot + 1);
+	std::transform(extension.begin(), extension.end(), extension.begin(),
+		[](unsigned char c) { return (char)std::tolower(c); });
+	return extension;
+}
+
+bool FileSystem::CreateDirectories(const std::string& directory)
+{
+	std::string path = NormalizeDirectory(directory);
+
+	for (size_t i = 1; i < path.size(); i++)
+	{
+		if (path[i] != '/' && path[i] != '\\')
+			continue;
+
+		std::string partial = path.substr(0, i);
+		if (DirectoryExists(partial))
+			continue;
+
+#ifdef _WIN32
+		if (!CreateDirectoryA(partial.c_str(), nullptr))
+#else
+		if (mkdir(partial.c_str(), 0755) != 0)
+#endif
+		{
+			Log::Error("FileSystem::CreateDirectories - cannot create: " + partial);
+			return false;
+		}
+	}
+
+	return true;
+}
+
 // ------------------------------------------------------------
 // Robust, cross-platform, correct working directory handling
 // ------------------------------------------------------------
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -8,6 +9,23 @@ public:
 	// Read entire file content as string
 	static std::string ReadFile(const std::string& filePath);
 
+	// Read / write raw bytes (false if the file cannot be opened)
+	static bool ReadBinaryFile(const std::string& filePath, std::vector<char>& outData);
+	static bool WriteBinaryFile(const std::string& filePath, const void* data, size_t size);
+
+	// Last write time in nanoseconds (comparable between files, at the
+	// file system's resolution); 0 if missing
+	static int64_t GetModificationTime(const std::string& filePath);
+
+	// Size in bytes; 0 if missing
+	static uint64_t GetFileSize(const std::string& filePath);
+
+	// Lower-case extension without the dot ("scene.GLB" -> "glb"); "" if none
+	static std::string GetExtension(const std::string& filePath);
+
+	// Create a directory and any missing parents (e.g., "cache/shaders")
+	static bool CreateDirectories(const std::string& directory);
+
 	// List all file names under a directory (e.g., /assets/textures/)
 	// Should return only actual file names (e.g., "brick.jpg", "metal.jpg")
 	static std::vector<std::string> ListFiles(const std::string& directory);
@@ -0,0 +1,373 @@
+#include "Json.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// ------------------------------------------------------------
+// Recursive descent over [Pos, End); strings and numbers are
+// bounded by End so the input may point into a mapped file
+// ------------------------------------------------------------
+class JsonParser
+{
+public:
+	JsonParser(const char* text, size_t length)
+		: m_Begin(text), m_Pos(text), m_End(text + length) {}
+
+	bool ParseDocument(JsonValue& out, std::string& error)
+	{
+		SkipWhitespace();
+		bool ok = ParseValue(out, 0);
+		if (ok)
+		{
+			SkipWhitespace();
+			if (m_Pos != m_End)
+				ok = Fail("unexpected data after the document");
+		}
+
+		if (!ok)
+		{
+			char message[160];
+			std::snprintf(message, sizeof(message), "JSON error at byte %zu: %s",
+				(size_t)(m_ErrorPos - m_Begin), m_Error);
+			error = message;
+		}
+		return ok;
+	}
+
+private:
+	static constexpr uint32_t MaxDepth = 256;
+
+	bool Fail(const char* message)
+	{
+		m_Error = message;
+		m_ErrorPos = m_Pos;
+		return false;
+	}
+
+	void SkipWhitespace()
+	{
+		while (m_Pos < m_End && (*m_Pos == ' ' || *m_Pos == '\t' || *m_Pos == '\n' || *m_Pos == '\r'))
+			m_Pos++;
+	}
+
+	bool Match(const char* literal)
+	{
+		size_t length = std::strlen(literal);
+		if ((size_t)(m_End - m_Pos) < length || std::memcmp(m_Pos, literal, length) != 0)
+			return false;
+		m_Pos += length;
+		return true;
+	}
+
+	bool ParseValue(JsonValue& out, uint32_t depth)
+	{
+		if (depth > MaxDepth)
+			return Fail("nesting too deep");
+		if (m_Pos >= m_End)
+			return Fail("unexpected end of input");
+
+		switch (*m_Pos)
+		{
+		case '{': return ParseObject(out, depth);
+		case '[': return ParseArray(out, depth);
+		case '"':
+			out.m_Type = JsonValue::Type::String;
+			return ParseString(out.m_String);
+		case 't':
+		case 'f':
+			out.m_Type = JsonValue::Type::Bool;
+			out.m_Bool = *m_Pos == 't';
+			return Match(out.m_Bool ? "true" : "false") || Fail("invalid literal");
+		case 'n':
+			return Match("null") || Fail("invalid literal");
+		default:
+			return ParseNumber(out);
+		}
+	}
+
+	bool ParseObject(JsonValue& out, uint32_t depth)
+	{
+		out.m_Type = JsonValue::Type::Object;
+		m_Pos++;
+		SkipWhitespace();
+		if (m_Pos < m_End && *m_Pos == '}')
+		{
+			m_Pos++;
+			return true;
+		}
+
+		for (;;)
+		{
+			SkipWhitespace();
+			if (m_Pos >= m_End || *m_Pos != '"')
+				return Fail("expected a member name");
+
+			out.m_Members.emplace_back();
+			JsonValue::Member& member = out.m_Members.back();
+			if (!ParseString(member.first))
+				return false;
+
+			SkipWhitespace();
+			if (m_Pos >= m_End || *m_Pos != ':')
+				return Fail("expected ':'");
+			m_Pos++;
+			SkipWhitespace();
+
+			if (!ParseValue(member.second, depth + 1))
+				return false;
+
+			SkipWhitespace();
+			if (m_Pos < m_End && *m_Pos == ',')
+			{
+				m_Pos++;
+				continue;
+			}
+			if (m_Pos < m_End && *m_Pos == '}')
+			{
+				m_Pos++;
+				return true;
+			}
+			return Fail("expected ',' or '}'");
+		}
+	}
+
+	bool ParseArray(JsonValue& out, uint32_t depth)
+	{
+		out.m_Type = JsonValue::Type::Array;
+		m_Pos++;
+		SkipWhitespace();
+		if (m_Pos < m_End && *m_Pos == ']')
+		{
+			m_Pos++;
+			return true;
+		}
+
+		for (;;)
+		{
+			SkipWhitespace();
+			out.m_Elements.emplace_back();
+			if (!ParseValue(out.m_Elements.back(), depth + 1))
+				return false;
+
+			SkipWhitespace();
+			if (m_Pos < m_End && *m_Pos == ',')
+			{
+				m_Pos++;
+				continue;
+			}
+			if (m_Pos < m_End && *m_Pos == ']')
+			{
+				m_Pos++;
+				return true;
+			}
+			return Fail("expected ',' or ']'");
+		}
+	}
+
+	bool ParseHex4(uint32_t& value)
+	{
+		if (m_End - m_Pos < 4)
+			return Fail("truncated \\u escape");
+
+		value = 0;
+		for (int i = 0; i < 4; i++)
+		{
+			char c = *m_Pos++;
+			value <<= 4;
+			if (c >= '0' && c <= '9')      value |= (uint32_t)(c - '0');
+			else if (c >= 'a' && c <= 'f') value |= (uint32_t)(c - 'a' + 10);
+			else if (c >= 'A' && c <= 'F') value |= (uint32_t)(c - 'A' + 10);
+			else return Fail("invalid \\u escape");
+		}
+		return true;
+	}
+
+	static void AppendUtf8(std::string& out, uint32_t codepoint)
+	{
+		if (codepoint < 0x80)
+		{
+			out += (char)codepoint;
+		}
+		else if (codepoint < 0x800)
+		{
+			out += (char)(0xC0 | (codepoint >> 6));
+			out += (char)(0x80 | (codepoint & 0x3F));
+		}
+		else if (codepoint < 0x10000)
+		{
+			out += (char)(0xE0 | (codepoint >> 12));
+			out += (char)(0x80 | ((codepoint >> 6) & 0x3F));
+			out += (char)(0x80 | (codepoint & 0x3F));
+		}
+		else
+		{
+			out += (char)(0xF0 | (codepoint >> 18));
+			out += (char)(0x80 | ((codepoint >> 12) & 0x3F));
+			out += (char)(0x80 | ((codepoint >> 6) & 0x3F));
+			out += (char)(0x80 | (codepoint & 0x3F));
+		}
+	}
+
+	bool ParseString(std::string& out)
+	{
+		m_Pos++;   // opening quote
+
+		for (;;)
+		{
+			// Copy the run up to the next quote or escape in one go
+			const char* run = m_Pos;
+			while (m_Pos < m_End && *m_Pos != '"' && *m_Pos != '\\' && (unsigned char)*m_Pos >= 0x20)
+				m_Pos++;
+			out.append(run, m_Pos);
+
+			if (m_Pos >= m_End)
+				return Fail("unterminated string");
+			if (*m_Pos == '"')
+			{
+				m_Pos++;
+				return true;
+			}
+			if (*m_Pos != '\\')
+				return Fail("control character in string");
+
+			if (++m_Pos >= m_End)
+				return Fail("unterminated string");
+
+			char c = *m_Pos++;
+			switch (c)
+			{
+			case '"':  out += '"';  break;
+			case '\\': out += '\\'; break;
+			case '/':  out += '/';  break;
+			case 'b':  out += '\b'; break;
+			case 'f':  out += '\f'; break;
+			case 'n':  out += '\n'; break;
+			case 'r':  out += '\r'; break;
+			case 't':  out += '\t'; break;
+			case 'u':
+			{
+				uint32_t codepoint;
+				if (!ParseHex4(codepoint))
+					return false;
+
+				// Surrogate pair -> one code point
+				if (codepoint >= 0xD800 && codepoint <= 0xDBFF && Match("\\u"))
+				{
+					uint32_t low;
+					if (!ParseHex4(low))
+						return false;
+					if (low >= 0xDC00 && low <= 0xDFFF)
+						codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+				}
+				AppendUtf8(out, codepoint);
+				break;
+			}
+			default:
+				return Fail("invalid escape");
+			}
+		}
+	}
+
+	bool ParseNumber(JsonValue& out)
+	{
+		const char* start = m_Pos;
+		if (m_Pos < m_End && *m_Pos == '-')
+			m_Pos++;
+		while (m_Pos < m_End && ((*m_Pos >= '0' && *m_Pos <= '9') ||
+			*m_Pos == '.' || *m_Pos == 'e' || *m_Pos == 'E' || *m_Pos == '+' || *m_Pos == '-'))
+			m_Pos++;
+
+		// strtod needs a terminator; numbers are short
+		char buffer[64];
+		size_t length = (size_t)(m_Pos - start);
+		if (length == 0 || length >= sizeof(buffer))
+		{
+			m_Pos = start;
+			return Fail(length == 0 ? "unexpected character" : "number too long");
+		}
+		std::memcpy(buffer, start, length);
+		buffer[length] = '\0';
+
+		char* end = nullptr;
+		out.m_Number = std::strtod(buffer, &end);
+		if (end != buffer + length)
+		{
+			m_Pos = start;
+			return Fail("invalid number");
+		}
+		out.m_Type = JsonValue::Type::Number;
+		return true;
+	}
+
+private:
+	const char* m_Begin;
+	const char* m_Pos;
+	const char* m_End;
+
+	const char* m_Error = "";
+	const char* m_ErrorPos = nullptr;
+};
+
+bool JsonValue::Parse(const char* text, size_t length, JsonValue& out, std::string& error)
+{
+	out = JsonValue();
+	JsonParser parser(text, length);
+	return parser.ParseDocument(out, error);
+}
+
+// ------------------------------------------------------------
+// Access
+// ------------------------------------------------------------
+namespace
+{
+	const JsonValue& NullValue()
+	{
+		static const JsonValue null;
+		return null;
+	}
+}
+
+bool JsonValue::GetBool(bool fallback) const
+{
+	return m_Type == Type::Bool ? m_Bool : fallback;
+}
+
+double JsonValue::GetNumber(double fallback) const
+{
+	return m_Type == Type::Number ? m_Number : fallback;
+}
+
+int64_t JsonValue::GetInt(int64_t fallback) const
+{
+	return m_Type == Type::Number ? (int64_t)std::floor(m_Number) : fallback;
+}
+
+uint32_t JsonValue::GetUint(uint32_t fallback) const
+{
+	return m_Type == Type::Number && m_Number >= 0.0 && m_Number <= 4294967295.0 ? (uint32_t)m_Number : fallback;
+}
+
+size_t JsonValue::Size() const
+{
+	return m_Type == Type::Array ? m_Elements.size() : m_Type == Type::Object ? m_Members.size() : 0;
+}
+
+const JsonValue& JsonValue::At(size_t index) const
+{
+	return m_Type == Type::Array && index < m_Elements.size() ? m_Elements[index] : NullValue();
+}
+
+const JsonValue& JsonValue::operator[](const char* key) const
+{
+	if (m_Type == Type::Object)
+	{
+		for (const Member& member : m_Members)
+		{
+			if (member.first == key)
+				return member.second;
+		}
+	}
+	return NullValue();
+}
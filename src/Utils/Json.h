@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// JsonValue -- small read-only JSON DOM (RFC 8259), enough for glTF.
+// Lookups never fail: a missing key or index yields a null value, and the
+// typed getters return their fallback on a type mismatch, so callers can
+// chain doc["accessors"].At(i)["count"].GetUint() and validate once.
+// Objects keep their members in file order (linear lookup; glTF objects are
+// small).
+// -----------------------------------------------------------------------------
+class JsonValue
+{
+public:
+	enum class Type : uint8_t { Null, Bool, Number, String, Array, Object };
+
+	using Member = std::pair<std::string, JsonValue>;
+
+	Type GetType() const { return m_Type; }
+	bool IsNull() const { return m_Type == Type::Null; }
+	bool IsNumber() const { return m_Type == Type::Number; }
+	bool IsString() const { return m_Type == Type::String; }
+	bool IsArray() const { return m_Type == Type::Array; }
+	bool IsObject() const { return m_Type == Type::Object; }
+
+	bool        GetBool(bool fallback = false) const;
+	double      GetNumber(double fallback = 0.0) const;
+	float       GetFloat(float fallback = 0.0f) const { return (float)GetNumber(fallback); }
+	int64_t     GetInt(int64_t fallback = 0) const;
+	uint32_t    GetUint(uint32_t fallback = 0) const;
+	const std::string& GetString() const { return m_String; }   // empty unless a string
+
+	// Elements of an array / members of an object (0 otherwise)
+	size_t Size() const;
+
+	// Array element / object member (a named At() keeps literal 0 from
+	// being ambiguous with the key overload)
+	const JsonValue& At(size_t index) const;
+	const JsonValue& operator[](const char* key) const;
+	bool Has(const char* key) const { return !(*this)[key].IsNull(); }
+
+	const std::vector<JsonValue>& GetElements() const { return m_Elements; }
+	const std::vector<Member>& GetMembers() const { return m_Members; }
+
+	// 'text' need not be null-terminated. On failure 'error' describes
+	// the first problem and its byte offset.
+	static bool Parse(const char* text, size_t length, JsonValue& out, std::string& error);
+
+private:
+	friend class JsonParser;
+
+	Type        m_Type = Type::Null;
+	bool        m_Bool = false;
+	double      m_Number = 0.0;
+	std::string m_String;
+
+	std::vector<JsonValue> m_Elements;
+	std::vector<Member>    m_Members;
+};
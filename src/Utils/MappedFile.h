@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// -----------------------------------------------------------------------------
+// MappedFile -- read-only memory mapping of a whole file. Pages are read on
+// first touch, so consumers that hand the bytes straight to the GPU (see
+// MeshFile) never copy them into a heap buffer first. Move-only.
+// -----------------------------------------------------------------------------
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// False if the file is missing or cannot be mapped (empty files map
+	// successfully with a null GetData())
+	bool Open(const std::string& path);
+	void Close();
+
+	bool IsOpen() const { return m_Open; }
+	const void* GetData() const { return m_Data; }
+	size_t GetSize() const { return m_Size; }
+
+private:
+	const void* m_Data = nullptr;
+	size_t      m_Size = 0;
+	bool        m_Open = false;
+
+#ifdef _WIN32
+	void* m_File = nullptr;      // HANDLE
+	void* m_Mapping = nullptr;   // HANDLE
+#endif
+};
@@ -1,8 +1,45 @@
 #include "Core/Application.h"
+#include "Graphics/MeshFile.h"
+#include "Scene/GltfImporter.h"
+#include "Utils/FileSystem.h"
 
-int main()
+#include <cstdio>
+#include <cstring>
+
+namespace
 {
-	Application app;
+	// --convert <model.obj> [out.mesh]   one .mesh file (default: the cache entry)
+	// --convert <scene.gltf|scene.glb>   the cache entries of every primitive
+	// Runs without a window, so scenes can be converted ahead of time.
+	int Convert(int argc, char** argv)
+	{
+		if (argc < 3)
+		{
+			std::fprintf(stderr, "usage: %s --convert <model.obj|scene.gltf|scene.glb> [out.mesh]\n", argv[0]);
+			return 1;
+		}
+
+		const std::string source = argv[2];
+		const VertexFormat format = Application::SceneVertexFormat;
+
+		if (FileSystem::GetExtension(source) == "obj")
+		{
+			std::string output = argc > 3 ? argv[3] : MeshFile::GetCachePath(source, format);
+			if (argc <= 3 && !MeshFile::CreateCacheDirectory())
+				return 1;
+			return MeshFile::Convert(source, output, format) ? 0 : 1;
+		}
+		return GltfImporter::Convert(source, format) ? 0 : 1;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc > 1 && std::strcmp(argv[1], "--convert") == 0)
+		return Convert(argc, argv);
+
+	// Optional argument: a .gltf / .glb / .obj scene to load
+	Application app(argc > 1 ? argv[1] : "");
 	app.Run();
 	return 0;
 }